@@ -16,12 +16,12 @@ public class HttpGPTChatModule : ModuleRules
 			"Core",
 			"HTTP",
 			"Json",
+			"Engine",
 			"HttpGPTCommonModule"
 		});
 
 		PrivateDependencyModuleNames.AddRange(new[]
 		{
-			"Engine",
 			"CoreUObject"
 		});
 
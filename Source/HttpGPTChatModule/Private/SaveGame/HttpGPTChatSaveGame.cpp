@@ -0,0 +1,180 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "SaveGame/HttpGPTChatSaveGame.h"
+#include <Utils/HttpGPTChatSerializer.h>
+#include <LogHttpGPT.h>
+#include <Kismet/GameplayStatics.h>
+#include <HAL/IConsoleManager.h>
+
+#ifdef UE_INLINE_GENERATED_CPP_BY_NAME
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HttpGPTChatSaveGame)
+#endif
+
+void UHttpGPTChatSaveGame::SetConversation(const FName ID, const TArray<FHttpGPTChatMessage>& Messages)
+{
+	if (FHttpGPTChatConversation* const Conversation = FindConversation(ID))
+	{
+		Conversation->Messages = Messages;
+		return;
+	}
+
+	ConversationIndices.Add(ID, Conversations.Add(FHttpGPTChatConversation(ID, Messages)));
+}
+
+void UHttpGPTChatSaveGame::AddMessage(const FName ID, const FHttpGPTChatMessage& Message)
+{
+	if (FHttpGPTChatConversation* const Conversation = FindConversation(ID))
+	{
+		Conversation->Messages.Add(Message);
+		return;
+	}
+
+	SetConversation(ID, {Message});
+}
+
+bool UHttpGPTChatSaveGame::GetConversation(const FName ID, TArray<FHttpGPTChatMessage>& OutMessages) const
+{
+	if (const int32* const Index = ConversationIndices.Find(ID))
+	{
+		OutMessages = Conversations[*Index].Messages;
+		return true;
+	}
+
+	OutMessages.Empty();
+	return false;
+}
+
+bool UHttpGPTChatSaveGame::RemoveConversation(const FName ID)
+{
+	int32 Index = INDEX_NONE;
+	if (!ConversationIndices.RemoveAndCopyValue(ID, Index))
+	{
+		return false;
+	}
+
+	// The last conversation takes the place of the removed one
+	Conversations.RemoveAtSwap(Index);
+	if (Conversations.IsValidIndex(Index))
+	{
+		ConversationIndices.Add(Conversations[Index].ID, Index);
+	}
+
+	return true;
+}
+
+TArray<FName> UHttpGPTChatSaveGame::GetConversationIDs() const
+{
+	TArray<FName> Output;
+	ConversationIndices.GenerateKeyArray(Output);
+
+	return Output;
+}
+
+const TArray<FHttpGPTChatConversation>& UHttpGPTChatSaveGame::GetConversations() const
+{
+	return Conversations;
+}
+
+FHttpGPTChatConversation* UHttpGPTChatSaveGame::FindConversation(const FName& ID)
+{
+	const int32* const Index = ConversationIndices.Find(ID);
+	return Index ? &Conversations[*Index] : nullptr;
+}
+
+void UHttpGPTChatSaveGame::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	// The save game functions use a persistent memory archive without the save game flag. Other archives, like the garbage collector ones, don't need the conversations
+	if (!Ar.IsPersistent() || Ar.IsObjectReferenceCollector() || Ar.IsCountingMemory())
+	{
+		return;
+	}
+
+	TArray<uint8> Data;
+	if (Ar.IsSaving() && !FHttpGPTChatSerializer::Save(Conversations, Compression, Data))
+	{
+		Data.Empty();
+	}
+
+	Ar << Data;
+
+	if (Ar.IsLoading())
+	{
+		Conversations.Empty();
+		ConversationIndices.Empty();
+
+		if (Data.Num() > 0 && !FHttpGPTChatSerializer::Load(Data, Conversations))
+		{
+			UE_LOG(LogHttpGPT, Error, TEXT("%s (%d): Failed to load the saved conversations"), *FString(__FUNCTION__), GetUniqueID());
+		}
+
+		for (int32 Index = 0; Index < Conversations.Num(); ++Index)
+		{
+			ConversationIndices.Add(Conversations[Index].ID, Index);
+		}
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+static void RunSaveGameRoundTrip()
+{
+	UHttpGPTChatSaveGame* const SaveGame = Cast<UHttpGPTChatSaveGame>(UGameplayStatics::CreateSaveGameObject(UHttpGPTChatSaveGame::StaticClass()));
+
+	FHttpGPTChatMessage FunctionMessage(EHttpGPTChatRole::Assistant, FString());
+	FunctionMessage.FunctionCall.Name = TEXT("get_weather");
+	FunctionMessage.FunctionCall.Arguments = TEXT("{\"city\":\"Lisbon\"}");
+
+	const TArray<FHttpGPTChatMessage> Messages{
+		FHttpGPTChatMessage(EHttpGPTChatRole::System, TEXT("You are a helpful assistant.")),
+		FHttpGPTChatMessage(EHttpGPTChatRole::User, TEXT("What's the weather like?")),
+		FunctionMessage,
+		FHttpGPTChatMessage(EHttpGPTChatRole::Function, TEXT("{\"temperature\":21}"))
+	};
+
+	SaveGame->SetConversation(TEXT("First"), Messages);
+	SaveGame->AddMessage(TEXT("Second"), FHttpGPTChatMessage(EHttpGPTChatRole::User, TEXT("Se\u00F1al")));
+
+	// Strings that only differ in case are stored separately
+	SaveGame->AddMessage(TEXT("Second"), FHttpGPTChatMessage(EHttpGPTChatRole::User, TEXT("Hello")));
+	SaveGame->AddMessage(TEXT("Second"), FHttpGPTChatMessage(EHttpGPTChatRole::User, TEXT("hello")));
+
+	TArray<uint8> Data;
+	UHttpGPTChatSaveGame* const Loaded = UGameplayStatics::SaveGameToMemory(SaveGame, Data)
+		                                     ? Cast<UHttpGPTChatSaveGame>(UGameplayStatics::LoadGameFromMemory(Data))
+		                                     : nullptr;
+
+	bool bMatches = Loaded && Loaded->GetConversations().Num() == SaveGame->GetConversations().Num();
+	for (int32 Index = 0; bMatches && Index < SaveGame->GetConversations().Num(); ++Index)
+	{
+		const FHttpGPTChatConversation& Expected = SaveGame->GetConversations()[Index];
+
+		TArray<FHttpGPTChatMessage> LoadedMessages;
+		bMatches = Loaded->GetConversation(Expected.ID, LoadedMessages) && LoadedMessages.Num() == Expected.Messages.Num();
+
+		for (int32 Message = 0; bMatches && Message < LoadedMessages.Num(); ++Message)
+		{
+			const FHttpGPTChatMessage& Lhs = LoadedMessages[Message];
+			const FHttpGPTChatMessage& Rhs = Expected.Messages[Message];
+
+			bMatches = Lhs.Role == Rhs.Role && Lhs.Content.Equals(Rhs.Content, ESearchCase::CaseSensitive) && Lhs.FunctionCall.Name.ToString().Equals(
+				Rhs.FunctionCall.Name.ToString(), ESearchCase::CaseSensitive) && Lhs.FunctionCall.Arguments.Equals(Rhs.FunctionCall.Arguments, ESearchCase::CaseSensitive);
+		}
+	}
+
+	if (bMatches)
+	{
+		UE_LOG(LogHttpGPT, Display, TEXT("%s: Save game round trip succeeded (%d bytes)"), *FString(__FUNCTION__), Data.Num());
+	}
+	else
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Save game round trip failed: the loaded conversations don't match the saved ones"), *FString(__FUNCTION__));
+	}
+}
+
+static FAutoConsoleCommand SaveGameRoundTripCommand(TEXT("HttpGPT.SaveGame.RoundTrip"),
+                                                    TEXT("Save chat conversations to memory with the save game functions and check that they load back unchanged"),
+                                                    FConsoleCommandDelegate::CreateStatic(&RunSaveGameRoundTrip));
+#endif
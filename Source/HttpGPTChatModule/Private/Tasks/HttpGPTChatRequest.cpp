@@ -4,6 +4,7 @@
 
 #include "Tasks/HttpGPTChatRequest.h"
 #include <Utils/HttpGPTHelper.h>
+#include <Utils/HttpGPTTokenizer.h>
 #include <Management/HttpGPTSettings.h>
 #include <HttpGPTInternalFuncs.h>
 #include <LogHttpGPT.h>
@@ -85,6 +86,14 @@ bool UHttpGPTChatRequest::CanActivateTask() const
 		return false;
 	}
 
+	if (!UHttpGPTHelper::ModelSupportsVision(GetChatOptions().Model) && Messages.ContainsByPredicate([](const FHttpGPTChatMessage& Message)
+	{
+		return Message.Images.Num() > 0;
+	}))
+	{
+		UE_LOG(LogHttpGPT, Warning, TEXT("%s (%d): The selected model may not support image inputs."), *FString(__FUNCTION__), GetUniqueID());
+	}
+
 	return true;
 }
 
@@ -93,6 +102,22 @@ bool UHttpGPTChatRequest::CanBindProgress() const
 	return GetChatOptions().bStream;
 }
 
+bool UHttpGPTChatRequest::CanDeduplicateRequest() const
+{
+	if (!Super::CanDeduplicateRequest())
+	{
+		return false;
+	}
+
+	// Requests with non-zero temperature are expected to produce different answers
+	return FMath::IsNearlyZero(GetChatOptions().Temperature) || GetCommonOptions().bAllowNonDeterministicDeduplication;
+}
+
+bool UHttpGPTChatRequest::CanCacheResponse() const
+{
+	return Super::CanCacheResponse() && FMath::IsNearlyZero(GetChatOptions().Temperature);
+}
+
 FString UHttpGPTChatRequest::GetEndpointURL() const
 {
 	return FString::Format(TEXT("{0}/{1}"), {
@@ -118,6 +143,8 @@ FString UHttpGPTChatRequest::SetRequestContent()
 
 	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s (%d): Mounting content"), *FString(__FUNCTION__), GetUniqueID());
 
+	FitContextWindow();
+
 	const TSharedPtr<FJsonObject> JsonRequest = MakeShared<FJsonObject>();
 	JsonRequest->SetStringField("model", UHttpGPTHelper::ModelToName(GetChatOptions().Model).ToString().ToLower());
 	JsonRequest->SetNumberField("max_tokens", GetChatOptions().MaxTokens);
@@ -195,6 +222,132 @@ FString UHttpGPTChatRequest::SetRequestContent()
 	return RequestContentString;
 }
 
+void UHttpGPTChatRequest::FitContextWindow()
+{
+	FScopeLock Lock(&Mutex);
+
+	const EHttpGPTChatModel Model = GetChatOptions().Model;
+	const FHttpGPTTokenizerPtr Tokenizer = FHttpGPTTokenizer::Get(Model);
+	if (!Tokenizer.IsValid() || Messages.Num() <= 0)
+	{
+		if (GetChatOptions().ContextPolicy != EHttpGPTChatContextPolicy::None)
+		{
+			UE_LOG(LogHttpGPT_Internal, Warning, TEXT("%s (%d): Vocabulary of the model is not available. Skipping context window check."),
+			       *FString(__FUNCTION__), GetUniqueID());
+		}
+
+		return;
+	}
+
+	// Only the last message is sent as the prompt to the models without chat support
+	const bool bSupportsChat = UHttpGPTHelper::ModelSupportsChat(Model);
+	const int32 FirstSentIndex = bSupportsChat ? 0 : Messages.Num() - 1;
+
+	const auto CountSent = [&Tokenizer, bSupportsChat](const FHttpGPTChatMessage& Message)
+	{
+		return bSupportsChat ? Tokenizer->CountMessage(Message) : Tokenizer->Count(Message.Content);
+	};
+
+	TArray<int32> MessageTokens;
+	MessageTokens.SetNumZeroed(Messages.Num());
+
+	PromptTokens = bSupportsChat ? FHttpGPTTokenizer::ReplyTokens : 0;
+	for (int32 Index = FirstSentIndex; Index < Messages.Num(); ++Index)
+	{
+		MessageTokens[Index] = CountSent(Messages[Index]);
+		PromptTokens += MessageTokens[Index];
+	}
+
+	// The completion shares the context window with the request
+	const int32 Budget = UHttpGPTHelper::GetContextWindowForModel(Model) - GetChatOptions().MaxTokens;
+	if (PromptTokens <= Budget || GetChatOptions().ContextPolicy == EHttpGPTChatContextPolicy::None)
+	{
+		return;
+	}
+
+	if (Budget <= 0)
+	{
+		UE_LOG(LogHttpGPT, Warning, TEXT("%s (%d): Max tokens (%d) fill the context window of the model (%d). Sending the request as it is."),
+		       *FString(__FUNCTION__), GetUniqueID(), GetChatOptions().MaxTokens, UHttpGPTHelper::GetContextWindowForModel(Model));
+		return;
+	}
+
+	// System and function messages carry the instructions and results the conversation depends on
+	const auto IsPinned = [this](const int32 Index)
+	{
+		const FHttpGPTChatMessage& Message = Messages[Index];
+		if (Message.Role == EHttpGPTChatRole::System || Message.Role == EHttpGPTChatRole::Function)
+		{
+			return true;
+		}
+
+		// The function call is kept with the result it produced, which does not make sense to the model without it
+		return !Message.FunctionCall.Name.IsNone() && Messages.IsValidIndex(Index + 1) && Messages[Index + 1].Role == EHttpGPTChatRole::Function;
+	};
+
+	const int32 InitialTokens = PromptTokens;
+	const int32 InitialMessages = Messages.Num();
+
+	switch (GetChatOptions().ContextPolicy)
+	{
+	case EHttpGPTChatContextPolicy::DropOldestMessages:
+		// The last message is the one being answered
+		for (int32 Index = FirstSentIndex; Index < Messages.Num() - 1 && PromptTokens > Budget;)
+		{
+			if (IsPinned(Index))
+			{
+				++Index;
+				continue;
+			}
+
+			PromptTokens -= MessageTokens[Index];
+			Messages.RemoveAt(Index);
+			MessageTokens.RemoveAt(Index);
+		}
+		break;
+
+	case EHttpGPTChatContextPolicy::TruncateLongestMessages:
+		while (PromptTokens > Budget)
+		{
+			int32 LongestIndex = INDEX_NONE;
+			for (int32 Index = FirstSentIndex; Index < Messages.Num(); ++Index)
+			{
+				if (!IsPinned(Index) && !Messages[Index].Content.IsEmpty() && (LongestIndex == INDEX_NONE || MessageTokens[Index] >
+					MessageTokens[LongestIndex]))
+				{
+					LongestIndex = Index;
+				}
+			}
+
+			if (LongestIndex == INDEX_NONE)
+			{
+				break;
+			}
+
+			// Each pass shortens the content, so the loop ends when every message that can be truncated is empty
+			FHttpGPTChatMessage& Message = Messages[LongestIndex];
+			const int32 ContentTokens = Tokenizer->Count(Message.Content);
+			Message.Content = Tokenizer->Truncate(Message.Content, FMath::Max(ContentTokens - (PromptTokens - Budget), 0));
+
+			const int32 NewTokens = CountSent(Message);
+			PromptTokens += NewTokens - MessageTokens[LongestIndex];
+			MessageTokens[LongestIndex] = NewTokens;
+		}
+		break;
+
+	default: break;
+	}
+
+	UE_LOG(LogHttpGPT, Display, TEXT("%s (%d): Fitted the request to the context window of the model: %d tokens and %d messages removed."),
+	       *FString(__FUNCTION__), GetUniqueID(), InitialTokens - PromptTokens, InitialMessages - Messages.Num());
+
+	if (PromptTokens > Budget)
+	{
+		UE_LOG(LogHttpGPT, Warning, TEXT("%s (%d): Request still exceeds the context window of the model by %d tokens. Sending it anyway."),
+		       *FString(__FUNCTION__), GetUniqueID(), PromptTokens - Budget);
+	}
+}
+
 void UHttpGPTChatRequest::OnProgressUpdated(const FString& Content, int32 BytesSent, int32 BytesReceived)
 {
 	FScopeLock Lock(&Mutex);
@@ -260,6 +413,7 @@ void UHttpGPTChatRequest::OnProgressCompleted(const FString& Content, const bool
 	if (!GetChatOptions().bStream)
 	{
 		DeserializeSingleResponse(Content);
+		UpdateUsage();
 	}
 	else
 	{
@@ -315,10 +469,14 @@ void UHttpGPTChatRequest::DeserializeStreamedResponse(const TArray<FString>& Del
 	FScopeLock Lock(&Mutex);
 
 	Response.Choices.Empty(Deltas.Num());
+	Response.Usage = FHttpGPTChatUsage();
+
 	for (const FString& Delta : Deltas)
 	{
 		DeserializeSingleResponse(Delta);
 	}
+
+	UpdateUsage();
 }
 
 void UHttpGPTChatRequest::DeserializeSingleResponse(const FString& Content)
@@ -436,6 +594,53 @@ void UHttpGPTChatRequest::DeserializeSingleResponse(const FString& Content)
 	}
 }
 
+void UHttpGPTChatRequest::UpdateUsage()
+{
+	FScopeLock Lock(&Mutex);
+
+	if (Response.Usage.TotalTokens > 0)
+	{
+		return;
+	}
+
+	const FHttpGPTTokenizerPtr Tokenizer = FHttpGPTTokenizer::Get(GetChatOptions().Model);
+	if (!Tokenizer.IsValid())
+	{
+		return;
+	}
+
+	// The streamed choices are rebuilt from every delta received so far: counting them whole on each update would be quadratic
+	for (const FHttpGPTChatChoice& Choice : Response.Choices)
+	{
+		FHttpGPTChatCountedChoice& Counted = CountedChoices.FindOrAdd(Choice.Index);
+
+		if (Choice.Message.Content.Len() > Counted.ContentLength)
+		{
+			CompletionTokens += Tokenizer->Count(Choice.Message.Content.Mid(Counted.ContentLength));
+			Counted.ContentLength = Choice.Message.Content.Len();
+		}
+
+		if (Choice.Message.FunctionCall.Name.IsNone())
+		{
+			continue;
+		}
+
+		if (!Counted.bCountedFunctionName)
+		{
+			CompletionTokens += Tokenizer->Count(Choice.Message.FunctionCall.Name.ToString());
+			Counted.bCountedFunctionName = true;
+		}
+
+		if (Choice.Message.FunctionCall.Arguments.Len() > Counted.ArgumentsLength)
+		{
+			CompletionTokens += Tokenizer->Count(Choice.Message.FunctionCall.Arguments.Mid(Counted.ArgumentsLength));
+			Counted.ArgumentsLength = Choice.Message.FunctionCall.Arguments.Len();
+		}
+	}
+
+	Response.Usage = FHttpGPTChatUsage(PromptTokens, CompletionTokens, PromptTokens + CompletionTokens);
+}
+
 UHttpGPTChatRequest* UHttpGPTChatHelper::CastToHttpGPTChatRequest(UObject* const Object)
 {
 	return Cast<UHttpGPTChatRequest>(Object);
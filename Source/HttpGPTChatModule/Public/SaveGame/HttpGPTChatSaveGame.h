@@ -0,0 +1,48 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <GameFramework/SaveGame.h>
+#include <Structures/HttpGPTChatTypes.h>
+#include "HttpGPTChatSaveGame.generated.h"
+
+/**
+ * Conversations saved with the save game functions, in the compact binary form of FHttpGPTChatSerializer instead of tagged properties
+ */
+UCLASS(BlueprintType, Category = "HttpGPT | Chat")
+class HTTPGPTCHATMODULE_API UHttpGPTChatSaveGame : public USaveGame
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat")
+	EHttpGPTChatCompression Compression = EHttpGPTChatCompression::Oodle;
+
+	UFUNCTION(BlueprintCallable, Category = "HttpGPT | Chat | Save Game")
+	void SetConversation(const FName ID, const TArray<FHttpGPTChatMessage>& Messages);
+
+	UFUNCTION(BlueprintCallable, Category = "HttpGPT | Chat | Save Game")
+	void AddMessage(const FName ID, const FHttpGPTChatMessage& Message);
+
+	UFUNCTION(BlueprintPure, Category = "HttpGPT | Chat | Save Game")
+	bool GetConversation(const FName ID, TArray<FHttpGPTChatMessage>& OutMessages) const;
+
+	UFUNCTION(BlueprintCallable, Category = "HttpGPT | Chat | Save Game")
+	bool RemoveConversation(const FName ID);
+
+	UFUNCTION(BlueprintPure, Category = "HttpGPT | Chat | Save Game")
+	TArray<FName> GetConversationIDs() const;
+
+	const TArray<FHttpGPTChatConversation>& GetConversations() const;
+
+	virtual void Serialize(FArchive& Ar) override;
+
+private:
+	FHttpGPTChatConversation* FindConversation(const FName& ID);
+
+	TArray<FHttpGPTChatConversation> Conversations;
+	TMap<FName, int32> ConversationIndices;
+};
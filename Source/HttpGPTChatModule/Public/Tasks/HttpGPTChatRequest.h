@@ -13,6 +13,14 @@
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHttpGPTChatResponseDelegate, const FHttpGPTChatResponse&, Response);
 
+/* Text of a choice already counted in the completion tokens */
+struct FHttpGPTChatCountedChoice
+{
+	int32 ContentLength = 0;
+	int32 ArgumentsLength = 0;
+	bool bCountedFunctionName = false;
+};
+
 /**
  *
  */
@@ -74,6 +82,8 @@ protected:
 
 	virtual bool CanActivateTask() const override;
 	virtual bool CanBindProgress() const override;
+	virtual bool CanDeduplicateRequest() const override;
+	virtual bool CanCacheResponse() const override;
 	virtual FString GetEndpointURL() const override;
 
 	virtual FString SetRequestContent() override;
@@ -85,8 +95,21 @@ protected:
 	void DeserializeStreamedResponse(const TArray<FString>& Deltas);
 	void DeserializeSingleResponse(const FString& Content);
 
+	/* Count the tokens locally when the response has no usage, like the streamed ones. Only the text received since the last call is counted */
+	void UpdateUsage();
+
+	/* Apply the context policy of the options when the messages and the max tokens exceed the context window of the model */
+	void FitContextWindow();
+
 private:
 	FHttpGPTChatResponse Response;
+
+	/* Tokens of the request counted when it was sent, if the vocabulary of the model is available */
+	int32 PromptTokens = 0;
+
+	/* Tokens of the response counted so far, streamed text only grows so it is counted once */
+	int32 CompletionTokens = 0;
+	TMap<int32, FHttpGPTChatCountedChoice> CountedChoices;
 };
 
 UCLASS(NotPlaceable, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Chat Helper"))
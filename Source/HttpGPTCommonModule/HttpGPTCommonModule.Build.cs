@@ -25,6 +25,13 @@ public class HttpGPTCommonModule : ModuleRules
 			"DeveloperSettings"
 		});
 
-		if (Target.bBuildEditor) PrivateDependencyModuleNames.Add("UnrealEd");
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.AddRange(new[]
+			{
+				"UnrealEd",
+				"DerivedDataCache"
+			});
+		}
 	}
 }
\ No newline at end of file
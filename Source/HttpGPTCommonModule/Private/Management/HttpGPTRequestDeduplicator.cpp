@@ -0,0 +1,80 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Management/HttpGPTRequestDeduplicator.h"
+#include "Tasks/HttpGPTBaseTask.h"
+#include "LogHttpGPT.h"
+
+FHttpGPTRequestDeduplicator& FHttpGPTRequestDeduplicator::Get()
+{
+	static FHttpGPTRequestDeduplicator Instance;
+	return Instance;
+}
+
+bool FHttpGPTRequestDeduplicator::Subscribe(const FString& Key, UHttpGPTBaseTask* const Task)
+{
+	FScopeLock Lock(&Mutex);
+
+	if (FInFlightRequest* const Existing = InFlightRequests.Find(Key); Existing && Existing->Owner.IsValid() && Existing->Owner.Get() != Task)
+	{
+		Existing->Subscribers.AddUnique(Task);
+
+		UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Request %s has %d subscriber(s)"), *FString(__FUNCTION__), *Key, Existing->Subscribers.Num());
+		return true;
+	}
+
+	// A stale owner will never release its subscribers: the new owner sends the request and completes them instead
+	FInFlightRequest& Request = InFlightRequests.FindOrAdd(Key);
+	Request.Owner = Task;
+	Request.Subscribers.RemoveAll([Task](const TWeakObjectPtr<UHttpGPTBaseTask>& Item)
+	{
+		return !Item.IsValid() || Item.Get() == Task;
+	});
+
+	if (Request.Subscribers.Num() > 0)
+	{
+		UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Request %s taken over with %d subscriber(s)"), *FString(__FUNCTION__), *Key, Request.Subscribers.Num());
+	}
+
+	return false;
+}
+
+void FHttpGPTRequestDeduplicator::Unsubscribe(const FString& Key, const UHttpGPTBaseTask* const Task)
+{
+	FScopeLock Lock(&Mutex);
+
+	if (FInFlightRequest* const Existing = InFlightRequests.Find(Key))
+	{
+		Existing->Subscribers.RemoveAll([Task](const TWeakObjectPtr<UHttpGPTBaseTask>& Item)
+		{
+			return !Item.IsValid() || Item.Get() == Task;
+		});
+	}
+}
+
+TArray<TWeakObjectPtr<UHttpGPTBaseTask>> FHttpGPTRequestDeduplicator::GetSubscribers(const FString& Key) const
+{
+	FScopeLock Lock(&Mutex);
+
+	if (const FInFlightRequest* const Existing = InFlightRequests.Find(Key))
+	{
+		return Existing->Subscribers;
+	}
+
+	return TArray<TWeakObjectPtr<UHttpGPTBaseTask>>();
+}
+
+TArray<TWeakObjectPtr<UHttpGPTBaseTask>> FHttpGPTRequestDeduplicator::Release(const FString& Key, const UHttpGPTBaseTask* const Owner)
+{
+	FScopeLock Lock(&Mutex);
+
+	TArray<TWeakObjectPtr<UHttpGPTBaseTask>> Output;
+	if (const FInFlightRequest* const Existing = InFlightRequests.Find(Key); Existing && Existing->Owner.Get() == Owner)
+	{
+		Output = Existing->Subscribers;
+		InFlightRequests.Remove(Key);
+	}
+
+	return Output;
+}
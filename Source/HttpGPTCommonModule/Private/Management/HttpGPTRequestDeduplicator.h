@@ -0,0 +1,38 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <UObject/WeakObjectPtrTemplates.h>
+
+class UHttpGPTBaseTask;
+
+/**
+ *
+ */
+class FHttpGPTRequestDeduplicator
+{
+public:
+	static FHttpGPTRequestDeduplicator& Get();
+
+	/* Return true if the task was attached to an identical in-flight request, false if the task was registered as the owner of a new one */
+	bool Subscribe(const FString& Key, UHttpGPTBaseTask* const Task);
+	void Unsubscribe(const FString& Key, const UHttpGPTBaseTask* const Task);
+
+	TArray<TWeakObjectPtr<UHttpGPTBaseTask>> GetSubscribers(const FString& Key) const;
+
+	/* Remove the in-flight request owned by the task and return its subscribers */
+	TArray<TWeakObjectPtr<UHttpGPTBaseTask>> Release(const FString& Key, const UHttpGPTBaseTask* const Owner);
+
+private:
+	struct FInFlightRequest
+	{
+		TWeakObjectPtr<UHttpGPTBaseTask> Owner;
+		TArray<TWeakObjectPtr<UHttpGPTBaseTask>> Subscribers;
+	};
+
+	TMap<FString, FInFlightRequest> InFlightRequests;
+	mutable FCriticalSection Mutex;
+};
@@ -0,0 +1,197 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Management/HttpGPTResponseCache.h"
+#include "Management/HttpGPTSettings.h"
+#include "LogHttpGPT.h"
+
+#if WITH_EDITOR
+#include <DerivedDataCacheInterface.h>
+#include <Serialization/MemoryReader.h>
+#include <Serialization/MemoryWriter.h>
+
+// Change this version to invalidate all responses stored in the Derived Data Cache
+#define HTTPGPT_DERIVEDDATA_VER TEXT("4F0C7B9E2D1A4E8B9C3F6A5D7E2B1C08")
+#endif
+
+FHttpGPTResponseCache& FHttpGPTResponseCache::Get()
+{
+	static FHttpGPTResponseCache Instance;
+	return Instance;
+}
+
+FHttpGPTResponseCache::~FHttpGPTResponseCache()
+{
+	Empty();
+}
+
+bool FHttpGPTResponseCache::Find(const FString& Key, const FString& SharedKey, FHttpGPTCachedResponse& OutResponse)
+{
+	if (FindInMemory(Key, OutResponse))
+	{
+		return true;
+	}
+
+#if WITH_EDITOR
+	if (UHttpGPTSettings::Get()->bUseDerivedDataCache && FindInDerivedDataCache(SharedKey, OutResponse))
+	{
+		AddToMemory(Key, OutResponse);
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+bool FHttpGPTResponseCache::FindInMemory(const FString& Key, FHttpGPTCachedResponse& OutResponse)
+{
+	FScopeLock Lock(&Mutex);
+
+	FEntry* const Entry = Entries.Find(Key);
+	if (!Entry)
+	{
+		return false;
+	}
+
+	if (Entry->ExpirationTime < FPlatformTime::Seconds() || IsExpired(Entry->Response))
+	{
+		UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Cached response %s expired"), *FString(__FUNCTION__), *Key);
+		RemoveEntry(Key);
+		return false;
+	}
+
+	UsageList.RemoveNode(Entry->Node);
+	UsageList.AddHead(Key);
+	Entry->Node = UsageList.GetHead();
+
+	OutResponse = Entry->Response;
+	return true;
+}
+
+void FHttpGPTResponseCache::Add(const FString& Key, const FString& SharedKey, const FHttpGPTCachedResponse& Response)
+{
+	AddToMemory(Key, Response);
+
+#if WITH_EDITOR
+	if (UHttpGPTSettings::Get()->bUseDerivedDataCache)
+	{
+		AddToDerivedDataCache(SharedKey, Response);
+	}
+#endif
+}
+
+void FHttpGPTResponseCache::AddToMemory(const FString& Key, const FHttpGPTCachedResponse& Response)
+{
+	const UHttpGPTSettings* const Settings = UHttpGPTSettings::Get();
+	const SIZE_T MaxSize = static_cast<SIZE_T>(FMath::Max(Settings->ResponseCacheSize, 0)) * 1024u * 1024u;
+
+	FEntry NewEntry;
+	NewEntry.Response = Response;
+	// Responses loaded from the Derived Data Cache only have what is left of their time to live
+	NewEntry.ExpirationTime = FPlatformTime::Seconds() + Settings->ResponseCacheTTL - (FDateTime::UtcNow() - Response.CachedTime).GetTotalSeconds();
+	NewEntry.Size = Key.GetAllocatedSize() + Response.GetAllocatedSize();
+
+	if (NewEntry.Size > MaxSize)
+	{
+		return;
+	}
+
+	FScopeLock Lock(&Mutex);
+
+	RemoveEntry(Key);
+	EvictUntil(MaxSize - NewEntry.Size);
+
+	UsageList.AddHead(Key);
+	NewEntry.Node = UsageList.GetHead();
+
+	CurrentSize += NewEntry.Size;
+	Entries.Add(Key, MoveTemp(NewEntry));
+
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Cached response %s. Cache size: %llu bytes"), *FString(__FUNCTION__), *Key,
+	       static_cast<uint64>(CurrentSize));
+}
+
+void FHttpGPTResponseCache::Empty()
+{
+	FScopeLock Lock(&Mutex);
+
+	Entries.Empty();
+	UsageList.Empty();
+	CurrentSize = 0u;
+}
+
+SIZE_T FHttpGPTResponseCache::GetCurrentSize() const
+{
+	FScopeLock Lock(&Mutex);
+	return CurrentSize;
+}
+
+void FHttpGPTResponseCache::RemoveEntry(const FString& Key)
+{
+	if (const FEntry* const Entry = Entries.Find(Key))
+	{
+		CurrentSize -= Entry->Size;
+		UsageList.RemoveNode(Entry->Node);
+		Entries.Remove(Key);
+	}
+}
+
+void FHttpGPTResponseCache::EvictUntil(const SIZE_T MaxSize)
+{
+	while (CurrentSize > MaxSize && UsageList.GetTail())
+	{
+		const FString LeastRecentKey = UsageList.GetTail()->GetValue();
+
+		UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Evicting cached response %s"), *FString(__FUNCTION__), *LeastRecentKey);
+		RemoveEntry(LeastRecentKey);
+	}
+}
+
+bool FHttpGPTResponseCache::IsExpired(const FHttpGPTCachedResponse& Response)
+{
+	return (FDateTime::UtcNow() - Response.CachedTime).GetTotalSeconds() > UHttpGPTSettings::Get()->ResponseCacheTTL;
+}
+
+#if WITH_EDITOR
+FString FHttpGPTResponseCache::GetDerivedDataKey(const FString& Key)
+{
+	return FDerivedDataCacheInterface::BuildCacheKey(TEXT("HTTPGPT"), HTTPGPT_DERIVEDDATA_VER, *Key);
+}
+
+bool FHttpGPTResponseCache::FindInDerivedDataCache(const FString& Key, FHttpGPTCachedResponse& OutResponse)
+{
+	TArray<uint8> Data;
+	if (!GetDerivedDataCacheRef().GetSynchronous(*GetDerivedDataKey(Key), Data, TEXT("HttpGPT Response")))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data, true);
+	Reader << OutResponse;
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogHttpGPT, Warning, TEXT("%s: Failed to read response %s from the Derived Data Cache"), *FString(__FUNCTION__), *Key);
+		return false;
+	}
+
+	if (IsExpired(OutResponse))
+	{
+		UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Response %s in the Derived Data Cache expired"), *FString(__FUNCTION__), *Key);
+		return false;
+	}
+
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Found response %s in the Derived Data Cache"), *FString(__FUNCTION__), *Key);
+	return true;
+}
+
+void FHttpGPTResponseCache::AddToDerivedDataCache(const FString& Key, const FHttpGPTCachedResponse& Response)
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data, true);
+	Writer << const_cast<FHttpGPTCachedResponse&>(Response);
+
+	GetDerivedDataCacheRef().Put(*GetDerivedDataKey(Key), Data, TEXT("HttpGPT Response"));
+}
+#endif
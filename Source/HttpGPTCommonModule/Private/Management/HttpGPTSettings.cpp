@@ -11,8 +11,14 @@
 #endif
 
 UHttpGPTSettings::UHttpGPTSettings(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer), bUseCustomSystemContext(false),
-                                                                                  CustomSystemContext(FString()),
-                                                                                  GeneratedImagesDir("HttpGPT_Generated"), bEnableInternalLogs(false)
+                                                                                  CustomSystemContext(FString()), ChatHistoryPageSize(50),
+                                                                                  ChatOpenSessions(4), ChatConcurrentRequests(4),
+                                                                                  GeneratedImagesDir("HttpGPT_Generated"), ImageGenTextureBudget(256),
+                                                                                  ImageGenThumbnailSize(256), ResponseCacheSize(64),
+                                                                                  ResponseCacheTTL(3600.f), bUseDerivedDataCache(false),
+                                                                                  ImageFetchConcurrency(4), ImageDecodeConcurrency(2),
+                                                                                  ImageUploadsPerFrame(1), TokenizersDir("HttpGPT/Tokenizers"),
+                                                                                  bEnableInternalLogs(false)
 {
 	CategoryName = TEXT("Plugins");
 
@@ -89,6 +95,10 @@ void UHttpGPTSettings::SetToDefaults()
 	CommonOptions.bIsAzureOpenAI = false;
 	CommonOptions.Endpoint = TEXT("https://api.openai.com/");
 	CommonOptions.AzureOpenAIAPIVersion = TEXT("2023-05-15");
+	CommonOptions.bDeduplicateRequest = false;
+	CommonOptions.bAllowNonDeterministicDeduplication = false;
+	CommonOptions.bCacheResponse = false;
+	CommonOptions.bReplayCachedStreamTiming = false;
 
 	ChatOptions.Model = EHttpGPTChatModel::gpt35turbo;
 	ChatOptions.MaxTokens = 2048;
@@ -100,6 +110,7 @@ void UHttpGPTSettings::SetToDefaults()
 	ChatOptions.PresencePenalty = 0.f;
 	ChatOptions.FrequencyPenalty = 0.f;
 	ChatOptions.LogitBias = TMap<int32, float>();
+	ChatOptions.ContextPolicy = EHttpGPTChatContextPolicy::DropOldestMessages;
 
 	ImageOptions.ImagesNum = 1;
 	ImageOptions.Size = EHttpGPTImageSize::x256;
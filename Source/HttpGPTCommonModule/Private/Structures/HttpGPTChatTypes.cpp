@@ -67,6 +67,33 @@ TSharedPtr<FJsonValue> FHttpGPTChatMessage::GetMessage() const
 		JsonObject->SetStringField("name", FunctionCall.Name.ToString());
 		JsonObject->SetStringField("content", FunctionCall.Arguments);
 	}
+	else if (Images.Num() > 0)
+	{
+		// Messages with images use an array of content parts
+		TArray<TSharedPtr<FJsonValue>> ContentParts;
+
+		if (!Content.IsEmpty())
+		{
+			const TSharedPtr<FJsonObject> TextPart = MakeShared<FJsonObject>();
+			TextPart->SetStringField("type", "text");
+			TextPart->SetStringField("text", Content);
+			ContentParts.Add(MakeShared<FJsonValueObject>(TextPart));
+		}
+
+		for (const FHttpGPTChatImage& Image : Images)
+		{
+			const TSharedPtr<FJsonObject> ImageURL = MakeShared<FJsonObject>();
+			ImageURL->SetStringField("url", Image.URL);
+			ImageURL->SetStringField("detail", UHttpGPTHelper::ImageDetailToName(Image.Detail).ToString());
+
+			const TSharedPtr<FJsonObject> ImagePart = MakeShared<FJsonObject>();
+			ImagePart->SetStringField("type", "image_url");
+			ImagePart->SetObjectField("image_url", ImageURL);
+			ContentParts.Add(MakeShared<FJsonValueObject>(ImagePart));
+		}
+
+		JsonObject->SetArrayField("content", ContentParts);
+	}
 	else
 	{
 		JsonObject->SetStringField("content", Content);
@@ -94,5 +121,6 @@ void FHttpGPTChatOptions::SetDefaults()
 		PresencePenalty = Settings->ChatOptions.PresencePenalty;
 		FrequencyPenalty = Settings->ChatOptions.FrequencyPenalty;
 		LogitBias = Settings->ChatOptions.LogitBias;
+		ContextPolicy = Settings->ChatOptions.ContextPolicy;
 	}
 }
@@ -23,5 +23,9 @@ void FHttpGPTCommonOptions::SetDefaults()
 		bIsAzureOpenAI = Settings->CommonOptions.bIsAzureOpenAI;
 		Endpoint = Settings->CommonOptions.Endpoint;
 		AzureOpenAIAPIVersion = Settings->CommonOptions.AzureOpenAIAPIVersion;
+		bDeduplicateRequest = Settings->CommonOptions.bDeduplicateRequest;
+		bAllowNonDeterministicDeduplication = Settings->CommonOptions.bAllowNonDeterministicDeduplication;
+		bCacheResponse = Settings->CommonOptions.bCacheResponse;
+		bReplayCachedStreamTiming = Settings->CommonOptions.bReplayCachedStreamTiming;
 	}
 }
@@ -4,6 +4,7 @@
 
 #include "Structures/HttpGPTImageTypes.h"
 #include "Management/HttpGPTSettings.h"
+#include <Misc/Base64.h>
 
 FHttpGPTImageOptions::FHttpGPTImageOptions()
 {
@@ -19,3 +20,26 @@ void FHttpGPTImageOptions::SetDefaults()
 		Format = Settings->ImageOptions.Format;
 	}
 }
+
+FString FHttpGPTImageData::GetContent() const
+{
+	if (!Content.IsEmpty())
+	{
+		return Content;
+	}
+
+	if (EncodedContent.IsValid())
+	{
+		// The payload was copied as it is in the JSON response, where slashes may be escaped
+		FString Output(EncodedContent->Num(), EncodedContent->GetData());
+		Output.ReplaceInline(TEXT("\\/"), TEXT("/"), ESearchCase::CaseSensitive);
+		return Output;
+	}
+
+	if (DecodedContent.IsValid())
+	{
+		return FBase64::Encode(*DecodedContent);
+	}
+
+	return Content;
+}
@@ -4,6 +4,7 @@
 
 #include "Tasks/HttpGPTBaseTask.h"
 #include "Management/HttpGPTSettings.h"
+#include "Management/HttpGPTRequestDeduplicator.h"
 #include "HttpGPTInternalFuncs.h"
 #include "LogHttpGPT.h"
 
@@ -15,6 +16,7 @@
 #include <Serialization/JsonReader.h>
 #include <Serialization/JsonSerializer.h>
 #include <Misc/ScopeTryLock.h>
+#include <Misc/SecureHash.h>
 #include <Async/Async.h>
 
 #if WITH_EDITOR
@@ -64,23 +66,36 @@ void UHttpGPTBaseTask::Activate()
 
 void UHttpGPTBaseTask::StopHttpGPTTask()
 {
-	FScopeLock Lock(&Mutex);
-
-	if (!bIsTaskActive)
+	TArray<TWeakObjectPtr<UHttpGPTBaseTask>> Subscribers;
 	{
-		return;
-	}
+		FScopeLock Lock(&Mutex);
 
-	UE_LOG(LogHttpGPT, Display, TEXT("%s (%d): Stopping task"), *FString(__FUNCTION__), GetUniqueID());
+		if (!bIsTaskActive)
+		{
+			return;
+		}
 
-	bIsTaskActive = false;
+		UE_LOG(LogHttpGPT, Display, TEXT("%s (%d): Stopping task"), *FString(__FUNCTION__), GetUniqueID());
 
-	if (HttpRequest.IsValid())
-	{
-		HttpRequest->CancelRequest();
-		HttpRequest.Reset();
+		bIsTaskActive = false;
+
+		if (bIsSubscriber)
+		{
+			FHttpGPTRequestDeduplicator::Get().Unsubscribe(RequestKey, this);
+		}
+		else
+		{
+			Subscribers = TakeSubscribers();
+		}
+
+		if (HttpRequest.IsValid())
+		{
+			HttpRequest->CancelRequest();
+			HttpRequest.Reset();
+		}
 	}
 
+	ReleaseSubscribers(Subscribers, nullptr, false, false);
 	SetReadyToDestroy();
 }
 
@@ -155,6 +170,16 @@ bool UHttpGPTBaseTask::CanBindProgress() const
 	return true;
 }
 
+bool UHttpGPTBaseTask::CanDeduplicateRequest() const
+{
+	return GetCommonOptions().bDeduplicateRequest;
+}
+
+bool UHttpGPTBaseTask::CanCacheResponse() const
+{
+	return GetCommonOptions().bCacheResponse;
+}
+
 FString UHttpGPTBaseTask::GetEndpointURL() const
 {
 	return FString();
@@ -201,31 +226,114 @@ void UHttpGPTBaseTask::BindRequestCallbacks()
 
 			if (const FHttpResponsePtr Response = Request->GetResponse(); Response.IsValid())
 			{
-				OnProgressUpdated(Response->GetContentAsString(), BytesSent, BytesReceived);
+				const FString Content = Response->GetContentAsString();
+				OnProgressUpdated(Content, BytesSent, BytesReceived);
+
+				if (CanCacheResponse())
+				{
+					RecordedProgress.Add(FHttpGPTCachedProgress(FPlatformTime::Seconds() - RequestStartTime, Content.Len()));
+				}
+
+				if (!HttpGPT::Internal::HasEmptyParam(RequestKey))
+				{
+					for (const TWeakObjectPtr<UHttpGPTBaseTask>& Subscriber : FHttpGPTRequestDeduplicator::Get().GetSubscribers(RequestKey))
+					{
+						if (Subscriber.IsValid())
+						{
+							Subscriber->ForwardProgressUpdated(Content, BytesSent, BytesReceived);
+						}
+					}
+				}
 			}
 		});
 	}
 
 	HttpRequest->OnProcessRequestComplete().BindLambda([this](FHttpRequestPtr Request, const FHttpResponsePtr& RequestResponse, bool bWasSuccessful)
 	{
-		const FScopeTryLock Lock(&Mutex);
-
-		if (!Lock.IsLocked() || !IsValid(this) || !bIsTaskActive)
+		TArray<TWeakObjectPtr<UHttpGPTBaseTask>> Subscribers;
 		{
-			return;
+			const FScopeTryLock Lock(&Mutex);
+
+			if (!Lock.IsLocked() || !IsValid(this) || !bIsTaskActive)
+			{
+				return;
+			}
+
+			OnResponseCompleted(RequestResponse.IsValid() ? RequestResponse->GetContent() : TArray<uint8>(), bWasSuccessful);
+			Subscribers = TakeSubscribers();
+
+			// Only converted to text here when cached: the tasks may read the bytes of the response directly
+			if (bWasSuccessful && CanCacheResponse() && RequestResponse.IsValid() && EHttpResponseCodes::IsOk(RequestResponse->GetResponseCode()))
+			{
+				FHttpGPTCachedResponse CachedResponse;
+				CachedResponse.Content = RequestResponse->GetContentAsString();
+				CachedResponse.Progress = MoveTemp(RecordedProgress);
+
+				FHttpGPTResponseCache::Get().Add(RequestKey, SharedRequestKey, CachedResponse);
+			}
 		}
 
-		OnProgressCompleted(RequestResponse->GetContentAsString(), bWasSuccessful);
+		ReleaseSubscribers(Subscribers, RequestResponse, bWasSuccessful, true);
 		SetReadyToDestroy();
 	});
 }
 
 void UHttpGPTBaseTask::SendRequest()
 {
+	FString ContentString;
+	{
+		FScopeLock Lock(&Mutex);
+
+		InitializeRequest();
+		ContentString = SetRequestContent();
+
+		if (HttpRequest.IsValid() && (CanCacheResponse() || CanDeduplicateRequest()))
+		{
+			RequestKey = GetRequestKey(ContentString, true);
+			SharedRequestKey = GetRequestKey(ContentString, false);
+		}
+	}
+
+	// The Derived Data Cache may wait for a remote layer: the task is not locked meanwhile
+	FHttpGPTCachedResponse CachedResponse;
+	const bool bHasCachedResponse = CanCacheResponse() && !HttpGPT::Internal::HasEmptyParam(RequestKey) && FHttpGPTResponseCache::Get().Find(
+		RequestKey, SharedRequestKey, CachedResponse);
+
 	FScopeLock Lock(&Mutex);
 
-	InitializeRequest();
-	const FString ContentString = SetRequestContent();
+	if (!bIsTaskActive)
+	{
+		return;
+	}
+
+	if (HttpRequest.IsValid() && bHasCachedResponse)
+	{
+		UE_LOG(LogHttpGPT, Display, TEXT("%s (%d): Using cached response"), *FString(__FUNCTION__), GetUniqueID());
+
+		HttpRequest.Reset();
+		ReplayCachedResponse(CachedResponse);
+
+		return;
+	}
+
+	if (HttpRequest.IsValid() && CanDeduplicateRequest())
+	{
+		if (FHttpGPTRequestDeduplicator::Get().Subscribe(RequestKey, this))
+		{
+			UE_LOG(LogHttpGPT, Display, TEXT("%s (%d): Attached to an identical in-flight request"), *FString(__FUNCTION__), GetUniqueID());
+
+			bIsSubscriber = true;
+			HttpRequest.Reset();
+
+			AsyncTask(ENamedThreads::GameThread, [this]
+			{
+				RequestSent.Broadcast();
+			});
+
+			return;
+		}
+	}
+
 	BindRequestCallbacks();
 
 	if (!HttpRequest.IsValid())
@@ -243,6 +351,9 @@ void UHttpGPTBaseTask::SendRequest()
 
 	UE_LOG(LogHttpGPT, Display, TEXT("%s (%d): Sending request"), *FString(__FUNCTION__), GetUniqueID());
 
+	RequestStartTime = FPlatformTime::Seconds();
+	RecordedProgress.Empty();
+
 	if (HttpRequest->ProcessRequest())
 	{
 		UE_LOG(LogHttpGPT, Display, TEXT("%s (%d): Request sent"), *FString(__FUNCTION__), GetUniqueID());
@@ -256,6 +367,8 @@ void UHttpGPTBaseTask::SendRequest()
 	else
 	{
 		UE_LOG(LogHttpGPT, Error, TEXT("%s (%d): Failed to initialize the request process"), *FString(__FUNCTION__), GetUniqueID());
+		ReleaseSubscribers(TakeSubscribers(), nullptr, false, true);
+
 		AsyncTask(ENamedThreads::GameThread, [this]
 		{
 			RequestFailed.Broadcast();
@@ -264,6 +377,170 @@ void UHttpGPTBaseTask::SendRequest()
 	}
 }
 
+FString UHttpGPTBaseTask::GetRequestKey(const FString& Content, const bool bIncludeCredentials) const
+{
+	FString KeySource = FString::Format(TEXT("{0}\n{1}"), {GetEndpointURL(), Content});
+	if (bIncludeCredentials)
+	{
+		KeySource += FString::Format(TEXT("\n{0}"), {GetCommonOptions().APIKey.ToString()});
+	}
+
+	const FTCHARToUTF8 KeySourceUTF8(*KeySource);
+
+	FSHAHash Hash;
+	FSHA1::HashBuffer(KeySourceUTF8.Get(), KeySourceUTF8.Length(), Hash.Hash);
+
+	return Hash.ToString();
+}
+
+void UHttpGPTBaseTask::ReplayCachedResponse(const FHttpGPTCachedResponse& CachedResponse)
+{
+	AsyncTask(ENamedThreads::GameThread, [this]
+	{
+		RequestSent.Broadcast();
+	});
+
+	Async(EAsyncExecution::ThreadPool, [this, CachedResponse]
+	{
+		if (CanBindProgress())
+		{
+			if (GetCommonOptions().bReplayCachedStreamTiming && !HttpGPT::Internal::HasEmptyParam(CachedResponse.Progress))
+			{
+				double ElapsedTime = 0.0;
+				for (const FHttpGPTCachedProgress& Progress : CachedResponse.Progress)
+				{
+					FPlatformProcess::Sleep(static_cast<float>(FMath::Max(Progress.TimeOffset - ElapsedTime, 0.0)));
+					ElapsedTime = Progress.TimeOffset;
+
+					FScopeLock Lock(&Mutex);
+					if (!IsValid(this) || !bIsTaskActive)
+					{
+						return;
+					}
+
+					OnProgressUpdated(CachedResponse.Content.Left(Progress.ContentLength), 0, Progress.ContentLength);
+				}
+			}
+			else
+			{
+				FScopeLock Lock(&Mutex);
+				if (!IsValid(this) || !bIsTaskActive)
+				{
+					return;
+				}
+
+				OnProgressUpdated(CachedResponse.Content, 0, CachedResponse.Content.Len());
+			}
+		}
+
+		{
+			FScopeLock Lock(&Mutex);
+			if (!IsValid(this) || !bIsTaskActive)
+			{
+				return;
+			}
+
+			OnProgressCompleted(CachedResponse.Content, true);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [this]
+		{
+			SetReadyToDestroy();
+		});
+	});
+}
+
+void UHttpGPTBaseTask::ForwardProgressUpdated(const FString& Content, int32 BytesSent, int32 BytesReceived)
+{
+	const FScopeTryLock Lock(&Mutex);
+
+	if (!Lock.IsLocked() || !IsValid(this) || !bIsTaskActive)
+	{
+		return;
+	}
+
+	OnProgressUpdated(Content, BytesSent, BytesReceived);
+}
+
+void UHttpGPTBaseTask::ForwardProgressCompleted(const FString& Content, const bool bWasSuccessful)
+{
+	FScopeLock Lock(&Mutex);
+
+	if (!IsValid(this) || !bIsTaskActive)
+	{
+		return;
+	}
+
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s (%d): Received result of deduplicated request"), *FString(__FUNCTION__), GetUniqueID());
+
+	OnProgressCompleted(Content, bWasSuccessful);
+	SetReadyToDestroy();
+}
+
+void UHttpGPTBaseTask::OnResponseCompleted(const TArray<uint8>& Content, const bool bWasSuccessful)
+{
+	const FUTF8ToTCHAR ContentText(reinterpret_cast<const ANSICHAR*>(Content.GetData()), Content.Num());
+	OnProgressCompleted(FString(ContentText.Length(), ContentText.Get()), bWasSuccessful);
+}
+
+TArray<TWeakObjectPtr<UHttpGPTBaseTask>> UHttpGPTBaseTask::TakeSubscribers()
+{
+	FScopeLock Lock(&Mutex);
+
+	if (bIsSubscriber || HttpGPT::Internal::HasEmptyParam(RequestKey))
+	{
+		return TArray<TWeakObjectPtr<UHttpGPTBaseTask>>();
+	}
+
+	return FHttpGPTRequestDeduplicator::Get().Release(RequestKey, this);
+}
+
+void UHttpGPTBaseTask::ReleaseSubscribers(const TArray<TWeakObjectPtr<UHttpGPTBaseTask>>& Subscribers, const FHttpResponsePtr& Response,
+                                          const bool bWasSuccessful, const bool bForwardResult)
+{
+	if (Subscribers.Num() <= 0)
+	{
+		return;
+	}
+
+	// Converted to text once for all the subscribers
+	const FString Content = bForwardResult && Response.IsValid() ? Response->GetContentAsString() : FString();
+
+	for (const TWeakObjectPtr<UHttpGPTBaseTask>& Subscriber : Subscribers)
+	{
+		// Weak pointers are only safe to check in the game thread, where garbage collection runs
+		AsyncTask(ENamedThreads::GameThread, [Subscriber, Content, bWasSuccessful, bForwardResult]
+		{
+			if (!Subscriber.IsValid())
+			{
+				return;
+			}
+
+			if (bForwardResult)
+			{
+				Subscriber->ForwardProgressCompleted(Content, bWasSuccessful);
+				return;
+			}
+
+			// The owner was stopped before completing: the subscribers send the request again and the first one becomes the new owner
+			{
+				FScopeLock Lock(&Subscriber->Mutex);
+
+				if (!Subscriber->bIsTaskActive)
+				{
+					return;
+				}
+
+				Subscriber->bIsSubscriber = false;
+				Subscriber->RequestKey.Empty();
+				Subscriber->SharedRequestKey.Empty();
+			}
+
+			Subscriber->SendRequest();
+		});
+	}
+}
+
 const bool UHttpGPTBaseTask::CheckError(const TSharedPtr<FJsonObject>& JsonObject, FHttpGPTCommonError& OutputError) const
 {
 	if (JsonObject->HasField(TEXT("error")))
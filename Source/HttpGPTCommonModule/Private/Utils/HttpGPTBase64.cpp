@@ -0,0 +1,522 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Utils/HttpGPTBase64.h"
+#include "LogHttpGPT.h"
+
+#include <HAL/IConsoleManager.h>
+#include <Misc/Base64.h>
+#include <type_traits>
+
+#if PLATFORM_CPU_X86_FAMILY
+#define HTTPGPT_BASE64_X86 1
+#include <immintrin.h>
+#if PLATFORM_WINDOWS
+#include <intrin.h>
+#endif
+#else
+#define HTTPGPT_BASE64_X86 0
+#endif
+
+#if PLATFORM_CPU_ARM_FAMILY && (defined(__aarch64__) || defined(_M_ARM64))
+#define HTTPGPT_BASE64_NEON 1
+#include <arm_neon.h>
+#else
+#define HTTPGPT_BASE64_NEON 0
+#endif
+
+// Allow the vector kernels to be compiled without enabling AVX2/SSSE3 for the whole module: they are only called after a runtime check
+#if HTTPGPT_BASE64_X86 && (defined(__clang__) || defined(__GNUC__))
+#define HTTPGPT_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define HTTPGPT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HTTPGPT_TARGET_SSSE3
+#define HTTPGPT_TARGET_AVX2
+#endif
+
+namespace HttpGPT::Base64
+{
+	constexpr uint8 Invalid = 0xFF;
+	constexpr uint8 Ignored = 0xFE;
+	constexpr uint8 Padding = 0xFD;
+
+	/* The vector kernels store a full register per iteration */
+	constexpr int64 OutputSlack = 32;
+
+	struct FDecodeTable
+	{
+		constexpr FDecodeTable() : Values()
+		{
+			for (int32 Index = 0; Index < 256; ++Index)
+			{
+				Values[Index] = Invalid;
+			}
+
+			for (int32 Index = 0; Index < 26; ++Index)
+			{
+				Values['A' + Index] = static_cast<uint8>(Index);
+				Values['a' + Index] = static_cast<uint8>(26 + Index);
+			}
+
+			for (int32 Index = 0; Index < 10; ++Index)
+			{
+				Values['0' + Index] = static_cast<uint8>(52 + Index);
+			}
+
+			Values['+'] = 62;
+			Values['/'] = 63;
+			Values['='] = Padding;
+
+			// JSON writers may escape the slash as "\/" and wrap long payloads
+			Values['\\'] = Ignored;
+			Values[' '] = Ignored;
+			Values['\t'] = Ignored;
+			Values['\r'] = Ignored;
+			Values['\n'] = Ignored;
+		}
+
+		uint8 Values[256];
+	};
+
+	alignas(16) static constexpr FDecodeTable DecodeTable;
+
+	template <typename CharType>
+	static uint32 ToCodeUnit(const CharType Char)
+	{
+		return static_cast<uint32>(static_cast<std::make_unsigned_t<CharType>>(Char));
+	}
+
+	/* Decode a single quad, skipping ignored characters. Stops at the end of the input or at the padding */
+	template <typename CharType>
+	static bool DecodeScalar(const CharType* const Source, const int64 Length, int64& Index, uint8*& Out, bool& bOutFinished)
+	{
+		uint32 Accumulator = 0u;
+		int32 Count = 0;
+
+		while (Index < Length)
+		{
+			const uint32 CodeUnit = ToCodeUnit(Source[Index++]);
+			const uint8 Value = CodeUnit < 256u ? DecodeTable.Values[CodeUnit] : Invalid;
+
+			if (Value < 64u)
+			{
+				Accumulator = (Accumulator << 6) | Value;
+				if (++Count == 4)
+				{
+					Out[0] = static_cast<uint8>(Accumulator >> 16);
+					Out[1] = static_cast<uint8>(Accumulator >> 8);
+					Out[2] = static_cast<uint8>(Accumulator);
+					Out += 3;
+
+					return true;
+				}
+			}
+			else if (Value == Padding)
+			{
+				break;
+			}
+			else if (Value != Ignored)
+			{
+				return false;
+			}
+		}
+
+		bOutFinished = true;
+
+		switch (Count)
+		{
+		case 0:
+			return true;
+
+		case 2:
+			Out[0] = static_cast<uint8>(Accumulator >> 4);
+			Out += 1;
+			return true;
+
+		case 3:
+			Out[0] = static_cast<uint8>(Accumulator >> 10);
+			Out[1] = static_cast<uint8>(Accumulator >> 2);
+			Out += 2;
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+#if HTTPGPT_BASE64_X86
+	struct FCPUFeatures
+	{
+		bool bSSSE3 = false;
+		bool bAVX2 = false;
+	};
+
+	static FCPUFeatures DetectCPUFeatures()
+	{
+		FCPUFeatures Output;
+
+#if PLATFORM_WINDOWS
+		int32 Info[4];
+		__cpuid(Info, 0);
+		const int32 MaxLeaf = Info[0];
+
+		__cpuid(Info, 1);
+		Output.bSSSE3 = (Info[2] & (1 << 9)) != 0;
+
+		const bool bOSXSAVE = (Info[2] & (1 << 27)) != 0;
+		const bool bAVX = (Info[2] & (1 << 28)) != 0;
+
+		// The OS must also save the YMM registers
+		if (MaxLeaf >= 7 && bOSXSAVE && bAVX && (_xgetbv(0) & 0x6) == 0x6)
+		{
+			__cpuidex(Info, 7, 0);
+			Output.bAVX2 = (Info[1] & (1 << 5)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		Output.bSSSE3 = __builtin_cpu_supports("ssse3") != 0;
+		Output.bAVX2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+
+		return Output;
+	}
+
+	static const FCPUFeatures& GetCPUFeatures()
+	{
+		static const FCPUFeatures Features = DetectCPUFeatures();
+		return Features;
+	}
+
+	/* Vectorized lookup by Wojciech Mula: validate with nibble tables, translate with a per-range offset and pack 4 sextets into 3 bytes */
+	template <typename CharType>
+	HTTPGPT_TARGET_SSSE3 static int64 DecodeSSSE3(const CharType* const Source, const int64 Length, uint8*& Out)
+	{
+		const __m128i LutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+		const __m128i LutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+		const __m128i LutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+		const __m128i Mask2F = _mm_set1_epi8(0x2F);
+		const __m128i MergeWeights = _mm_set1_epi32(0x01400140);
+		const __m128i PackWeights = _mm_set1_epi32(0x00011000);
+		const __m128i PackShuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+		int64 Index = 0;
+		for (; Index + 16 <= Length; Index += 16)
+		{
+			__m128i Input;
+			if constexpr (sizeof(CharType) == 1)
+			{
+				Input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + Index));
+			}
+			else
+			{
+				// Code units above 0xFF saturate to invalid characters
+				Input = _mm_packus_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + Index)),
+				                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + Index + 8)));
+			}
+
+			const __m128i HiNibbles = _mm_and_si128(_mm_srli_epi32(Input, 4), Mask2F);
+			const __m128i LoNibbles = _mm_and_si128(Input, Mask2F);
+			const __m128i Hi = _mm_shuffle_epi8(LutHi, HiNibbles);
+			const __m128i Lo = _mm_shuffle_epi8(LutLo, LoNibbles);
+
+			// Padding, escapes and whitespaces are left to the scalar decoder
+			if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(Lo, Hi), _mm_setzero_si128())) != 0)
+			{
+				break;
+			}
+
+			const __m128i Roll = _mm_shuffle_epi8(LutRoll, _mm_add_epi8(_mm_cmpeq_epi8(Input, Mask2F), HiNibbles));
+			const __m128i Sextets = _mm_add_epi8(Input, Roll);
+
+			const __m128i Merged = _mm_madd_epi16(_mm_maddubs_epi16(Sextets, MergeWeights), PackWeights);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Out), _mm_shuffle_epi8(Merged, PackShuffle));
+			Out += 12;
+		}
+
+		return Index;
+	}
+
+	template <typename CharType>
+	HTTPGPT_TARGET_AVX2 static int64 DecodeAVX2(const CharType* const Source, const int64 Length, uint8*& Out)
+	{
+		const __m256i LutLo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+		                                       0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+		const __m256i LutHi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		                                       0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+		const __m256i LutRoll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+		                                         0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+		const __m256i Mask2F = _mm256_set1_epi8(0x2F);
+		const __m256i MergeWeights = _mm256_set1_epi32(0x01400140);
+		const __m256i PackWeights = _mm256_set1_epi32(0x00011000);
+		const __m256i PackShuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+		                                             2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+		const __m256i PackPermute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+
+		int64 Index = 0;
+		for (; Index + 32 <= Length; Index += 32)
+		{
+			__m256i Input;
+			if constexpr (sizeof(CharType) == 1)
+			{
+				Input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source + Index));
+			}
+			else
+			{
+				// Packing works per 128 bits lane: restore the original order after saturating the code units
+				Input = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source + Index)),
+				                                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source + Index + 16))),
+				                                 0xD8);
+			}
+
+			const __m256i HiNibbles = _mm256_and_si256(_mm256_srli_epi32(Input, 4), Mask2F);
+			const __m256i LoNibbles = _mm256_and_si256(Input, Mask2F);
+			const __m256i Hi = _mm256_shuffle_epi8(LutHi, HiNibbles);
+			const __m256i Lo = _mm256_shuffle_epi8(LutLo, LoNibbles);
+
+			if (_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_and_si256(Lo, Hi), _mm256_setzero_si256())) != 0)
+			{
+				break;
+			}
+
+			const __m256i Roll = _mm256_shuffle_epi8(LutRoll, _mm256_add_epi8(_mm256_cmpeq_epi8(Input, Mask2F), HiNibbles));
+			const __m256i Sextets = _mm256_add_epi8(Input, Roll);
+
+			const __m256i Merged = _mm256_madd_epi16(_mm256_maddubs_epi16(Sextets, MergeWeights), PackWeights);
+			const __m256i Packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(Merged, PackShuffle), PackPermute);
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(Out), Packed);
+			Out += 24;
+		}
+
+		return Index;
+	}
+#endif
+
+#if HTTPGPT_BASE64_NEON
+	static uint8x16_t TranslateNEON(const uint8x16x4_t& LutLo, const uint8x16x4_t& LutHi, const uint8x16_t Input)
+	{
+		// Out of range indices return zero: characters above 127 are flagged separately since zero is a valid sextet
+		const uint8x16_t Lo = vqtbl4q_u8(LutLo, Input);
+		const uint8x16_t Hi = vqtbl4q_u8(LutHi, vsubq_u8(Input, vdupq_n_u8(64)));
+
+		return vorrq_u8(vorrq_u8(Lo, Hi), vcgeq_u8(Input, vdupq_n_u8(128)));
+	}
+
+	template <typename CharType>
+	static int64 DecodeNEON(const CharType* const Source, const int64 Length, uint8*& Out)
+	{
+		uint8x16x4_t LutLo;
+		uint8x16x4_t LutHi;
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			LutLo.val[Index] = vld1q_u8(DecodeTable.Values + Index * 16);
+			LutHi.val[Index] = vld1q_u8(DecodeTable.Values + 64 + Index * 16);
+		}
+
+		int64 Index = 0;
+		for (; Index + 64 <= Length; Index += 64)
+		{
+			uint8x16x4_t Input;
+			if constexpr (sizeof(CharType) == 1)
+			{
+				Input = vld4q_u8(reinterpret_cast<const uint8*>(Source + Index));
+			}
+			else
+			{
+				const uint16x8x4_t First = vld4q_u16(reinterpret_cast<const uint16*>(Source + Index));
+				const uint16x8x4_t Second = vld4q_u16(reinterpret_cast<const uint16*>(Source + Index + 32));
+
+				for (int32 Lane = 0; Lane < 4; ++Lane)
+				{
+					Input.val[Lane] = vcombine_u8(vqmovn_u16(First.val[Lane]), vqmovn_u16(Second.val[Lane]));
+				}
+			}
+
+			const uint8x16_t A = TranslateNEON(LutLo, LutHi, Input.val[0]);
+			const uint8x16_t B = TranslateNEON(LutLo, LutHi, Input.val[1]);
+			const uint8x16_t C = TranslateNEON(LutLo, LutHi, Input.val[2]);
+			const uint8x16_t D = TranslateNEON(LutLo, LutHi, Input.val[3]);
+
+			if (vmaxvq_u8(vorrq_u8(vorrq_u8(A, B), vorrq_u8(C, D))) > 63u)
+			{
+				break;
+			}
+
+			uint8x16x3_t Output;
+			Output.val[0] = vorrq_u8(vshlq_n_u8(A, 2), vshrq_n_u8(B, 4));
+			Output.val[1] = vorrq_u8(vshlq_n_u8(B, 4), vshrq_n_u8(C, 2));
+			Output.val[2] = vorrq_u8(vshlq_n_u8(C, 6), D);
+
+			vst3q_u8(Out, Output);
+			Out += 48;
+		}
+
+		return Index;
+	}
+#endif
+
+	/* Decode as many characters as possible with vector instructions. Returns the number of characters consumed */
+	template <typename CharType>
+	static int64 DecodeVector(const CharType* const Source, const int64 Length, uint8*& Out)
+	{
+		if constexpr (sizeof(CharType) > 2)
+		{
+			return 0;
+		}
+		else
+		{
+#if HTTPGPT_BASE64_X86
+			if (GetCPUFeatures().bAVX2)
+			{
+				return DecodeAVX2(Source, Length, Out);
+			}
+
+			if (GetCPUFeatures().bSSSE3)
+			{
+				return DecodeSSSE3(Source, Length, Out);
+			}
+#elif HTTPGPT_BASE64_NEON
+			return DecodeNEON(Source, Length, Out);
+#endif
+
+			return 0;
+		}
+	}
+
+	template <typename CharType>
+	static bool Decode(const CharType* const Source, const int64 Length, TArray<uint8>& OutData)
+	{
+		OutData.Reset();
+
+		if (!Source || Length <= 0)
+		{
+			return false;
+		}
+
+		const int64 MaxSize = FHttpGPTBase64::GetMaxDecodedSize(Length) + OutputSlack;
+		if (MaxSize > MAX_int32)
+		{
+			UE_LOG(LogHttpGPT, Error, TEXT("%s: Content is too large to be decoded"), *FString(__FUNCTION__));
+			return false;
+		}
+
+		OutData.SetNumUninitialized(static_cast<int32>(MaxSize));
+		uint8* Out = OutData.GetData();
+
+		int64 Index = 0;
+		bool bFinished = false;
+
+		while (!bFinished && Index < Length)
+		{
+			Index += DecodeVector(Source + Index, Length - Index, Out);
+
+			// Consume the next quad with the scalar decoder: either the input tail or a block the vector kernels could not handle
+			if (!DecodeScalar(Source, Length, Index, Out, bFinished))
+			{
+				UE_LOG(LogHttpGPT, Error, TEXT("%s: Invalid base64 content at index %lld"), *FString(__FUNCTION__), Index - 1);
+				OutData.Reset();
+				return false;
+			}
+		}
+
+		OutData.SetNum(static_cast<int32>(Out - OutData.GetData()));
+		return true;
+	}
+}
+
+bool FHttpGPTBase64::Decode(const ANSICHAR* const Source, const int64 Length, TArray<uint8>& OutData)
+{
+	return HttpGPT::Base64::Decode(Source, Length, OutData);
+}
+
+bool FHttpGPTBase64::Decode(const TCHAR* const Source, const int64 Length, TArray<uint8>& OutData)
+{
+	return HttpGPT::Base64::Decode(Source, Length, OutData);
+}
+
+int64 FHttpGPTBase64::GetMaxDecodedSize(const int64 EncodedLength)
+{
+	return (EncodedLength + 3) / 4 * 3;
+}
+
+const TCHAR* FHttpGPTBase64::GetImplementationName()
+{
+#if HTTPGPT_BASE64_X86
+	if (HttpGPT::Base64::GetCPUFeatures().bAVX2)
+	{
+		return TEXT("AVX2");
+	}
+
+	if (HttpGPT::Base64::GetCPUFeatures().bSSSE3)
+	{
+		return TEXT("SSSE3");
+	}
+#elif HTTPGPT_BASE64_NEON
+	return TEXT("NEON");
+#endif
+
+	return TEXT("Scalar");
+}
+
+#if !UE_BUILD_SHIPPING
+static void RunBase64Benchmark(const TArray<FString>& Args)
+{
+	const int32 SizeInMB = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 4;
+	const int32 Iterations = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 10;
+
+	TArray<uint8> SourceData;
+	SourceData.SetNumUninitialized(SizeInMB * 1024 * 1024);
+
+	FRandomStream Random(SizeInMB);
+	for (uint8& Byte : SourceData)
+	{
+		Byte = static_cast<uint8>(Random.RandRange(0, 255));
+	}
+
+	const FString Encoded = FBase64::Encode(SourceData);
+	const FTCHARToUTF8 EncodedUTF8(*Encoded);
+
+	const auto Measure = [Iterations, &SourceData](const TCHAR* const Name, const TFunction<bool(TArray<uint8>&)>& Function)
+	{
+		TArray<uint8> Output;
+		bool bValid = true;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			bValid &= Function(Output);
+		}
+		const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+		bValid &= Output == SourceData;
+
+		const double Throughput = static_cast<double>(SourceData.Num()) * Iterations / (1024.0 * 1024.0) / FMath::Max(ElapsedTime, 1.e-6);
+
+		UE_LOG(LogHttpGPT, Display, TEXT("%s: %s: %.2f ms per decode, %.1f MB/s%s"), *FString(__FUNCTION__), Name, ElapsedTime * 1000.0 / Iterations,
+		       Throughput, bValid ? TEXT("") : TEXT(" (INVALID OUTPUT)"));
+	};
+
+	UE_LOG(LogHttpGPT, Display, TEXT("%s: Decoding %d MB %d times. Implementation: %s"), *FString(__FUNCTION__), SizeInMB, Iterations,
+	       FHttpGPTBase64::GetImplementationName());
+
+	Measure(TEXT("FBase64"), [&Encoded](TArray<uint8>& Output)
+	{
+		return FBase64::Decode(Encoded, Output);
+	});
+
+	Measure(TEXT("FHttpGPTBase64 (TCHAR)"), [&Encoded](TArray<uint8>& Output)
+	{
+		return FHttpGPTBase64::Decode(*Encoded, Encoded.Len(), Output);
+	});
+
+	Measure(TEXT("FHttpGPTBase64 (UTF-8)"), [&EncodedUTF8](TArray<uint8>& Output)
+	{
+		return FHttpGPTBase64::Decode(reinterpret_cast<const ANSICHAR*>(EncodedUTF8.Get()), EncodedUTF8.Length(), Output);
+	});
+}
+
+static FAutoConsoleCommand Base64BenchmarkCommand(TEXT("HttpGPT.Base64.Benchmark"),
+                                                  TEXT("Compare the HttpGPT base64 decoder against FBase64. Usage: HttpGPT.Base64.Benchmark [SizeInMB] [Iterations]"),
+                                                  FConsoleCommandWithArgsDelegate::CreateStatic(&RunBase64Benchmark));
+#endif
@@ -0,0 +1,377 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Utils/HttpGPTChatSerializer.h"
+#include "LogHttpGPT.h"
+#include <Misc/Compression.h>
+#include <Serialization/MemoryReader.h>
+#include <Serialization/MemoryWriter.h>
+
+// "HGPT", to reject buffers that were not written by this serializer
+static constexpr uint32 ChatSerializerMagic = 0x54504748;
+
+// Change this version when the binary layout changes
+static constexpr int32 ChatSerializerVersion = 1;
+
+// Loaded counts can't exceed the remaining bytes: every element takes at least one
+static bool SerializeCount(FArchive& Ar, int32& Count)
+{
+	uint32 PackedCount = static_cast<uint32>(Count);
+	Ar.SerializeIntPacked(PackedCount);
+
+	if (Ar.IsLoading())
+	{
+		if (PackedCount > static_cast<uint32>(FMath::Min<int64>(Ar.TotalSize() - Ar.Tell(), MAX_int32)))
+		{
+			Ar.SetError();
+			PackedCount = 0u;
+		}
+
+		Count = static_cast<int32>(PackedCount);
+	}
+
+	return !Ar.IsError();
+}
+
+// Loaded strings can't exceed the remaining bytes: FString serialization allocates the saved length before reading the characters
+static void LoadString(FArchive& Ar, FString& String)
+{
+	const int64 LengthOffset = Ar.Tell();
+
+	int32 SavedLength = 0;
+	Ar << SavedLength;
+
+	// Negative lengths are UTF-16 strings, with two bytes per character
+	const int64 Size = SavedLength < 0 ? -static_cast<int64>(SavedLength) * 2 : SavedLength;
+	if (Ar.IsError() || Size > Ar.TotalSize() - Ar.Tell())
+	{
+		Ar.SetError();
+		String.Empty();
+		return;
+	}
+
+	Ar.Seek(LengthOffset);
+	Ar << String;
+}
+
+// Above the worst case ratio of the supported formats: larger sizes in the header are corrupted data, not compressed chats
+static constexpr int64 MaxCompressionRatio = 1032;
+
+// Loaded values must be one of the enumerators, the last one being MaxValue
+template <typename EnumType>
+static void SerializeEnum(FArchive& Ar, EnumType& Value, const EnumType MaxValue)
+{
+	uint8 RawValue = static_cast<uint8>(Value);
+	Ar << RawValue;
+
+	if (Ar.IsLoading())
+	{
+		if (RawValue > static_cast<uint8>(MaxValue))
+		{
+			Ar.SetError();
+			RawValue = 0u;
+		}
+
+		Value = static_cast<EnumType>(RawValue);
+	}
+}
+
+void FHttpGPTChatSerializer::Serialize(FArchive& Ar, TArray<FHttpGPTChatMessage>& Messages)
+{
+	SerializeWithStrings(Ar, [&Messages](FArchive& ReferencesAr, FStringTable& Table)
+	{
+		SerializeMessages(ReferencesAr, Messages, Table);
+	});
+}
+
+void FHttpGPTChatSerializer::Serialize(FArchive& Ar, TArray<FHttpGPTChatConversation>& Conversations)
+{
+	SerializeWithStrings(Ar, [&Conversations](FArchive& ReferencesAr, FStringTable& Table)
+	{
+		int32 NumConversations = Conversations.Num();
+		if (!SerializeCount(ReferencesAr, NumConversations))
+		{
+			return;
+		}
+
+		if (ReferencesAr.IsLoading())
+		{
+			Conversations.SetNum(NumConversations);
+		}
+
+		for (FHttpGPTChatConversation& Conversation : Conversations)
+		{
+			SerializeName(ReferencesAr, Conversation.ID, Table);
+			SerializeMessages(ReferencesAr, Conversation.Messages, Table);
+
+			if (ReferencesAr.IsError())
+			{
+				return;
+			}
+		}
+	});
+}
+
+void FHttpGPTChatSerializer::SerializeWithStrings(FArchive& Ar, const TFunctionRef<void(FArchive&, FStringTable&)> SerializeReferences)
+{
+	FStringTable Table;
+
+	if (Ar.IsLoading())
+	{
+		int32 NumStrings = 0;
+		if (!SerializeCount(Ar, NumStrings))
+		{
+			return;
+		}
+
+		Table.Strings.SetNum(NumStrings);
+		for (FString& String : Table.Strings)
+		{
+			LoadString(Ar, String);
+
+			if (Ar.IsError())
+			{
+				return;
+			}
+		}
+
+		SerializeReferences(Ar, Table);
+		return;
+	}
+
+	// The table is only complete once every string was referenced: the references are written aside first
+	TArray<uint8> References;
+	{
+		FMemoryWriter ReferencesWriter(References);
+		SerializeReferences(ReferencesWriter, Table);
+	}
+
+	int32 NumStrings = Table.Strings.Num();
+	SerializeCount(Ar, NumStrings);
+
+	for (FString& String : Table.Strings)
+	{
+		Ar << String;
+	}
+
+	Ar.Serialize(References.GetData(), References.Num());
+}
+
+void FHttpGPTChatSerializer::SerializeMessages(FArchive& Ar, TArray<FHttpGPTChatMessage>& Messages, FStringTable& Table)
+{
+	int32 NumMessages = Messages.Num();
+	if (!SerializeCount(Ar, NumMessages))
+	{
+		return;
+	}
+
+	if (Ar.IsLoading())
+	{
+		Messages.SetNum(NumMessages);
+	}
+
+	for (FHttpGPTChatMessage& Message : Messages)
+	{
+		SerializeEnum(Ar, Message.Role, EHttpGPTChatRole::Function);
+		SerializeString(Ar, Message.Content, Table);
+		SerializeName(Ar, Message.FunctionCall.Name, Table);
+		SerializeString(Ar, Message.FunctionCall.Arguments, Table);
+
+		int32 NumImages = Message.Images.Num();
+		if (!SerializeCount(Ar, NumImages))
+		{
+			return;
+		}
+
+		if (Ar.IsLoading())
+		{
+			Message.Images.SetNum(NumImages);
+		}
+
+		for (FHttpGPTChatImage& Image : Message.Images)
+		{
+			SerializeString(Ar, Image.URL, Table);
+			SerializeEnum(Ar, Image.Detail, EHttpGPTChatImageDetail::High);
+		}
+
+		if (Ar.IsError())
+		{
+			return;
+		}
+	}
+}
+
+void FHttpGPTChatSerializer::SerializeString(FArchive& Ar, FString& Value, FStringTable& Table)
+{
+	uint32 Index = 0u;
+
+	if (Ar.IsLoading())
+	{
+		Ar.SerializeIntPacked(Index);
+
+		if (!Table.Strings.IsValidIndex(static_cast<int32>(Index)))
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Value = Table.Strings[Index];
+		return;
+	}
+
+	if (const int32* const FoundIndex = Table.Indices.Find(Value))
+	{
+		Index = static_cast<uint32>(*FoundIndex);
+	}
+	else
+	{
+		Index = static_cast<uint32>(Table.Strings.Add(Value));
+		Table.Indices.Add(Value, static_cast<int32>(Index));
+	}
+
+	Ar.SerializeIntPacked(Index);
+}
+
+void FHttpGPTChatSerializer::SerializeName(FArchive& Ar, FName& Value, FStringTable& Table)
+{
+	FString NameString = Value.ToString();
+	SerializeString(Ar, NameString, Table);
+
+	if (Ar.IsLoading())
+	{
+		Value = *NameString;
+	}
+}
+
+FName FHttpGPTChatSerializer::GetCompressionFormat(const EHttpGPTChatCompression Compression)
+{
+	switch (Compression)
+	{
+	case EHttpGPTChatCompression::Zlib:
+		return NAME_Zlib;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	case EHttpGPTChatCompression::Oodle:
+		return NAME_Oodle;
+#endif
+
+	default:
+		return NAME_None;
+	}
+}
+
+bool FHttpGPTChatSerializer::Save(const TArray<FHttpGPTChatConversation>& Conversations, const EHttpGPTChatCompression Compression, TArray<uint8>& OutData)
+{
+	TArray<uint8> Payload;
+	{
+		FMemoryWriter PayloadWriter(Payload);
+		Serialize(PayloadWriter, const_cast<TArray<FHttpGPTChatConversation>&>(Conversations));
+	}
+
+	// The saved compression is the one actually used, so the data can be loaded by any engine version supporting it
+	EHttpGPTChatCompression UsedCompression = Compression;
+#if ENGINE_MAJOR_VERSION < 5
+	if (UsedCompression == EHttpGPTChatCompression::Oodle)
+	{
+		UsedCompression = EHttpGPTChatCompression::Zlib;
+	}
+#endif
+
+	const FName Format = GetCompressionFormat(UsedCompression);
+
+	uint32 Magic = ChatSerializerMagic;
+	int32 Version = ChatSerializerVersion;
+	uint8 SavedCompression = static_cast<uint8>(UsedCompression);
+	int32 PayloadSize = Payload.Num();
+
+	OutData.Reset();
+	FMemoryWriter Writer(OutData);
+	Writer << Magic << Version << SavedCompression << PayloadSize;
+
+	if (Format.IsNone())
+	{
+		Writer.Serialize(Payload.GetData(), Payload.Num());
+		return true;
+	}
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(Format, PayloadSize);
+	const int64 HeaderSize = OutData.Num();
+	OutData.AddUninitialized(CompressedSize);
+
+	if (!FCompression::CompressMemory(Format, OutData.GetData() + HeaderSize, CompressedSize, Payload.GetData(), PayloadSize))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to compress %d conversations with %s"), *FString(__FUNCTION__), Conversations.Num(), *Format.ToString());
+
+		OutData.Reset();
+		return false;
+	}
+
+	OutData.SetNum(HeaderSize + CompressedSize);
+	return true;
+}
+
+bool FHttpGPTChatSerializer::Load(const TArray<uint8>& Data, TArray<FHttpGPTChatConversation>& OutConversations)
+{
+	OutConversations.Reset();
+
+	FMemoryReader Reader(Data);
+
+	uint32 Magic = 0u;
+	int32 Version = 0;
+	uint8 SavedCompression = 0u;
+	int32 PayloadSize = 0;
+	Reader << Magic << Version << SavedCompression << PayloadSize;
+
+	if (Reader.IsError() || Magic != ChatSerializerMagic || Version != ChatSerializerVersion || PayloadSize < 0 || SavedCompression > static_cast<uint8>(
+		EHttpGPTChatCompression::Oodle))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Unrecognized chat data"), *FString(__FUNCTION__));
+		return false;
+	}
+
+	const EHttpGPTChatCompression SavedFormat = static_cast<EHttpGPTChatCompression>(SavedCompression);
+	const FName Format = GetCompressionFormat(SavedFormat);
+	const int64 HeaderSize = Reader.Tell();
+
+	if (Format.IsNone() && SavedFormat != EHttpGPTChatCompression::None)
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Chat data compressed with Oodle requires Unreal Engine 5"), *FString(__FUNCTION__));
+		return false;
+	}
+
+	TArray<uint8> Payload;
+	if (Format.IsNone())
+	{
+		Payload.Append(Data.GetData() + HeaderSize, Data.Num() - HeaderSize);
+	}
+	else
+	{
+		if (PayloadSize > (Data.Num() - HeaderSize) * MaxCompressionRatio)
+		{
+			UE_LOG(LogHttpGPT, Error, TEXT("%s: Chat data is corrupted"), *FString(__FUNCTION__));
+			return false;
+		}
+
+		Payload.SetNumUninitialized(PayloadSize);
+
+		if (!FCompression::UncompressMemory(Format, Payload.GetData(), PayloadSize, Data.GetData() + HeaderSize, Data.Num() - HeaderSize))
+		{
+			UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to decompress chat data with %s"), *FString(__FUNCTION__), *Format.ToString());
+			return false;
+		}
+	}
+
+	FMemoryReader PayloadReader(Payload);
+	Serialize(PayloadReader, OutConversations);
+
+	if (PayloadReader.IsError())
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Chat data is corrupted"), *FString(__FUNCTION__));
+
+		OutConversations.Reset();
+		return false;
+	}
+
+	return true;
+}
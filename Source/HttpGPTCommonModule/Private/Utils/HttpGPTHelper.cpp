@@ -3,7 +3,11 @@
 // Repo: https://github.com/lucoiso/UEHttpGPT
 
 #include "Utils/HttpGPTHelper.h"
+#include "Utils/HttpGPTPromptTemplate.h"
+#include "Utils/HttpGPTTokenizer.h"
+#include "Management/HttpGPTSettings.h"
 #include "HttpGPTInternalFuncs.h"
+#include "LogHttpGPT.h"
 
 #ifdef UE_INLINE_GENERATED_CPP_BY_NAME
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HttpGPTHelper)
@@ -34,6 +38,9 @@ const FName UHttpGPTHelper::ModelToName(const EHttpGPTChatModel Model)
 	case EHttpGPTChatModel::codedavinci002:
 		return "code-davinci-002";
 
+	case EHttpGPTChatModel::gpt4vision:
+		return "gpt-4-vision-preview";
+
 	default: break;
 	}
 
@@ -70,6 +77,10 @@ const EHttpGPTChatModel UHttpGPTHelper::NameToModel(const FName Model)
 	{
 		return EHttpGPTChatModel::codedavinci002;
 	}
+	if (Model.IsEqual("gpt-4-vision-preview", ENameCase::IgnoreCase))
+	{
+		return EHttpGPTChatModel::gpt4vision;
+	}
 
 	return EHttpGPTChatModel::gpt35turbo;
 }
@@ -157,11 +168,31 @@ const EHttpGPTPropertyType UHttpGPTHelper::NameToPropertyType(const FName Type)
 	return EHttpGPTPropertyType::Boolean;
 }
 
+const FName UHttpGPTHelper::ImageDetailToName(const EHttpGPTChatImageDetail Detail)
+{
+	switch (Detail)
+	{
+	case EHttpGPTChatImageDetail::Auto:
+		return "auto";
+
+	case EHttpGPTChatImageDetail::Low:
+		return "low";
+
+	case EHttpGPTChatImageDetail::High:
+		return "high";
+
+	default:
+		break;
+	}
+
+	return NAME_None;
+}
+
 const TArray<FName> UHttpGPTHelper::GetAvailableGPTModels()
 {
 	TArray<FName> Output;
 
-	for (uint8 Iterator = static_cast<uint8>(EHttpGPTChatModel::gpt4); Iterator <= static_cast<uint8>(EHttpGPTChatModel::codedavinci002); ++Iterator)
+	for (uint8 Iterator = static_cast<uint8>(EHttpGPTChatModel::gpt4); Iterator <= static_cast<uint8>(EHttpGPTChatModel::gpt4vision); ++Iterator)
 	{
 		if (const FName ModelName = ModelToName(static_cast<EHttpGPTChatModel>(Iterator)); !HttpGPT::Internal::HasEmptyParam(ModelName))
 		{
@@ -180,6 +211,7 @@ const FString UHttpGPTHelper::GetEndpointForModel(const EHttpGPTChatModel Model,
 	case EHttpGPTChatModel::gpt432k:
 	case EHttpGPTChatModel::gpt35turbo:
 	case EHttpGPTChatModel::gpt35turbo16k:
+	case EHttpGPTChatModel::gpt4vision:
 		{
 			if (bIsAzureOpenAI)
 			{
@@ -215,6 +247,7 @@ const bool UHttpGPTHelper::ModelSupportsChat(const EHttpGPTChatModel Model)
 	case EHttpGPTChatModel::gpt432k:
 	case EHttpGPTChatModel::gpt35turbo:
 	case EHttpGPTChatModel::gpt35turbo16k:
+	case EHttpGPTChatModel::gpt4vision:
 		return true;
 
 	case EHttpGPTChatModel::textdavinci003:
@@ -228,6 +261,72 @@ const bool UHttpGPTHelper::ModelSupportsChat(const EHttpGPTChatModel Model)
 	return false;
 }
 
+const bool UHttpGPTHelper::ModelSupportsVision(const EHttpGPTChatModel Model)
+{
+	return Model == EHttpGPTChatModel::gpt4vision;
+}
+
+const int32 UHttpGPTHelper::GetContextWindowForModel(const EHttpGPTChatModel Model)
+{
+	switch (Model)
+	{
+	case EHttpGPTChatModel::gpt4:
+		return 8192;
+
+	case EHttpGPTChatModel::gpt432k:
+		return 32768;
+
+	case EHttpGPTChatModel::gpt35turbo:
+		return 4096;
+
+	case EHttpGPTChatModel::gpt35turbo16k:
+		return 16384;
+
+	case EHttpGPTChatModel::textdavinci003:
+	case EHttpGPTChatModel::textdavinci002:
+		return 4097;
+
+	case EHttpGPTChatModel::codedavinci002:
+		return 8001;
+
+	case EHttpGPTChatModel::gpt4vision:
+		return 128000;
+
+	default: break;
+	}
+
+	return 4096;
+}
+
+const int32 UHttpGPTHelper::CountTokens(const FString& Text, const EHttpGPTChatModel Model)
+{
+	const FHttpGPTTokenizerPtr Tokenizer = FHttpGPTTokenizer::Get(Model);
+	return Tokenizer.IsValid() ? Tokenizer->Count(Text) : INDEX_NONE;
+}
+
+const int32 UHttpGPTHelper::CountMessageTokens(const TArray<FHttpGPTChatMessage>& Messages, const EHttpGPTChatModel Model)
+{
+	const FHttpGPTTokenizerPtr Tokenizer = FHttpGPTTokenizer::Get(Model);
+	return Tokenizer.IsValid() ? Tokenizer->CountMessages(Messages) : INDEX_NONE;
+}
+
+const FString UHttpGPTHelper::FormatPromptTemplate(const FString& Template, const TMap<FName, FString>& Variables)
+{
+	return FHttpGPTPromptTemplate::Find(Template)->Render(Variables);
+}
+
+const FString UHttpGPTHelper::FormatNamedPromptTemplate(const FName TemplateName, const TMap<FName, FString>& Variables)
+{
+	const FString* const Template = UHttpGPTSettings::Get()->PromptTemplates.Find(TemplateName);
+	if (!Template)
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Prompt template %s not found in the settings"), *FString(__FUNCTION__), *TemplateName.ToString());
+		return FString();
+	}
+
+	return FormatPromptTemplate(*Template, Variables);
+}
+
 const FName UHttpGPTHelper::SizeToName(const EHttpGPTImageSize Size)
 {
 	switch (Size)
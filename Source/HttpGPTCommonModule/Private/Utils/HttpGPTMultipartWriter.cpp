@@ -0,0 +1,174 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Utils/HttpGPTMultipartWriter.h"
+#include "LogHttpGPT.h"
+
+#include <HAL/PlatformFileManager.h>
+#include <HAL/FileManager.h>
+#include <Misc/Paths.h>
+#include <Misc/Guid.h>
+
+FHttpGPTMultipartWriter::FHttpGPTMultipartWriter(const FString& InFilePath) : Boundary(TEXT("HttpGPTBoundary") + FGuid::NewGuid().ToString(EGuidFormats::Digits))
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(InFilePath));
+
+	FileHandle.Reset(PlatformFile.OpenWrite(*InFilePath));
+	bHasError = !FileHandle.IsValid();
+
+	if (bHasError)
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to open %s for writing"), *FString(__FUNCTION__), *InFilePath);
+	}
+}
+
+FHttpGPTMultipartWriter::~FHttpGPTMultipartWriter()
+{
+	FileHandle.Reset();
+}
+
+bool FHttpGPTMultipartWriter::IsValid() const
+{
+	return FileHandle.IsValid() && !bHasError;
+}
+
+void FHttpGPTMultipartWriter::AddField(const FString& Name, const FString& Value)
+{
+	BeginPart(Name, FString(), FString());
+	Write(Value);
+	Write(TEXT("\r\n"));
+
+	Description += FString::Format(TEXT("{0}: {1}\n"), {Name, Value});
+}
+
+void FHttpGPTMultipartWriter::AddFile(const FString& Name, const FString& FileName, const FString& ContentType, const uint8* const Data, const int64 Size)
+{
+	BeginPart(Name, FileName, ContentType);
+	Write(Data, Size);
+	Write(TEXT("\r\n"));
+
+	Description += FString::Format(TEXT("{0}: {1} ({2} bytes)\n"), {Name, FileName, Size});
+}
+
+void FHttpGPTMultipartWriter::AddFileFromDisk(const FString& Name, const FString& ContentType, const FString& SourcePath)
+{
+	const TUniquePtr<IFileHandle> SourceHandle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*SourcePath));
+	if (!SourceHandle.IsValid())
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to open %s"), *FString(__FUNCTION__), *SourcePath);
+		bHasError = true;
+		return;
+	}
+
+	const FString FileName = FPaths::GetCleanFilename(SourcePath);
+	BeginPart(Name, FileName, ContentType);
+
+	constexpr int64 ChunkSize = 256 * 1024;
+	TArray<uint8> Chunk;
+	Chunk.SetNumUninitialized(ChunkSize);
+
+	const int64 FileSize = SourceHandle->Size();
+	for (int64 Offset = 0; Offset < FileSize && IsValid(); Offset += ChunkSize)
+	{
+		const int64 ReadSize = FMath::Min(ChunkSize, FileSize - Offset);
+		if (!SourceHandle->Read(Chunk.GetData(), ReadSize))
+		{
+			UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to read %s"), *FString(__FUNCTION__), *SourcePath);
+			bHasError = true;
+			return;
+		}
+
+		Write(Chunk.GetData(), ReadSize);
+	}
+
+	Write(TEXT("\r\n"));
+
+	Description += FString::Format(TEXT("{0}: {1} ({2} bytes)\n"), {Name, FileName, FileSize});
+}
+
+bool FHttpGPTMultipartWriter::Finish()
+{
+	Write(FString::Format(TEXT("--{0}--\r\n"), {Boundary}));
+
+	const bool bOutput = IsValid() && FileHandle->Flush();
+	FileHandle.Reset();
+
+	return bOutput;
+}
+
+FString FHttpGPTMultipartWriter::GetContentType() const
+{
+	return FString::Format(TEXT("multipart/form-data; boundary={0}"), {Boundary});
+}
+
+const FString& FHttpGPTMultipartWriter::GetDescription() const
+{
+	return Description;
+}
+
+static FString GetTempDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HttpGPT"), TEXT("Uploads"));
+}
+
+FString FHttpGPTMultipartWriter::CreateTempFilePath()
+{
+	return FPaths::CreateTempFilename(*GetTempDirectory(), TEXT("Upload"), TEXT(".tmp"));
+}
+
+void FHttpGPTMultipartWriter::DeleteStaleTempFiles()
+{
+	const FString TempDirectory = GetTempDirectory();
+
+	TArray<FString> TempFiles;
+	IFileManager::Get().FindFiles(TempFiles, *FPaths::Combine(TempDirectory, TEXT("*.tmp")), true, false);
+
+	// Other instances sharing the project directory may still be streaming their recent uploads
+	const FDateTime MaxTimeStamp = FDateTime::UtcNow() - FTimespan::FromHours(1.0);
+
+	for (const FString& TempFile : TempFiles)
+	{
+		const FString TempFilePath = FPaths::Combine(TempDirectory, TempFile);
+		if (IFileManager::Get().GetTimeStamp(*TempFilePath) < MaxTimeStamp)
+		{
+			IFileManager::Get().Delete(*TempFilePath, false, false, true);
+		}
+	}
+}
+
+void FHttpGPTMultipartWriter::BeginPart(const FString& Name, const FString& FileName, const FString& ContentType)
+{
+	Write(FString::Format(TEXT("--{0}\r\n"), {Boundary}));
+
+	if (FileName.IsEmpty())
+	{
+		Write(FString::Format(TEXT("Content-Disposition: form-data; name=\"{0}\"\r\n\r\n"), {Name}));
+	}
+	else
+	{
+		Write(FString::Format(TEXT("Content-Disposition: form-data; name=\"{0}\"; filename=\"{1}\"\r\n"), {Name, FileName}));
+		Write(FString::Format(TEXT("Content-Type: {0}\r\n\r\n"), {ContentType}));
+	}
+}
+
+void FHttpGPTMultipartWriter::Write(const FString& Text)
+{
+	const FTCHARToUTF8 TextUTF8(*Text);
+	Write(reinterpret_cast<const uint8*>(TextUTF8.Get()), TextUTF8.Length());
+}
+
+void FHttpGPTMultipartWriter::Write(const uint8* const Data, const int64 Size)
+{
+	if (!IsValid() || Size <= 0)
+	{
+		return;
+	}
+
+	if (!FileHandle->Write(Data, Size))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to write the request body"), *FString(__FUNCTION__));
+		bHasError = true;
+	}
+}
@@ -0,0 +1,202 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Utils/HttpGPTPromptTemplate.h"
+#include "LogHttpGPT.h"
+#include "HttpGPTInternalFuncs.h"
+#include <Misc/ScopeLock.h>
+
+// Renderings kept by each template. Most templates are rendered with a few different values, like the selected model
+static constexpr int32 MaxRenderings = 16;
+
+// Templates kept by Find. Templates built from arbitrary texts would otherwise accumulate
+static constexpr int32 MaxTemplates = 256;
+
+static bool IsVariableChar(const TCHAR Char)
+{
+	return FChar::IsAlnum(Char) || Char == TEXT('_');
+}
+
+FHttpGPTPromptTemplate::FHttpGPTPromptTemplate(const FString& InText) : Text(InText)
+{
+	Parse();
+}
+
+FHttpGPTPromptTemplateRef FHttpGPTPromptTemplate::Find(const FString& Text)
+{
+	// Templates that only differ in case render different texts
+	static TMap<FString, FHttpGPTPromptTemplateRef, FDefaultSetAllocator, HttpGPT::Internal::TCaseSensitiveKeyFuncs<FHttpGPTPromptTemplateRef>> Templates;
+	static FCriticalSection TemplatesMutex;
+
+	FScopeLock Lock(&TemplatesMutex);
+
+	if (const FHttpGPTPromptTemplateRef* const Template = Templates.Find(Text))
+	{
+		return *Template;
+	}
+
+	if (Templates.Num() >= MaxTemplates)
+	{
+		UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Too many prompt templates, clearing the compiled ones"), *FString(__FUNCTION__));
+		Templates.Empty();
+	}
+
+	return Templates.Add(Text, MakeShared<FHttpGPTPromptTemplate, ESPMode::ThreadSafe>(Text));
+}
+
+void FHttpGPTPromptTemplate::Parse()
+{
+	int32 LiteralStart = 0;
+
+	const auto AddLiteral = [this, &LiteralStart](const int32 End)
+	{
+		if (End > LiteralStart)
+		{
+			Segments.Add(FSegment{LiteralStart, End - LiteralStart, INDEX_NONE});
+			LiteralLength += End - LiteralStart;
+		}
+	};
+
+	for (int32 Index = 0; Index < Text.Len(); ++Index)
+	{
+		if (Text[Index] != TEXT('{'))
+		{
+			continue;
+		}
+
+		int32 End = Index + 1;
+		while (End < Text.Len() && IsVariableChar(Text[End]))
+		{
+			++End;
+		}
+
+		// Braces not enclosing a name are literal text
+		if (End == Index + 1 || End >= Text.Len() || Text[End] != TEXT('}'))
+		{
+			continue;
+		}
+
+		AddLiteral(Index);
+
+		const FName Name(*Text.Mid(Index + 1, End - Index - 1));
+		int32 Variable = Variables.Find(Name);
+		if (Variable == INDEX_NONE)
+		{
+			Variable = Variables.Add(Name);
+			Placeholders.Add(Text.Mid(Index, End - Index + 1));
+		}
+
+		Segments.Add(FSegment{Index, End - Index + 1, Variable});
+
+		Index = End;
+		LiteralStart = End + 1;
+	}
+
+	AddLiteral(Text.Len());
+}
+
+FString FHttpGPTPromptTemplate::Render(const TMap<FName, FString>& Values) const
+{
+	return Render([&Values](const FName& Name)
+	{
+		return Values.Find(Name);
+	});
+}
+
+FString FHttpGPTPromptTemplate::Render(const TFunctionRef<const FString*(const FName&)> FindValue) const
+{
+	if (Variables.Num() <= 0)
+	{
+		return Text;
+	}
+
+	TArray<const FString*, TInlineAllocator<16>> Values;
+	Values.Reserve(Variables.Num());
+
+	uint32 Hash = 0u;
+	int32 Length = LiteralLength;
+
+	for (int32 Variable = 0; Variable < Variables.Num(); ++Variable)
+	{
+		const FString* const Value = FindValue(Variables[Variable]);
+		Values.Add(Value ? Value : &Placeholders[Variable]);
+
+		Hash = HashCombine(Hash, GetTypeHash(*Values.Last()));
+	}
+
+	const auto IsRenderedWith = [&Values](const FRendering& Rendering)
+	{
+		for (int32 Variable = 0; Variable < Values.Num(); ++Variable)
+		{
+			if (!Rendering.Values[Variable].Equals(*Values[Variable], ESearchCase::CaseSensitive))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	{
+		FScopeLock Lock(&Mutex);
+
+		if (const FRendering* const Rendering = Renderings.Find(Hash); Rendering && IsRenderedWith(*Rendering))
+		{
+			return Rendering->Result;
+		}
+	}
+
+	for (const FSegment& Segment : Segments)
+	{
+		if (Segment.Variable != INDEX_NONE)
+		{
+			Length += Values[Segment.Variable]->Len();
+		}
+	}
+
+	FString Result;
+	Result.Reserve(Length);
+
+	for (const FSegment& Segment : Segments)
+	{
+		if (Segment.Variable == INDEX_NONE)
+		{
+			Result.AppendChars(*Text + Segment.Start, Segment.Length);
+		}
+		else
+		{
+			Result.Append(*Values[Segment.Variable]);
+		}
+	}
+
+	FRendering Rendering;
+	Rendering.Values.Reserve(Values.Num());
+	for (const FString* const Value : Values)
+	{
+		Rendering.Values.Add(*Value);
+	}
+	Rendering.Result = Result;
+
+	FScopeLock Lock(&Mutex);
+
+	if (Renderings.Num() >= MaxRenderings)
+	{
+		Renderings.Empty();
+	}
+
+	// A different rendering with the same hash is replaced
+	Renderings.Add(Hash, MoveTemp(Rendering));
+
+	return Result;
+}
+
+const FString& FHttpGPTPromptTemplate::GetText() const
+{
+	return Text;
+}
+
+const TArray<FName>& FHttpGPTPromptTemplate::GetVariables() const
+{
+	return Variables;
+}
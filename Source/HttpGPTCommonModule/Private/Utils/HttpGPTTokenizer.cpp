@@ -0,0 +1,1147 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Utils/HttpGPTTokenizer.h"
+#include "Utils/HttpGPTBase64.h"
+#include "Utils/HttpGPTHelper.h"
+#include "Management/HttpGPTSettings.h"
+#include "LogHttpGPT.h"
+
+#include <Async/MappedFileHandle.h>
+#include <Async/ParallelFor.h>
+#include <HAL/PlatformFileManager.h>
+#include <HAL/FileManager.h>
+#include <HAL/IConsoleManager.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+#include <Misc/ScopeLock.h>
+
+struct FHttpGPTTokenizer::FSlot
+{
+	uint32 Hash;
+	uint32 Offset;
+
+	/* Zero for empty slots: tokens have at least one byte */
+	uint32 Length;
+
+	int32 Rank;
+};
+
+struct FHttpGPTTokenizer::FTokenBytes
+{
+	uint32 Offset;
+	uint32 Length;
+};
+
+namespace HttpGPT::Tokenizer
+{
+	// "HBPE", to reject files that were not written by this tokenizer
+	constexpr uint32 CompiledMagic = 0x45504248;
+
+	// Change this version when the compiled layout changes
+	constexpr uint32 CompiledVersion = 1;
+
+	struct FCompiledHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+
+		/* Vocabulary the file was compiled from, to compile it again when it changes */
+		int64 SourceSize;
+		int64 SourceTime;
+
+		uint32 NumSlots;
+		uint32 NumTokens;
+		uint32 DataSize;
+		uint32 Padding;
+	};
+
+	// Batches with less text are processed in the calling thread
+	constexpr int64 MinParallelBatchLength = 64 * 1024;
+
+	enum class ECharClass : uint8
+	{
+		Letter,
+		Number,
+		Whitespace,
+		Other,
+		End
+	};
+
+	struct FCharRange
+	{
+		uint32 First;
+		uint32 Last;
+		ECharClass Class;
+	};
+
+	// Non-ASCII characters that are not letters, sorted. Hand-made approximation of the Unicode categories used by the patterns of the
+	// encodings, not generated from the Unicode data: it covers the common scripts, symbols and punctuation and the remaining characters are letters
+	constexpr FCharRange CharRanges[] = {
+		{0x80, 0x84, ECharClass::Other}, {0x85, 0x85, ECharClass::Whitespace}, {0x86, 0x9F, ECharClass::Other},
+		{0xA0, 0xA0, ECharClass::Whitespace}, {0xA1, 0xA9, ECharClass::Other}, {0xAB, 0xB1, ECharClass::Other}, {0xB2, 0xB3, ECharClass::Number},
+		{0xB4, 0xB4, ECharClass::Other}, {0xB6, 0xB8, ECharClass::Other}, {0xB9, 0xB9, ECharClass::Number}, {0xBB, 0xBB, ECharClass::Other},
+		{0xBC, 0xBE, ECharClass::Number}, {0xBF, 0xBF, ECharClass::Other}, {0xD7, 0xD7, ECharClass::Other}, {0xF7, 0xF7, ECharClass::Other},
+		{0x2C2, 0x2C5, ECharClass::Other}, {0x2D2, 0x2DF, ECharClass::Other}, {0x2E5, 0x2EB, ECharClass::Other}, {0x2ED, 0x2ED, ECharClass::Other},
+		{0x2EF, 0x36F, ECharClass::Other}, {0x374, 0x375, ECharClass::Other}, {0x37E, 0x37E, ECharClass::Other}, {0x384, 0x385, ECharClass::Other},
+		{0x387, 0x387, ECharClass::Other}, {0x3F6, 0x3F6, ECharClass::Other}, {0x482, 0x489, ECharClass::Other}, {0x55A, 0x55F, ECharClass::Other},
+		{0x589, 0x58F, ECharClass::Other}, {0x591, 0x5C7, ECharClass::Other}, {0x5F3, 0x5F4, ECharClass::Other}, {0x600, 0x61F, ECharClass::Other},
+		{0x64B, 0x65F, ECharClass::Other}, {0x660, 0x669, ECharClass::Number}, {0x66A, 0x66D, ECharClass::Other}, {0x670, 0x670, ECharClass::Other},
+		{0x6D4, 0x6D4, ECharClass::Other}, {0x6D6, 0x6E4, ECharClass::Other}, {0x6E7, 0x6ED, ECharClass::Other}, {0x6F0, 0x6F9, ECharClass::Number},
+		{0x7C0, 0x7C9, ECharClass::Number}, {0x900, 0x903, ECharClass::Other}, {0x93A, 0x93C, ECharClass::Other}, {0x93E, 0x94F, ECharClass::Other},
+		{0x951, 0x957, ECharClass::Other}, {0x962, 0x965, ECharClass::Other}, {0x966, 0x96F, ECharClass::Number}, {0x970, 0x970, ECharClass::Other},
+		{0x9E6, 0x9EF, ECharClass::Number}, {0xA66, 0xA6F, ECharClass::Number}, {0xAE6, 0xAEF, ECharClass::Number}, {0xB66, 0xB6F, ECharClass::Number},
+		{0xBE6, 0xBF2, ECharClass::Number}, {0xC66, 0xC6F, ECharClass::Number}, {0xCE6, 0xCEF, ECharClass::Number}, {0xD66, 0xD78, ECharClass::Number},
+		{0xDE6, 0xDEF, ECharClass::Number}, {0xE31, 0xE31, ECharClass::Other}, {0xE34, 0xE3F, ECharClass::Other}, {0xE47, 0xE4F, ECharClass::Other},
+		{0xE50, 0xE59, ECharClass::Number}, {0xE5A, 0xE5B, ECharClass::Other}, {0xED0, 0xED9, ECharClass::Number}, {0xF20, 0xF33, ECharClass::Number},
+		{0x1040, 0x1049, ECharClass::Number}, {0x1680, 0x1680, ECharClass::Whitespace}, {0x17E0, 0x17E9, ECharClass::Number},
+		{0x1810, 0x1819, ECharClass::Number}, {0x2000, 0x200A, ECharClass::Whitespace}, {0x200B, 0x2027, ECharClass::Other},
+		{0x2028, 0x2029, ECharClass::Whitespace}, {0x202A, 0x202E, ECharClass::Other}, {0x202F, 0x202F, ECharClass::Whitespace},
+		{0x2030, 0x205E, ECharClass::Other}, {0x205F, 0x205F, ECharClass::Whitespace}, {0x2060, 0x206F, ECharClass::Other},
+		{0x2070, 0x2070, ECharClass::Number}, {0x2074, 0x2079, ECharClass::Number}, {0x207A, 0x207E, ECharClass::Other},
+		{0x2080, 0x2089, ECharClass::Number}, {0x208A, 0x208E, ECharClass::Other}, {0x20A0, 0x2101, ECharClass::Other},
+		{0x2103, 0x2106, ECharClass::Other}, {0x2108, 0x2109, ECharClass::Other}, {0x2114, 0x2114, ECharClass::Other},
+		{0x2116, 0x2118, ECharClass::Other}, {0x211E, 0x2123, ECharClass::Other}, {0x2125, 0x2125, ECharClass::Other},
+		{0x2127, 0x2127, ECharClass::Other}, {0x2129, 0x2129, ECharClass::Other}, {0x212E, 0x212E, ECharClass::Other},
+		{0x213A, 0x213B, ECharClass::Other}, {0x2140, 0x2144, ECharClass::Other}, {0x214A, 0x214D, ECharClass::Other},
+		{0x214F, 0x214F, ECharClass::Other}, {0x2150, 0x2182, ECharClass::Number}, {0x2185, 0x2189, ECharClass::Number},
+		{0x218A, 0x245F, ECharClass::Other}, {0x2460, 0x249B, ECharClass::Number}, {0x249C, 0x24E9, ECharClass::Other},
+		{0x24EA, 0x24FF, ECharClass::Number}, {0x2500, 0x2775, ECharClass::Other}, {0x2776, 0x2793, ECharClass::Number},
+		{0x2794, 0x2BFF, ECharClass::Other}, {0x2E00, 0x2E7F, ECharClass::Other}, {0x2FF0, 0x2FFF, ECharClass::Other},
+		{0x3000, 0x3000, ECharClass::Whitespace}, {0x3001, 0x3004, ECharClass::Other}, {0x3007, 0x3007, ECharClass::Number},
+		{0x3008, 0x3020, ECharClass::Other}, {0x3021, 0x3029, ECharClass::Number}, {0x302A, 0x3030, ECharClass::Other},
+		{0x3036, 0x3037, ECharClass::Other}, {0x3038, 0x303A, ECharClass::Number}, {0x303D, 0x303F, ECharClass::Other},
+		{0x3099, 0x309C, ECharClass::Other}, {0x30A0, 0x30A0, ECharClass::Other}, {0x30FB, 0x30FB, ECharClass::Other},
+		{0x3190, 0x3191, ECharClass::Other}, {0x3192, 0x3195, ECharClass::Number}, {0x3196, 0x319F, ECharClass::Other},
+		{0x31C0, 0x31EF, ECharClass::Other}, {0x3200, 0x321F, ECharClass::Other}, {0x3220, 0x3229, ECharClass::Number},
+		{0x322A, 0x3247, ECharClass::Other}, {0x3248, 0x324F, ECharClass::Number}, {0x3250, 0x3250, ECharClass::Other},
+		{0x3251, 0x325F, ECharClass::Number}, {0x3260, 0x327F, ECharClass::Other}, {0x3280, 0x3289, ECharClass::Number},
+		{0x328A, 0x32B0, ECharClass::Other}, {0x32B1, 0x32BF, ECharClass::Number}, {0x32C0, 0x33FF, ECharClass::Other},
+		{0x4DC0, 0x4DFF, ECharClass::Other}, {0xD800, 0xF8FF, ECharClass::Other}, {0xFE00, 0xFE6F, ECharClass::Other},
+		{0xFEFF, 0xFEFF, ECharClass::Other}, {0xFF00, 0xFF0F, ECharClass::Other}, {0xFF10, 0xFF19, ECharClass::Number},
+		{0xFF1A, 0xFF20, ECharClass::Other}, {0xFF3B, 0xFF40, ECharClass::Other}, {0xFF5B, 0xFF65, ECharClass::Other},
+		{0xFFE0, 0xFFFF, ECharClass::Other}, {0x1D100, 0x1D1FF, ECharClass::Other}, {0x1D7CE, 0x1D7FF, ECharClass::Number},
+		{0x1F000, 0x1FAFF, ECharClass::Other}, {0xE0000, 0x10FFFF, ECharClass::Other}
+	};
+
+	static ECharClass ClassifyChar(const uint32 Char)
+	{
+		if (Char < 0x80)
+		{
+			if ((Char | 0x20) >= 'a' && (Char | 0x20) <= 'z')
+			{
+				return ECharClass::Letter;
+			}
+
+			if (Char >= '0' && Char <= '9')
+			{
+				return ECharClass::Number;
+			}
+
+			return Char == ' ' || (Char >= '\t' && Char <= '\r') ? ECharClass::Whitespace : ECharClass::Other;
+		}
+
+		int32 Low = 0;
+		int32 High = UE_ARRAY_COUNT(CharRanges) - 1;
+		while (Low <= High)
+		{
+			const int32 Middle = (Low + High) / 2;
+			if (Char < CharRanges[Middle].First)
+			{
+				High = Middle - 1;
+			}
+			else if (Char > CharRanges[Middle].Last)
+			{
+				Low = Middle + 1;
+			}
+			else
+			{
+				return CharRanges[Middle].Class;
+			}
+		}
+
+		return ECharClass::Letter;
+	}
+
+	// Invalid sequences are read as a single replacement character
+	static FORCEINLINE ECharClass ReadChar(const uint8* const Text, const int32 Length, const int32 Position, int32& OutSize, uint32& OutChar)
+	{
+		if (Position >= Length)
+		{
+			OutSize = 0;
+			OutChar = 0u;
+			return ECharClass::End;
+		}
+
+		const uint8 Lead = Text[Position];
+		if (Lead < 0x80)
+		{
+			OutSize = 1;
+			OutChar = Lead;
+			return ClassifyChar(Lead);
+		}
+
+		int32 Size = 0;
+		uint32 Char = 0u;
+
+		if ((Lead & 0xE0) == 0xC0)
+		{
+			Size = 2;
+			Char = Lead & 0x1F;
+		}
+		else if ((Lead & 0xF0) == 0xE0)
+		{
+			Size = 3;
+			Char = Lead & 0x0F;
+		}
+		else if ((Lead & 0xF8) == 0xF0)
+		{
+			Size = 4;
+			Char = Lead & 0x07;
+		}
+
+		for (int32 Index = 1; Index < Size; ++Index)
+		{
+			if (Position + Index >= Length || (Text[Position + Index] & 0xC0) != 0x80)
+			{
+				Size = 0;
+				break;
+			}
+
+			Char = (Char << 6) | (Text[Position + Index] & 0x3F);
+		}
+
+		if (Size == 0)
+		{
+			OutSize = 1;
+			OutChar = 0xFFFD;
+			return ECharClass::Other;
+		}
+
+		OutSize = Size;
+		OutChar = Char;
+		return ClassifyChar(Char);
+	}
+
+	static FORCEINLINE ECharClass GetClassAt(const uint8* const Text, const int32 Length, const int32 Position)
+	{
+		int32 Size = 0;
+		uint32 Char = 0u;
+		return ReadChar(Text, Length, Position, Size, Char);
+	}
+
+	// End of the characters of the class starting at the position, up to a maximum count. OutLastStart receives the position of the last one
+	static int32 SkipClass(const uint8* const Text, const int32 Length, int32 Position, const ECharClass Class, int32 MaxCount = MAX_int32,
+	                       int32* const OutLastStart = nullptr)
+	{
+		int32 Size = 0;
+		uint32 Char = 0u;
+
+		while (MaxCount-- > 0 && ReadChar(Text, Length, Position, Size, Char) == Class)
+		{
+			if (OutLastStart)
+			{
+				*OutLastStart = Position;
+			}
+
+			Position += Size;
+		}
+
+		return Position;
+	}
+
+	// 's|'t|'re|'ve|'m|'ll|'d
+	static int32 MatchContraction(const uint8* const Text, const int32 Length, const int32 Position, const bool bIgnoreCase)
+	{
+		if (Text[Position] != '\'')
+		{
+			return INDEX_NONE;
+		}
+
+		const auto GetChar = [Text, Length, Position, bIgnoreCase](const int32 Offset) -> uint8
+		{
+			if (Position + Offset >= Length)
+			{
+				return 0u;
+			}
+
+			const uint8 Char = Text[Position + Offset];
+			return bIgnoreCase && Char >= 'A' && Char <= 'Z' ? Char + ('a' - 'A') : Char;
+		};
+
+		const uint8 First = GetChar(1);
+		if (First == 's' || First == 't' || First == 'm' || First == 'd')
+		{
+			return Position + 2;
+		}
+
+		const uint8 Second = GetChar(2);
+		if ((First == 'r' && Second == 'e') || (First == 'v' && Second == 'e') || (First == 'l' && Second == 'l'))
+		{
+			return Position + 3;
+		}
+
+		return INDEX_NONE;
+	}
+
+	// \s+(?!\S)|\s+
+	static int32 MatchWhitespace(const uint8* const Text, const int32 Length, const int32 Position)
+	{
+		int32 LastStart = Position;
+		const int32 End = SkipClass(Text, Length, Position, ECharClass::Whitespace, MAX_int32, &LastStart);
+
+		// The last whitespace before a word is kept for the word
+		return End < Length && LastStart > Position ? LastStart : End;
+	}
+
+	// (?i:'s|'t|'re|'ve|'m|'ll|'d)|[^\r\n\p{L}\p{N}]?\p{L}+|\p{N}{1,3}| ?[^\s\p{L}\p{N}]+[\r\n]*|\s*[\r\n]+|\s+(?!\S)|\s+
+	static int32 MatchCl100k(const uint8* const Text, const int32 Length, const int32 Position)
+	{
+		if (const int32 End = MatchContraction(Text, Length, Position, true); End != INDEX_NONE)
+		{
+			return End;
+		}
+
+		int32 Size = 0;
+		uint32 Char = 0u;
+		const ECharClass Class = ReadChar(Text, Length, Position, Size, Char);
+		const ECharClass NextClass = GetClassAt(Text, Length, Position + Size);
+
+		if (Class == ECharClass::Letter)
+		{
+			return SkipClass(Text, Length, Position + Size, ECharClass::Letter);
+		}
+
+		if (Class != ECharClass::Number && Char != '\r' && Char != '\n' && NextClass == ECharClass::Letter)
+		{
+			return SkipClass(Text, Length, Position + Size, ECharClass::Letter);
+		}
+
+		if (Class == ECharClass::Number)
+		{
+			return SkipClass(Text, Length, Position, ECharClass::Number, 3);
+		}
+
+		if (Class == ECharClass::Other || (Char == ' ' && NextClass == ECharClass::Other))
+		{
+			int32 End = SkipClass(Text, Length, Class == ECharClass::Other ? Position : Position + Size, ECharClass::Other);
+			while (End < Length && (Text[End] == '\r' || Text[End] == '\n'))
+			{
+				++End;
+			}
+
+			return End;
+		}
+
+		// Whitespaces up to the last line break
+		int32 LastBreak = INDEX_NONE;
+		const int32 End = SkipClass(Text, Length, Position, ECharClass::Whitespace);
+		for (int32 Index = Position; Index < End; ++Index)
+		{
+			if (Text[Index] == '\r' || Text[Index] == '\n')
+			{
+				LastBreak = Index;
+			}
+		}
+
+		return LastBreak != INDEX_NONE ? LastBreak + 1 : MatchWhitespace(Text, Length, Position);
+	}
+
+	// 's|'t|'re|'ve|'m|'ll|'d| ?\p{L}+| ?\p{N}+| ?[^\s\p{L}\p{N}]+|\s+(?!\S)|\s+
+	static int32 MatchP50k(const uint8* const Text, const int32 Length, const int32 Position)
+	{
+		if (const int32 End = MatchContraction(Text, Length, Position, false); End != INDEX_NONE)
+		{
+			return End;
+		}
+
+		int32 Size = 0;
+		uint32 Char = 0u;
+		ECharClass Class = ReadChar(Text, Length, Position, Size, Char);
+		int32 Start = Position;
+
+		if (Char == ' ')
+		{
+			if (const ECharClass NextClass = GetClassAt(Text, Length, Position + Size); NextClass != ECharClass::Whitespace && NextClass !=
+				ECharClass::End)
+			{
+				Class = NextClass;
+				Start += Size;
+			}
+		}
+
+		if (Class != ECharClass::Whitespace)
+		{
+			return SkipClass(Text, Length, Start, Class);
+		}
+
+		return MatchWhitespace(Text, Length, Position);
+	}
+
+	// FNV-1a: the pieces are short, so a byte loop is faster than setting up a wider hash
+	static FORCEINLINE uint32 HashBytes(const uint8* const Bytes, const int32 Length)
+	{
+		uint32 Hash = 2166136261u;
+		for (int32 Index = 0; Index < Length; ++Index)
+		{
+			Hash = (Hash ^ Bytes[Index]) * 16777619u;
+		}
+
+		return Hash;
+	}
+
+	static const TCHAR* GetEncodingName(const EHttpGPTTokenEncoding Encoding)
+	{
+		switch (Encoding)
+		{
+		case EHttpGPTTokenEncoding::cl100k_base:
+			return TEXT("cl100k_base");
+
+		case EHttpGPTTokenEncoding::p50k_base:
+			return TEXT("p50k_base");
+
+		default: break;
+		}
+
+		return TEXT("None");
+	}
+}
+
+FHttpGPTTokenizer::FHttpGPTTokenizer(const EHttpGPTTokenEncoding InEncoding) : Encoding(InEncoding)
+{
+}
+
+FHttpGPTTokenizer::~FHttpGPTTokenizer()
+{
+	// The region must be released before the file it maps
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+FHttpGPTTokenizerPtr FHttpGPTTokenizer::Get(const EHttpGPTChatModel Model)
+{
+	return Get(GetEncodingForModel(Model));
+}
+
+FHttpGPTTokenizerPtr FHttpGPTTokenizer::Get(const EHttpGPTTokenEncoding Encoding)
+{
+	static FHttpGPTTokenizerPtr Tokenizers[2];
+	static bool bLoadAttempted[2] = {false, false};
+	static FCriticalSection TokenizersMutex;
+
+	const int32 Index = static_cast<int32>(Encoding);
+
+	FScopeLock Lock(&TokenizersMutex);
+
+	// Missing vocabularies are only reported once
+	if (!bLoadAttempted[Index])
+	{
+		bLoadAttempted[Index] = true;
+
+		if (const TSharedPtr<FHttpGPTTokenizer, ESPMode::ThreadSafe> NewTokenizer(new FHttpGPTTokenizer(Encoding)); NewTokenizer->Load())
+		{
+			Tokenizers[Index] = NewTokenizer;
+		}
+	}
+
+	return Tokenizers[Index];
+}
+
+EHttpGPTTokenEncoding FHttpGPTTokenizer::GetEncodingForModel(const EHttpGPTChatModel Model)
+{
+	switch (Model)
+	{
+	case EHttpGPTChatModel::textdavinci003:
+	case EHttpGPTChatModel::textdavinci002:
+	case EHttpGPTChatModel::codedavinci002:
+		return EHttpGPTTokenEncoding::p50k_base;
+
+	default: break;
+	}
+
+	return EHttpGPTTokenEncoding::cl100k_base;
+}
+
+FString FHttpGPTTokenizer::GetTokenizersDirectory()
+{
+	FString Directory = UHttpGPTSettings::Get()->TokenizersDir;
+	if (FPaths::IsRelative(Directory))
+	{
+		Directory = FPaths::Combine(FPaths::ProjectContentDir(), Directory);
+	}
+
+	return Directory;
+}
+
+FString FHttpGPTTokenizer::GetVocabularyPath(const EHttpGPTTokenEncoding Encoding)
+{
+	return FPaths::Combine(GetTokenizersDirectory(), FString(HttpGPT::Tokenizer::GetEncodingName(Encoding)) + TEXT(".tiktoken"));
+}
+
+FString FHttpGPTTokenizer::GetCompiledPath(const EHttpGPTTokenEncoding Encoding)
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HttpGPT"), TEXT("Tokenizers"),
+	                       FString(HttpGPT::Tokenizer::GetEncodingName(Encoding)) + TEXT(".bpe"));
+}
+
+FString FHttpGPTTokenizer::GetPackagedCompiledPath(const EHttpGPTTokenEncoding Encoding)
+{
+	return FPaths::Combine(GetTokenizersDirectory(), FString(HttpGPT::Tokenizer::GetEncodingName(Encoding)) + TEXT(".bpe"));
+}
+
+#if WITH_EDITOR
+bool FHttpGPTTokenizer::CompileForPackaging(const EHttpGPTTokenEncoding Encoding)
+{
+	const FString SourcePath = GetVocabularyPath(Encoding);
+	const FFileStatData SourceStat = FPlatformFileManager::Get().GetPlatformFile().GetStatData(*SourcePath);
+
+	if (!SourceStat.bIsValid)
+	{
+		UE_LOG(LogHttpGPT, Warning, TEXT("%s: Vocabulary %s not found"), *FString(__FUNCTION__), *SourcePath);
+		return false;
+	}
+
+	if (!Compile(SourcePath, GetPackagedCompiledPath(Encoding), SourceStat.FileSize, INDEX_NONE))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to compile the vocabulary %s"), *FString(__FUNCTION__), *SourcePath);
+		return false;
+	}
+
+	UE_LOG(LogHttpGPT, Display, TEXT("%s: Compiled %s. Add %s to DirectoriesToAlwaysStageAsNonUFS to package it"), *FString(__FUNCTION__),
+	       *GetPackagedCompiledPath(Encoding), *GetTokenizersDirectory());
+
+	return true;
+}
+#endif
+
+bool FHttpGPTTokenizer::Load()
+{
+	const FString SourcePath = GetVocabularyPath(Encoding);
+	const FFileStatData SourceStat = FPlatformFileManager::Get().GetPlatformFile().GetStatData(*SourcePath);
+
+	// Without the source, a vocabulary compiled before is used as it is
+	const int64 SourceSize = SourceStat.bIsValid ? SourceStat.FileSize : INDEX_NONE;
+	const int64 SourceTime = SourceStat.bIsValid ? SourceStat.ModificationTime.GetTicks() : INDEX_NONE;
+
+	// The vocabulary compiled for packaging comes first: it is the only one available in packaged games
+	if (MapCompiled(GetPackagedCompiledPath(Encoding), SourceSize, SourceTime) || MapCompiled(GetCompiledPath(Encoding), SourceSize, SourceTime))
+	{
+		return true;
+	}
+
+	if (!SourceStat.bIsValid)
+	{
+		UE_LOG(LogHttpGPT, Warning,
+		       TEXT("%s: Vocabulary %s not found. Token counts will only be available in the responses that include them. "
+			       "Packaged games need the tokenizers directory in DirectoriesToAlwaysStageAsNonUFS"), *FString(__FUNCTION__), *SourcePath);
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	if (!Compile(SourcePath, GetCompiledPath(Encoding), SourceSize, SourceTime) || !MapCompiled(GetCompiledPath(Encoding), SourceSize, SourceTime))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to compile the vocabulary %s"), *FString(__FUNCTION__), *SourcePath);
+		return false;
+	}
+
+	UE_LOG(LogHttpGPT, Display, TEXT("%s: Compiled the vocabulary %s with %d tokens in %.1f ms"), *FString(__FUNCTION__), *SourcePath, NumTokens,
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	return true;
+}
+
+bool FHttpGPTTokenizer::MapCompiled(const FString& CompiledPath, const int64 SourceSize, const int64 SourceTime)
+{
+	using namespace HttpGPT::Tokenizer;
+
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	LoadedData.Empty();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	if (!PlatformFile.FileExists(*CompiledPath))
+	{
+		return false;
+	}
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4)
+	if (FOpenMappedResult Result = PlatformFile.OpenMappedEx(*CompiledPath); Result.HasValue())
+	{
+		MappedFile = Result.StealValue();
+	}
+#else
+	MappedFile.Reset(PlatformFile.OpenMapped(*CompiledPath));
+#endif
+
+	if (MappedFile.IsValid())
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	if (MappedRegion.IsValid())
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Platforms without memory mapped files read the file instead
+		MappedFile.Reset();
+
+		if (!FFileHelper::LoadFileToArray(LoadedData, *CompiledPath, FILEREAD_Silent))
+		{
+			return false;
+		}
+
+		Data = LoadedData.GetData();
+		Size = LoadedData.Num();
+	}
+
+	const auto Reject = [this]
+	{
+		MappedRegion.Reset();
+		MappedFile.Reset();
+		LoadedData.Empty();
+
+		return false;
+	};
+
+	if (Size < static_cast<int64>(sizeof(FCompiledHeader)))
+	{
+		return Reject();
+	}
+
+	const FCompiledHeader& Header = *reinterpret_cast<const FCompiledHeader*>(Data);
+
+	// Vocabularies compiled for packaging have no source time: staging changes it
+	if (Header.Magic != CompiledMagic || Header.Version != CompiledVersion || (SourceSize != INDEX_NONE && (Header.SourceSize != SourceSize || (Header.
+		SourceTime != INDEX_NONE && Header.SourceTime != SourceTime))))
+	{
+		return Reject();
+	}
+
+	const int64 ExpectedSize = sizeof(FCompiledHeader) + static_cast<int64>(Header.NumSlots) * sizeof(FSlot) + static_cast<int64>(Header.NumTokens) *
+		sizeof(FTokenBytes) + Header.DataSize;
+
+	// The table must keep empty slots for the lookups to stop
+	if (Size != ExpectedSize || !FMath::IsPowerOfTwo(Header.NumSlots) || Header.NumSlots <= Header.NumTokens || Header.NumTokens > MAX_int32)
+	{
+		return Reject();
+	}
+
+	const FSlot* const NewSlots = reinterpret_cast<const FSlot*>(Data + sizeof(FCompiledHeader));
+	const FTokenBytes* const NewTokens = reinterpret_cast<const FTokenBytes*>(NewSlots + Header.NumSlots);
+
+	// Offsets are checked once so the lookups can trust them
+	for (uint32 Index = 0u; Index < Header.NumSlots; ++Index)
+	{
+		if (static_cast<uint64>(NewSlots[Index].Offset) + NewSlots[Index].Length > Header.DataSize)
+		{
+			return Reject();
+		}
+	}
+
+	for (uint32 Index = 0u; Index < Header.NumTokens; ++Index)
+	{
+		if (static_cast<uint64>(NewTokens[Index].Offset) + NewTokens[Index].Length > Header.DataSize)
+		{
+			return Reject();
+		}
+	}
+
+	Slots = NewSlots;
+	SlotMask = Header.NumSlots - 1u;
+	Tokens = NewTokens;
+	NumTokens = static_cast<int32>(Header.NumTokens);
+	TokenData = reinterpret_cast<const uint8*>(NewTokens + Header.NumTokens);
+	TokenDataSize = Header.DataSize;
+
+	return true;
+}
+
+bool FHttpGPTTokenizer::Compile(const FString& SourcePath, const FString& CompiledPath, const int64 SourceSize, const int64 SourceTime)
+{
+	using namespace HttpGPT::Tokenizer;
+
+	TArray<uint8> Source;
+	if (!FFileHelper::LoadFileToArray(Source, *SourcePath))
+	{
+		return false;
+	}
+
+	TArray<FTokenBytes> TokenBytes;
+	TArray<uint8> Data;
+	TArray<uint8> Decoded;
+
+	// Each line has the base64 bytes of a token and its rank, separated by a space
+	for (int32 Position = 0; Position < Source.Num();)
+	{
+		int32 LineEnd = Position;
+		while (LineEnd < Source.Num() && Source[LineEnd] != '\n')
+		{
+			++LineEnd;
+		}
+
+		int32 Separator = Position;
+		while (Separator < LineEnd && Source[Separator] != ' ')
+		{
+			++Separator;
+		}
+
+		if (Separator < LineEnd)
+		{
+			int64 Rank = 0;
+			int32 NumDigits = 0;
+
+			for (int32 Index = Separator + 1; Index < LineEnd && FChar::IsDigit(Source[Index]) && Rank <= MAX_int32; ++Index, ++NumDigits)
+			{
+				Rank = Rank * 10 + (Source[Index] - '0');
+			}
+
+			if (NumDigits <= 0 || Rank >= MAX_int32 / 2 || !FHttpGPTBase64::Decode(reinterpret_cast<const ANSICHAR*>(Source.GetData() + Position),
+			                                                                      Separator - Position, Decoded) || Decoded.Num() <= 0)
+			{
+				UE_LOG(LogHttpGPT, Error, TEXT("%s: Invalid token at byte %d of %s"), *FString(__FUNCTION__), Position, *SourcePath);
+				return false;
+			}
+
+			if (Rank >= TokenBytes.Num())
+			{
+				TokenBytes.SetNumZeroed(static_cast<int32>(Rank) + 1);
+			}
+
+			TokenBytes[static_cast<int32>(Rank)] = FTokenBytes{static_cast<uint32>(Data.Num()), static_cast<uint32>(Decoded.Num())};
+			Data.Append(Decoded);
+		}
+
+		Position = LineEnd + 1;
+	}
+
+	if (TokenBytes.Num() <= 0)
+	{
+		return false;
+	}
+
+	// At most half full, so probing sequences stay short
+	const uint32 NumSlots = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(TokenBytes.Num()) * 2u);
+
+	TArray<FSlot> NewSlots;
+	NewSlots.SetNumZeroed(NumSlots);
+
+	for (int32 Rank = 0; Rank < TokenBytes.Num(); ++Rank)
+	{
+		const FTokenBytes& Token = TokenBytes[Rank];
+		if (Token.Length == 0u)
+		{
+			continue;
+		}
+
+		const uint32 Hash = HashBytes(Data.GetData() + Token.Offset, Token.Length);
+
+		uint32 Index = Hash & (NumSlots - 1u);
+		while (NewSlots[Index].Length != 0u)
+		{
+			Index = (Index + 1u) & (NumSlots - 1u);
+		}
+
+		NewSlots[Index] = FSlot{Hash, Token.Offset, Token.Length, Rank};
+	}
+
+	FCompiledHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = CompiledMagic;
+	Header.Version = CompiledVersion;
+	Header.SourceSize = SourceSize;
+	Header.SourceTime = SourceTime;
+	Header.NumSlots = NumSlots;
+	Header.NumTokens = static_cast<uint32>(TokenBytes.Num());
+	Header.DataSize = static_cast<uint32>(Data.Num());
+
+	TArray<uint8> Output;
+	Output.Append(reinterpret_cast<const uint8*>(&Header), sizeof(FCompiledHeader));
+	Output.Append(reinterpret_cast<const uint8*>(NewSlots.GetData()), NewSlots.Num() * sizeof(FSlot));
+	Output.Append(reinterpret_cast<const uint8*>(TokenBytes.GetData()), TokenBytes.Num() * sizeof(FTokenBytes));
+	Output.Append(Data);
+
+	// Written aside first, so other processes never map a partial file
+	const FString TempPath = CompiledPath + TEXT(".tmp");
+	if (!FFileHelper::SaveArrayToFile(Output, *TempPath))
+	{
+		return false;
+	}
+
+	return IFileManager::Get().Move(*CompiledPath, *TempPath, true, true);
+}
+
+template <typename FunctionType>
+void FHttpGPTTokenizer::Split(const uint8* const Text, const int32 Length, FunctionType&& Function) const
+{
+	const bool bIsCl100k = Encoding == EHttpGPTTokenEncoding::cl100k_base;
+
+	for (int32 Start = 0; Start < Length;)
+	{
+		const int32 End = bIsCl100k ? HttpGPT::Tokenizer::MatchCl100k(Text, Length, Start) : HttpGPT::Tokenizer::MatchP50k(Text, Length, Start);
+
+		Function(Text + Start, End - Start);
+		Start = End;
+	}
+}
+
+int32 FHttpGPTTokenizer::FindRank(const uint8* const Bytes, const int32 Length) const
+{
+	const uint32 Hash = HttpGPT::Tokenizer::HashBytes(Bytes, Length);
+
+	for (uint32 Index = Hash & SlotMask;; Index = (Index + 1u) & SlotMask)
+	{
+		const FSlot& Slot = Slots[Index];
+		if (Slot.Length == 0u)
+		{
+			return INDEX_NONE;
+		}
+
+		if (Slot.Hash == Hash && Slot.Length == static_cast<uint32>(Length) && FMemory::Memcmp(TokenData + Slot.Offset, Bytes, Length) == 0)
+		{
+			return Slot.Rank;
+		}
+	}
+}
+
+int32 FHttpGPTTokenizer::EncodePiece(const uint8* const Bytes, const int32 Length, TArray<int32>* const OutTokens) const
+{
+	// Most words are tokens by themselves
+	if (const int32 Rank = FindRank(Bytes, Length); Rank != INDEX_NONE)
+	{
+		if (OutTokens)
+		{
+			OutTokens->Add(Rank);
+		}
+
+		return 1;
+	}
+
+	if (Length <= 1)
+	{
+		return 0;
+	}
+
+	struct FPart
+	{
+		int32 Start;
+		int32 Rank;
+	};
+
+	// Each part starts a token. Its rank is the one of the token merging it with the next part
+	TArray<FPart, TInlineAllocator<64>> Parts;
+	Parts.SetNumUninitialized(Length + 1);
+
+	const auto FindPartRank = [this, Bytes](const int32 Start, const int32 End)
+	{
+		const int32 Rank = FindRank(Bytes + Start, End - Start);
+		return Rank == INDEX_NONE ? MAX_int32 : Rank;
+	};
+
+	int32 MinRank = MAX_int32;
+	int32 MinIndex = INDEX_NONE;
+
+	for (int32 Index = 0; Index < Length - 1; ++Index)
+	{
+		Parts[Index] = FPart{Index, FindPartRank(Index, Index + 2)};
+
+		if (Parts[Index].Rank < MinRank)
+		{
+			MinRank = Parts[Index].Rank;
+			MinIndex = Index;
+		}
+	}
+
+	Parts[Length - 1] = FPart{Length - 1, MAX_int32};
+	Parts[Length] = FPart{Length, MAX_int32};
+
+	int32 NumParts = Length + 1;
+
+	// Rank of the token merging the part with the next two, as the next one is about to be merged into it
+	const auto GetMergedRank = [&Parts, &NumParts, &FindPartRank](const int32 Index)
+	{
+		return Index + 3 < NumParts ? FindPartRank(Parts[Index].Start, Parts[Index + 3].Start) : MAX_int32;
+	};
+
+	while (MinRank != MAX_int32)
+	{
+		if (MinIndex > 0)
+		{
+			Parts[MinIndex - 1].Rank = GetMergedRank(MinIndex - 1);
+		}
+
+		Parts[MinIndex].Rank = GetMergedRank(MinIndex);
+
+		FMemory::Memmove(&Parts[MinIndex + 1], &Parts[MinIndex + 2], (NumParts - MinIndex - 2) * sizeof(FPart));
+		--NumParts;
+
+		MinRank = MAX_int32;
+		for (int32 Index = 0; Index < NumParts - 1; ++Index)
+		{
+			if (Parts[Index].Rank < MinRank)
+			{
+				MinRank = Parts[Index].Rank;
+				MinIndex = Index;
+			}
+		}
+	}
+
+	if (OutTokens)
+	{
+		for (int32 Index = 0; Index < NumParts - 1; ++Index)
+		{
+			if (const int32 Rank = FindRank(Bytes + Parts[Index].Start, Parts[Index + 1].Start - Parts[Index].Start); Rank != INDEX_NONE)
+			{
+				OutTokens->Add(Rank);
+			}
+		}
+	}
+
+	return NumParts - 1;
+}
+
+void FHttpGPTTokenizer::Encode(const FString& Text, TArray<int32>& OutTokens) const
+{
+	const FTCHARToUTF8 TextUTF8(*Text, Text.Len());
+
+	OutTokens.Reset(TextUTF8.Length() / 4);
+
+	Split(reinterpret_cast<const uint8*>(TextUTF8.Get()), TextUTF8.Length(), [this, &OutTokens](const uint8* const Piece, const int32 PieceLength)
+	{
+		EncodePiece(Piece, PieceLength, &OutTokens);
+	});
+}
+
+int32 FHttpGPTTokenizer::Count(const FString& Text) const
+{
+	const FTCHARToUTF8 TextUTF8(*Text, Text.Len());
+
+	int32 Output = 0;
+	Split(reinterpret_cast<const uint8*>(TextUTF8.Get()), TextUTF8.Length(), [this, &Output](const uint8* const Piece, const int32 PieceLength)
+	{
+		Output += EncodePiece(Piece, PieceLength, nullptr);
+	});
+
+	return Output;
+}
+
+FString FHttpGPTTokenizer::Decode(const TArray<int32>& InTokens) const
+{
+	TArray<uint8> Bytes;
+
+	for (const int32 Token : InTokens)
+	{
+		if (Token >= 0 && Token < NumTokens)
+		{
+			Bytes.Append(TokenData + Tokens[Token].Offset, Tokens[Token].Length);
+		}
+	}
+
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+	return FString(Converted.Length(), Converted.Get());
+}
+
+FString FHttpGPTTokenizer::Truncate(const FString& Text, const int32 MaxTokens) const
+{
+	TArray<int32> TextTokens;
+	Encode(Text, TextTokens);
+
+	if (TextTokens.Num() <= MaxTokens)
+	{
+		return Text;
+	}
+
+	TArray<uint8> Bytes;
+	for (int32 Index = 0; Index < MaxTokens; ++Index)
+	{
+		Bytes.Append(TokenData + Tokens[TextTokens[Index]].Offset, Tokens[TextTokens[Index]].Length);
+	}
+
+	// A partial character would be decoded as a replacement character, which may need more tokens than the bytes it replaces
+	int32 Lead = Bytes.Num() - 1;
+	while (Lead > 0 && Bytes.Num() - Lead < 4 && (Bytes[Lead] & 0xC0) == 0x80)
+	{
+		--Lead;
+	}
+
+	if (Bytes.IsValidIndex(Lead) && Bytes[Lead] >= 0xC0)
+	{
+		const int32 CharSize = Bytes[Lead] >= 0xF0 ? 4 : Bytes[Lead] >= 0xE0 ? 3 : 2;
+		if (Lead + CharSize > Bytes.Num())
+		{
+			Bytes.SetNum(Lead);
+		}
+	}
+
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+	return FString(Converted.Length(), Converted.Get());
+}
+
+void FHttpGPTTokenizer::EncodeBatch(const TArray<FString>& Texts, TArray<TArray<int32>>& OutTokens) const
+{
+	int64 TotalLength = 0;
+	for (const FString& Text : Texts)
+	{
+		TotalLength += Text.Len();
+	}
+
+	OutTokens.SetNum(Texts.Num());
+
+	ParallelFor(Texts.Num(), [this, &Texts, &OutTokens](const int32 Index)
+	{
+		Encode(Texts[Index], OutTokens[Index]);
+	}, TotalLength < HttpGPT::Tokenizer::MinParallelBatchLength);
+}
+
+void FHttpGPTTokenizer::CountBatch(const TArray<FString>& Texts, TArray<int32>& OutCounts) const
+{
+	int64 TotalLength = 0;
+	for (const FString& Text : Texts)
+	{
+		TotalLength += Text.Len();
+	}
+
+	OutCounts.SetNumZeroed(Texts.Num());
+
+	ParallelFor(Texts.Num(), [this, &Texts, &OutCounts](const int32 Index)
+	{
+		OutCounts[Index] = Count(Texts[Index]);
+	}, TotalLength < HttpGPT::Tokenizer::MinParallelBatchLength);
+}
+
+int32 FHttpGPTTokenizer::CountMessage(const FHttpGPTChatMessage& Message) const
+{
+	// Chat models wrap each message in <|start|>{role}\n{content}<|end|>\n
+	constexpr int32 TokensPerMessage = 3;
+
+	int32 Output = TokensPerMessage + Count(UHttpGPTHelper::RoleToName(Message.Role).ToString()) + Count(Message.Content);
+
+	if (!Message.FunctionCall.Name.IsNone())
+	{
+		Output += Count(Message.FunctionCall.Name.ToString()) + Count(Message.FunctionCall.Arguments);
+	}
+
+	for (const FHttpGPTChatImage& Image : Message.Images)
+	{
+		Output += CountImage(Image);
+	}
+
+	return Output;
+}
+
+int32 FHttpGPTTokenizer::CountImage(const FHttpGPTChatImage& Image)
+{
+	// Low detail images use a fixed cost. High detail images are scaled to 768 pixels on their shortest side and add the cost of each 512 pixels tile:
+	// a square image takes 2x2 tiles. Auto can choose high detail, so it is estimated as high detail too
+	constexpr int32 BaseTokens = 85;
+	constexpr int32 TileTokens = 170;
+	constexpr int32 SquareTiles = 4;
+
+	switch (Image.Detail)
+	{
+	case EHttpGPTChatImageDetail::Low:
+		return BaseTokens;
+
+	default:
+		return BaseTokens + TileTokens * SquareTiles;
+	}
+}
+
+int32 FHttpGPTTokenizer::CountMessages(const TArray<FHttpGPTChatMessage>& Messages) const
+{
+	int32 Output = ReplyTokens;
+
+	for (const FHttpGPTChatMessage& Message : Messages)
+	{
+		Output += CountMessage(Message);
+	}
+
+	return Output;
+}
+
+EHttpGPTTokenEncoding FHttpGPTTokenizer::GetEncoding() const
+{
+	return Encoding;
+}
+
+int32 FHttpGPTTokenizer::GetVocabularySize() const
+{
+	return NumTokens;
+}
+
+#if !UE_BUILD_SHIPPING
+static void RunTokenizerBenchmark(const TArray<FString>& Args)
+{
+	const int32 SizeInMB = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 4;
+	const int32 Iterations = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 4;
+
+	// Words, numbers, punctuation and line breaks, to go through every rule of the patterns
+	static const TCHAR* const Words[] = {
+		TEXT("the"), TEXT("Unreal"), TEXT("Engine"), TEXT("blueprint"), TEXT("actor's"), TEXT("component"), TEXT("1024"), TEXT("3.14"),
+		TEXT("FHttpGPTTokenizer"), TEXT("::"), TEXT("(x, y)"), TEXT("se\u00F1al"), TEXT("\u00FCber"), TEXT("na\u00EFve"), TEXT("\n"), TEXT("  "), TEXT("{}"),
+		TEXT("antidisestablishmentarianism")
+	};
+
+	FRandomStream Random(SizeInMB);
+	FString Text;
+	Text.Reserve(SizeInMB * 1024 * 1024);
+
+	while (Text.Len() < SizeInMB * 1024 * 1024)
+	{
+		Text.Append(Words[Random.RandRange(0, UE_ARRAY_COUNT(Words) - 1)]);
+		Text.AppendChar(TEXT(' '));
+	}
+
+	for (const EHttpGPTTokenEncoding Encoding : {EHttpGPTTokenEncoding::cl100k_base, EHttpGPTTokenEncoding::p50k_base})
+	{
+		const FHttpGPTTokenizerPtr Tokenizer = FHttpGPTTokenizer::Get(Encoding);
+		if (!Tokenizer.IsValid())
+		{
+			continue;
+		}
+
+		TArray<int32> Tokens;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Tokenizer->Encode(Text, Tokens);
+		}
+		const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+		const bool bValid = Tokenizer->Decode(Tokens) == Text;
+		const double Throughput = static_cast<double>(FTCHARToUTF8(*Text, Text.Len()).Length()) * Iterations / (1024.0 * 1024.0) / FMath::Max(
+			ElapsedTime, 1.e-6);
+
+		UE_LOG(LogHttpGPT, Display, TEXT("%s: %s: %d tokens, %.2f ms per encode, %.1f MB/s%s"), *FString(__FUNCTION__),
+		       HttpGPT::Tokenizer::GetEncodingName(Encoding), Tokens.Num(), ElapsedTime * 1000.0 / Iterations, Throughput,
+		       bValid ? TEXT("") : TEXT(" (INVALID OUTPUT)"));
+	}
+}
+
+static FAutoConsoleCommand TokenizerBenchmarkCommand(TEXT("HttpGPT.Tokenizer.Benchmark"),
+                                                     TEXT("Measure the HttpGPT tokenizer throughput. Usage: HttpGPT.Tokenizer.Benchmark [SizeInMB] [Iterations]"),
+                                                     FConsoleCommandWithArgsDelegate::CreateStatic(&RunTokenizerBenchmark));
+#endif
+
+#if WITH_EDITOR
+static void CompileTokenizersForPackaging()
+{
+	for (const EHttpGPTTokenEncoding Encoding : {EHttpGPTTokenEncoding::cl100k_base, EHttpGPTTokenEncoding::p50k_base})
+	{
+		FHttpGPTTokenizer::CompileForPackaging(Encoding);
+	}
+}
+
+static FAutoConsoleCommand TokenizerCompileForPackagingCommand(TEXT("HttpGPT.Tokenizer.CompileForPackaging"),
+                                                               TEXT("Compile the HttpGPT tokenizer vocabularies next to their sources, to be packaged with the game"),
+                                                               FConsoleCommandDelegate::CreateStatic(&CompileTokenizersForPackaging));
+#endif
@@ -48,4 +48,19 @@ namespace HttpGPT::Internal
 	{
 		return HasEmptyParam(Arg1) || HasEmptyParam(std::forward<Args>(args)...);
 	}
+
+	/* FString map keys are compared ignoring case by default: use these for keys that must keep their exact text */
+	template <typename ValueType>
+	struct TCaseSensitiveKeyFuncs : TDefaultMapHashableKeyFuncs<FString, ValueType, false>
+	{
+		static FORCEINLINE bool Matches(const FString& A, const FString& B)
+		{
+			return A.Equals(B, ESearchCase::CaseSensitive);
+		}
+
+		static FORCEINLINE uint32 GetKeyHash(const FString& Key)
+		{
+			return FCrc::StrCrc32(*Key);
+		}
+	};
 }
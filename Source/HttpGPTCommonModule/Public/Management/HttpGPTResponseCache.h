@@ -0,0 +1,98 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Containers/List.h>
+
+struct HTTPGPTCOMMONMODULE_API FHttpGPTCachedProgress
+{
+	FHttpGPTCachedProgress() = default;
+
+	FHttpGPTCachedProgress(const double InTimeOffset, const int32 InContentLength) : TimeOffset(InTimeOffset), ContentLength(InContentLength)
+	{
+	}
+
+	/* Seconds elapsed since the request was sent */
+	double TimeOffset = 0.0;
+
+	/* Length of the content received until this progress update */
+	int32 ContentLength = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FHttpGPTCachedProgress& Progress)
+	{
+		return Ar << Progress.TimeOffset << Progress.ContentLength;
+	}
+};
+
+struct HTTPGPTCOMMONMODULE_API FHttpGPTCachedResponse
+{
+	FString Content;
+	TArray<FHttpGPTCachedProgress> Progress;
+
+	/* UTC time the response was received, to expire the responses shared between sessions */
+	FDateTime CachedTime = FDateTime::UtcNow();
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Content.GetAllocatedSize() + Progress.GetAllocatedSize();
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FHttpGPTCachedResponse& Response)
+	{
+		return Ar << Response.Content << Response.Progress << Response.CachedTime;
+	}
+};
+
+/**
+ *
+ */
+class HTTPGPTCOMMONMODULE_API FHttpGPTResponseCache
+{
+public:
+	static FHttpGPTResponseCache& Get();
+
+	~FHttpGPTResponseCache();
+
+	/* Key identifies the response in memory, SharedKey in the Derived Data Cache, where it is shared between machines using different credentials */
+	bool Find(const FString& Key, const FString& SharedKey, FHttpGPTCachedResponse& OutResponse);
+	void Add(const FString& Key, const FString& SharedKey, const FHttpGPTCachedResponse& Response);
+	void Empty();
+
+	SIZE_T GetCurrentSize() const;
+
+private:
+	using FKeyList = TDoubleLinkedList<FString>;
+
+	struct FEntry
+	{
+		FHttpGPTCachedResponse Response;
+		double ExpirationTime = 0.0;
+		SIZE_T Size = 0u;
+		FKeyList::TDoubleLinkedListNode* Node = nullptr;
+	};
+
+	bool FindInMemory(const FString& Key, FHttpGPTCachedResponse& OutResponse);
+	void AddToMemory(const FString& Key, const FHttpGPTCachedResponse& Response);
+	void RemoveEntry(const FString& Key);
+	void EvictUntil(const SIZE_T MaxSize);
+
+	static bool IsExpired(const FHttpGPTCachedResponse& Response);
+
+#if WITH_EDITOR
+	static FString GetDerivedDataKey(const FString& Key);
+	static bool FindInDerivedDataCache(const FString& Key, FHttpGPTCachedResponse& OutResponse);
+	static void AddToDerivedDataCache(const FString& Key, const FHttpGPTCachedResponse& Response);
+#endif
+
+	TMap<FString, FEntry> Entries;
+
+	/* Head is the most recently used key */
+	FKeyList UsageList;
+
+	SIZE_T CurrentSize = 0u;
+
+	mutable FCriticalSection Mutex;
+};
@@ -37,15 +37,69 @@ public:
 	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Editor | HttpGPT Chat", Meta = (DisplayName = "Use Custom System Context"))
 	bool bUseCustomSystemContext;
 
-	/* Custom system context to use in HttpGPT Chat Editor Tool */
+	/* Custom system context to use in HttpGPT Chat Editor Tool. Accepts the variables of the default one, like {Model} or {EngineVersion} */
 	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Editor | HttpGPT Chat",
 		Meta = (DisplayName = "Custom System Context", EditCondition = "bUseCustomSystemContext"))
 	FString CustomSystemContext;
 
+	/* Number of recent messages loaded when a session is opened in HttpGPT Chat Editor Tool. Earlier messages are loaded when scrolling up */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Editor | HttpGPT Chat", Meta = (DisplayName = "History Page Size", ClampMin = "1", UIMin = "1"))
+	int32 ChatHistoryPageSize;
+
+	/* Number of sessions kept open in HttpGPT Chat Editor Tool to switch between them instantly. Sessions with a running request are never closed */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Editor | HttpGPT Chat", Meta = (DisplayName = "Open Sessions", ClampMin = "1", UIMin = "1"))
+	int32 ChatOpenSessions;
+
+	/* Maximum number of requests running at the same time across all sessions of HttpGPT Chat Editor Tool. Other requests wait in a queue */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Editor | HttpGPT Chat", Meta = (DisplayName = "Concurrent Requests", ClampMin = "1", UIMin = "1"))
+	int32 ChatConcurrentRequests;
+
 	/* Directory to store images generated by HttpGPT Image Generator Editor Tool */
 	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Editor | HttpGPT Image Generator", Meta = (DisplayName = "Generated Images Directory"))
 	FString GeneratedImagesDir;
 
+	/* Maximum memory in megabytes used by full resolution textures in HttpGPT Image Generator Editor Tool. Least recently used images are replaced by thumbnails */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Editor | HttpGPT Image Generator",
+		Meta = (DisplayName = "Texture Memory Budget (MB)", ClampMin = "1", UIMin = "1"))
+	int32 ImageGenTextureBudget;
+
+	/* Size of the thumbnails displayed by HttpGPT Image Generator Editor Tool */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Editor | HttpGPT Image Generator",
+		Meta = (DisplayName = "Thumbnail Size", ClampMin = "16", UIMin = "16", ClampMax = "1024", UIMax = "1024"))
+	int32 ImageGenThumbnailSize;
+
+	/* Maximum size in megabytes of the in-memory response cache */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Cache", Meta = (DisplayName = "Response Cache Size (MB)", ClampMin = "0", UIMin = "0"))
+	int32 ResponseCacheSize;
+
+	/* Time in seconds that a cached response remains valid */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Cache", Meta = (DisplayName = "Response Cache Time to Live", ClampMin = "0", UIMin = "0", Units = "s"))
+	float ResponseCacheTTL;
+
+	/* Also store cached responses in the Derived Data Cache, sharing them through the local, shared and cloud DDC layers. Editor only */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Cache", Meta = (DisplayName = "Use Derived Data Cache"))
+	bool bUseDerivedDataCache;
+
+	/* Maximum number of images downloaded at the same time */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Image Pipeline", Meta = (DisplayName = "Concurrent Downloads", ClampMin = "1", UIMin = "1"))
+	int32 ImageFetchConcurrency;
+
+	/* Maximum number of images decoded at the same time in worker threads */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Image Pipeline", Meta = (DisplayName = "Concurrent Decodes", ClampMin = "1", UIMin = "1"))
+	int32 ImageDecodeConcurrency;
+
+	/* Maximum number of textures created in the game thread per frame */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Image Pipeline", Meta = (DisplayName = "Texture Uploads per Frame", ClampMin = "1", UIMin = "1"))
+	int32 ImageUploadsPerFrame;
+
+	/* Directory with the tokenizer vocabularies (cl100k_base.tiktoken, p50k_base.tiktoken) used to count tokens locally. Relative to the project content directory. To count tokens in packaged games, run HttpGPT.Tokenizer.CompileForPackaging and add this directory to Additional Non-Asset Directories To Copy (DirectoriesToAlwaysStageAsNonUFS) */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Tokenizer", Meta = (DisplayName = "Vocabularies Directory"))
+	FString TokenizersDir;
+
+	/* Prompt templates rendered by name with Format Named Prompt Template. Placeholders like {Name} are replaced by the values of the variables */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Prompt Templates", Meta = (DisplayName = "Prompt Templates", MultiLine = "true"))
+	TMap<FName, FString> PromptTemplates;
+
 	/* Will print extra internal informations in log */
 	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Logging", Meta = (DisplayName = "Enable Internal Logs"))
 	bool bEnableInternalLogs;
@@ -78,6 +78,33 @@ enum class EHttpGPTChatRole : uint8
 	Function
 };
 
+UENUM(BlueprintType, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Chat Image Detail"))
+enum class EHttpGPTChatImageDetail : uint8
+{
+	Auto,
+	Low,
+	High
+};
+
+USTRUCT(BlueprintType, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Chat Image"))
+struct HTTPGPTCOMMONMODULE_API FHttpGPTChatImage
+{
+	GENERATED_BODY()
+
+	FHttpGPTChatImage() = default;
+
+	FHttpGPTChatImage(const FString& InURL, const EHttpGPTChatImageDetail InDetail) : URL(InURL), Detail(InDetail)
+	{
+	}
+
+	/* Public image URL or base64 data URL */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat")
+	FString URL;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat")
+	EHttpGPTChatImageDetail Detail = EHttpGPTChatImageDetail::Auto;
+};
+
 USTRUCT(BlueprintType, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Chat Message"))
 struct HTTPGPTCOMMONMODULE_API FHttpGPTChatMessage
 {
@@ -100,9 +127,41 @@ struct HTTPGPTCOMMONMODULE_API FHttpGPTChatMessage
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat", Meta = (EditCondition = "Role == EHttpGPTChatRole::Function"))
 	FHttpGPTFunctionCall FunctionCall;
 
+	/* Image parts sent with the content. Requires a model with vision support */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat", Meta = (EditCondition = "Role == EHttpGPTChatRole::User"))
+	TArray<FHttpGPTChatImage> Images;
+
 	TSharedPtr<FJsonValue> GetMessage() const;
 };
 
+USTRUCT(BlueprintType, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Chat Conversation"))
+struct HTTPGPTCOMMONMODULE_API FHttpGPTChatConversation
+{
+	GENERATED_BODY()
+
+	FHttpGPTChatConversation() = default;
+
+	FHttpGPTChatConversation(const FName& InID, const TArray<FHttpGPTChatMessage>& InMessages) : ID(InID), Messages(InMessages)
+	{
+	}
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat")
+	FName ID = NAME_None;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat")
+	TArray<FHttpGPTChatMessage> Messages;
+};
+
+UENUM(BlueprintType, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Chat Compression"))
+enum class EHttpGPTChatCompression : uint8
+{
+	None,
+	Zlib,
+
+	/* Requires Unreal Engine 5, falls back to zlib in older versions */
+	Oodle
+};
+
 USTRUCT(BlueprintType, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Chat Choice"))
 struct HTTPGPTCOMMONMODULE_API FHttpGPTChatChoice
 {
@@ -181,6 +240,20 @@ enum class EHttpGPTChatModel : uint8
 	textdavinci003 UMETA(DisplayName = "text-davinci-003"),
 	textdavinci002 UMETA(DisplayName = "text-davinci-002"),
 	codedavinci002 UMETA(DisplayName = "code-davinci-002"),
+	gpt4vision UMETA(DisplayName = "gpt-4-vision-preview"),
+};
+
+UENUM(BlueprintType, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Chat Context Policy"))
+enum class EHttpGPTChatContextPolicy : uint8
+{
+	/* Send the messages as they are, even if they exceed the context window */
+	None,
+
+	/* Drop the oldest messages, keeping the system and function messages and the last message */
+	DropOldestMessages,
+
+	/* Shorten the longest messages, except the system and function messages */
+	TruncateLongestMessages
 };
 
 USTRUCT(BlueprintType, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Chat Options"))
@@ -225,6 +298,9 @@ struct HTTPGPTCOMMONMODULE_API FHttpGPTChatOptions
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat", Meta = (DisplayName = "Logit Bias"))
 	TMap<int32, float> LogitBias;
 
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat", Meta = (DisplayName = "Context Policy"))
+	EHttpGPTChatContextPolicy ContextPolicy;
+
 private:
 	void SetDefaults();
 };
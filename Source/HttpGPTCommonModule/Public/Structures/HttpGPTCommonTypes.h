@@ -47,6 +47,24 @@ struct HTTPGPTCOMMONMODULE_API FHttpGPTCommonOptions
 		Meta = (DisplayName = "Azure OpenAI API Version", EditCondition = "bIsAzureOpenAI"))
 	FString AzureOpenAIAPIVersion;
 
+	/* Attach this request to an identical in-flight request instead of sending a new one */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Common", Meta = (DisplayName = "Deduplicate Request"))
+	bool bDeduplicateRequest;
+
+	/* Allow deduplication of requests that can produce different results, such as chat requests with non-zero temperature */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Common",
+		Meta = (DisplayName = "Allow Non-Deterministic Deduplication", EditCondition = "bDeduplicateRequest"))
+	bool bAllowNonDeterministicDeduplication;
+
+	/* Store the response in the in-memory cache and answer identical requests from it */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Common", Meta = (DisplayName = "Cache Response"))
+	bool bCacheResponse;
+
+	/* Replay cached streamed responses with the timing of the original response */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Common",
+		Meta = (DisplayName = "Replay Cached Stream Timing", EditCondition = "bCacheResponse"))
+	bool bReplayCachedStreamTiming;
+
 private:
 	void SetDefaults();
 };
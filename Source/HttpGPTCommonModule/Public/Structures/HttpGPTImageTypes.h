@@ -35,11 +35,31 @@ struct HTTPGPTCOMMONMODULE_API FHttpGPTImageData
 	{
 	}
 
+	FHttpGPTImageData(const FString& Data, const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& DecodedData, const EHttpGPTResponseFormat& DataFormat) :
+		Content(Data), Format(DataFormat), DecodedContent(DecodedData)
+	{
+	}
+
+	FHttpGPTImageData(const TSharedPtr<TArray<ANSICHAR>, ESPMode::ThreadSafe>& EncodedData, const EHttpGPTResponseFormat& DataFormat) :
+		Format(DataFormat), EncodedContent(EncodedData)
+	{
+	}
+
+	/* Empty in the b64_json images of image requests, which keep the payload as single-byte text: Get Image Content returns it */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Image")
 	FString Content;
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Image")
 	EHttpGPTResponseFormat Format = EHttpGPTResponseFormat::b64_json;
+
+	/* b64_json payload copied from the response bytes by the image request instead of Content. Decoded by the image pipeline workers */
+	TSharedPtr<TArray<ANSICHAR>, ESPMode::ThreadSafe> EncodedContent;
+
+	/* Already decoded image, used instead of the encoded content */
+	TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> DecodedContent;
+
+	/* Content, built from the encoded or decoded image when only those are available */
+	FString GetContent() const;
 };
 
 USTRUCT(BlueprintType, Category = "HttpGPT | Image", Meta = (DisplayName = "HttpGPT Image Response"))
@@ -9,6 +9,7 @@
 #include <Kismet/BlueprintAsyncActionBase.h>
 #include <Kismet/BlueprintFunctionLibrary.h>
 #include "Structures/HttpGPTCommonTypes.h"
+#include "Management/HttpGPTResponseCache.h"
 #include "HttpGPTBaseTask.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FHttpGPTGenericDelegate);
@@ -48,10 +49,15 @@ protected:
 
 	virtual bool CanActivateTask() const;
 	virtual bool CanBindProgress() const;
+	virtual bool CanDeduplicateRequest() const;
+	virtual bool CanCacheResponse() const;
 	virtual FString GetEndpointURL() const;
 
 	void SendRequest();
 
+	/* Canonical hash of the endpoint and serialized request content, and of the credentials unless the key is shared between machines */
+	FString GetRequestKey(const FString& Content, const bool bIncludeCredentials) const;
+
 	/* Return true if contains error */
 	const bool CheckError(const TSharedPtr<class FJsonObject>& JsonObject, FHttpGPTCommonError& OutputError) const;
 
@@ -68,16 +74,37 @@ protected:
 	{
 	};
 
+	/* Bytes of the completed response, converted to text for OnProgressCompleted unless the task reads them directly */
+	virtual void OnResponseCompleted(const TArray<uint8>& Content, const bool bWasSuccessful);
+
 	bool bInitialized = false;
 	bool bIsReadyToDestroy = false;
 	bool bIsTaskActive = false;
 
+	FString RequestKey;
+	FString SharedRequestKey;
+	bool bIsSubscriber = false;
+
+	double RequestStartTime = 0.0;
+	TArray<FHttpGPTCachedProgress> RecordedProgress;
+
 #if WITH_EDITOR
 	bool bIsEditorTask = false;
 	bool bEndingPIE = false;
 
 	virtual void PrePIEEnded(bool bIsSimulating);
 #endif
+
+private:
+	void ReplayCachedResponse(const FHttpGPTCachedResponse& CachedResponse);
+
+	void ForwardProgressUpdated(const FString& Content, int32 BytesSent, int32 BytesReceived);
+	void ForwardProgressCompleted(const FString& Content, const bool bWasSuccessful);
+
+	/* Detach the subscribers of this request. They are released afterwards in the game thread, without holding the lock of this task */
+	TArray<TWeakObjectPtr<UHttpGPTBaseTask>> TakeSubscribers();
+	static void ReleaseSubscribers(const TArray<TWeakObjectPtr<UHttpGPTBaseTask>>& Subscribers, const FHttpResponsePtr& Response,
+	                               const bool bWasSuccessful, const bool bForwardResult);
 };
 
 UCLASS(NotPlaceable, Category = "HttpGPT")
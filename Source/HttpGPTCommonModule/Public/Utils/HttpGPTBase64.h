@@ -0,0 +1,24 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+/**
+ *
+ */
+class HTTPGPTCOMMONMODULE_API FHttpGPTBase64
+{
+public:
+	/* Decode base64 text using the widest vector instructions available (AVX2, SSSE3 or NEON) with a scalar fallback.
+	 * Whitespaces and JSON escape characters are skipped, padding is optional. */
+	static bool Decode(const ANSICHAR* const Source, const int64 Length, TArray<uint8>& OutData);
+	static bool Decode(const TCHAR* const Source, const int64 Length, TArray<uint8>& OutData);
+
+	static int64 GetMaxDecodedSize(const int64 EncodedLength);
+
+	/* Name of the decoding implementation selected for the current CPU */
+	static const TCHAR* GetImplementationName();
+};
@@ -0,0 +1,39 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include "Structures/HttpGPTChatTypes.h"
+#include "HttpGPTInternalFuncs.h"
+
+/**
+ *
+ */
+class HTTPGPTCOMMONMODULE_API FHttpGPTChatSerializer
+{
+public:
+	/* Binary form of the messages, with each distinct string stored once. The strings are written before the messages referencing them */
+	static void Serialize(FArchive& Ar, TArray<FHttpGPTChatMessage>& Messages);
+	static void Serialize(FArchive& Ar, TArray<FHttpGPTChatConversation>& Conversations);
+
+	/* Self-describing buffer, optionally compressed. Loading detects the compression used when saving */
+	static bool Save(const TArray<FHttpGPTChatConversation>& Conversations, const EHttpGPTChatCompression Compression, TArray<uint8>& OutData);
+	static bool Load(const TArray<uint8>& Data, TArray<FHttpGPTChatConversation>& OutConversations);
+
+private:
+	struct FStringTable
+	{
+		TArray<FString> Strings;
+		TMap<FString, int32, FDefaultSetAllocator, HttpGPT::Internal::TCaseSensitiveKeyFuncs<int32>> Indices;
+	};
+
+	static void SerializeWithStrings(FArchive& Ar, const TFunctionRef<void(FArchive&, FStringTable&)> SerializeReferences);
+
+	static void SerializeMessages(FArchive& Ar, TArray<FHttpGPTChatMessage>& Messages, FStringTable& Table);
+	static void SerializeString(FArchive& Ar, FString& Value, FStringTable& Table);
+	static void SerializeName(FArchive& Ar, FName& Value, FStringTable& Table);
+
+	static FName GetCompressionFormat(const EHttpGPTChatCompression Compression);
+};
@@ -37,6 +37,9 @@ public:
 	UFUNCTION(BlueprintPure, Category = "HttpGPT | Chat", meta = (DisplayName = "Convert Name to HttpGPT Param Type"))
 	static const EHttpGPTPropertyType NameToPropertyType(const FName Type);
 
+	UFUNCTION(BlueprintPure, Category = "HttpGPT | Chat", meta = (DisplayName = "Convert HttpGPT Image Detail to Name"))
+	static const FName ImageDetailToName(const EHttpGPTChatImageDetail Detail);
+
 	UFUNCTION(BlueprintPure, Category = "HttpGPT | Chat", meta = (DisplayName = "Get Available GPT Models"))
 	static const TArray<FName> GetAvailableGPTModels();
 
@@ -47,6 +50,26 @@ public:
 	UFUNCTION(BlueprintPure, Category = "HttpGPT | Chat", meta = (DisplayName = "Model Supports Chat"))
 	static const bool ModelSupportsChat(const EHttpGPTChatModel Model);
 
+	UFUNCTION(BlueprintPure, Category = "HttpGPT | Chat", meta = (DisplayName = "Model Supports Vision"))
+	static const bool ModelSupportsVision(const EHttpGPTChatModel Model);
+
+	UFUNCTION(BlueprintPure, Category = "HttpGPT | Chat", meta = (DisplayName = "Get Context Window for Model"))
+	static const int32 GetContextWindowForModel(const EHttpGPTChatModel Model);
+
+	/* Tokens of the text for the model, or -1 if the vocabulary of the model is not available */
+	UFUNCTION(BlueprintPure, Category = "HttpGPT | Chat", meta = (DisplayName = "Count Tokens"))
+	static const int32 CountTokens(const FString& Text, const EHttpGPTChatModel Model);
+
+	/* Tokens used by the messages in a chat request, or -1 if the vocabulary of the model is not available */
+	UFUNCTION(BlueprintPure, Category = "HttpGPT | Chat", meta = (DisplayName = "Count Message Tokens"))
+	static const int32 CountMessageTokens(const TArray<FHttpGPTChatMessage>& Messages, const EHttpGPTChatModel Model);
+
+	UFUNCTION(BlueprintPure, Category = "HttpGPT | Prompt", meta = (DisplayName = "Format Prompt Template"))
+	static const FString FormatPromptTemplate(const FString& Template, const TMap<FName, FString>& Variables);
+
+	UFUNCTION(BlueprintPure, Category = "HttpGPT | Prompt", meta = (DisplayName = "Format Named Prompt Template"))
+	static const FString FormatNamedPromptTemplate(const FName TemplateName, const TMap<FName, FString>& Variables);
+
 	UFUNCTION(BlueprintPure, Category = "HttpGPT | Image", meta = (DisplayName = "Convert HttpGPT Size to Name"))
 	static const FName SizeToName(const EHttpGPTImageSize Size);
 
@@ -0,0 +1,53 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+class IFileHandle;
+
+/**
+ *
+ */
+class HTTPGPTCOMMONMODULE_API FHttpGPTMultipartWriter
+{
+public:
+	/* Write a multipart/form-data body into the file, so it can be streamed by the HTTP request instead of being kept in memory */
+	explicit FHttpGPTMultipartWriter(const FString& InFilePath);
+	~FHttpGPTMultipartWriter();
+
+	bool IsValid() const;
+
+	void AddField(const FString& Name, const FString& Value);
+	void AddFile(const FString& Name, const FString& FileName, const FString& ContentType, const uint8* const Data, const int64 Size);
+
+	/* Copy the file content in chunks, without loading the whole file */
+	void AddFileFromDisk(const FString& Name, const FString& ContentType, const FString& SourcePath);
+
+	/* Write the closing boundary and close the file. Return false if any part failed to be written */
+	bool Finish();
+
+	/* Value of the Content-Type header, including the boundary */
+	FString GetContentType() const;
+
+	/* Text description of the written parts, without the file contents */
+	const FString& GetDescription() const;
+
+	static FString CreateTempFilePath();
+
+	/* Delete the temporary files left by requests that were cancelled while their body was still being streamed */
+	static void DeleteStaleTempFiles();
+
+private:
+	void BeginPart(const FString& Name, const FString& FileName, const FString& ContentType);
+	void Write(const FString& Text);
+	void Write(const uint8* const Data, const int64 Size);
+
+	TUniquePtr<IFileHandle> FileHandle;
+	FString Boundary;
+	FString Description;
+
+	bool bHasError = false;
+};
@@ -0,0 +1,67 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Templates/Function.h>
+
+using FHttpGPTPromptTemplateRef = TSharedRef<class FHttpGPTPromptTemplate, ESPMode::ThreadSafe>;
+
+/**
+ *
+ */
+class HTTPGPTCOMMONMODULE_API FHttpGPTPromptTemplate
+{
+public:
+	explicit FHttpGPTPromptTemplate(const FString& InText);
+
+	/* Compiled template of the text, shared by every caller using the same text */
+	static FHttpGPTPromptTemplateRef Find(const FString& Text);
+
+	/* Replace the {Name} placeholders with the values of the variables. Placeholders without a value are kept as they are */
+	FString Render(const TMap<FName, FString>& Values) const;
+
+	/* Same as above, with the values returned by the function. nullptr if the variable has no value */
+	FString Render(const TFunctionRef<const FString*(const FName&)> FindValue) const;
+
+	const FString& GetText() const;
+
+	/* Variables referenced by the placeholders, in the order they first appear */
+	const TArray<FName>& GetVariables() const;
+
+private:
+	struct FSegment
+	{
+		/* Characters of the text copied when the segment is literal, or the placeholder */
+		int32 Start = 0;
+		int32 Length = 0;
+
+		/* Variable replacing the segment, INDEX_NONE for literal text */
+		int32 Variable = INDEX_NONE;
+	};
+
+	struct FRendering
+	{
+		TArray<FString> Values;
+		FString Result;
+	};
+
+	void Parse();
+
+	FString Text;
+	TArray<FSegment> Segments;
+	TArray<FName> Variables;
+
+	/* Placeholder of each variable, used as its value when it has none */
+	TArray<FString> Placeholders;
+
+	/* Characters copied from the text when rendering */
+	int32 LiteralLength = 0;
+
+	/* Most recent results, by hash of the values used to render them */
+	mutable TMap<uint32, FRendering> Renderings;
+
+	mutable FCriticalSection Mutex;
+};
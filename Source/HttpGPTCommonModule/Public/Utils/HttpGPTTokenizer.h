@@ -0,0 +1,116 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include "Structures/HttpGPTChatTypes.h"
+
+enum class EHttpGPTTokenEncoding : uint8
+{
+	/* gpt-4 and gpt-3.5-turbo models */
+	cl100k_base,
+
+	/* text-davinci and code-davinci models */
+	p50k_base
+};
+
+using FHttpGPTTokenizerPtr = TSharedPtr<const class FHttpGPTTokenizer, ESPMode::ThreadSafe>;
+
+/**
+ *
+ */
+class HTTPGPTCOMMONMODULE_API FHttpGPTTokenizer
+{
+public:
+	~FHttpGPTTokenizer();
+
+	/* Tokenizer of the encoding used by the model, loading its vocabulary on first use. Null if the vocabulary is not available */
+	static FHttpGPTTokenizerPtr Get(const EHttpGPTChatModel Model);
+	static FHttpGPTTokenizerPtr Get(const EHttpGPTTokenEncoding Encoding);
+
+	static EHttpGPTTokenEncoding GetEncodingForModel(const EHttpGPTChatModel Model);
+
+	/* Vocabulary in the tiktoken format (base64 token and rank per line) read from the tokenizers directory of the settings */
+	static FString GetVocabularyPath(const EHttpGPTTokenEncoding Encoding);
+
+	/* Vocabulary compiled to the layout used in memory, mapped instead of parsed when it is loaded again */
+	static FString GetCompiledPath(const EHttpGPTTokenEncoding Encoding);
+
+	/* Vocabulary compiled next to its source for packaged games, which only stage the vocabularies directory as a non-asset directory */
+	static FString GetPackagedCompiledPath(const EHttpGPTTokenEncoding Encoding);
+
+#if WITH_EDITOR
+	/* Write the compiled vocabulary next to its source, to be packaged with the game. Also available as HttpGPT.Tokenizer.CompileForPackaging */
+	static bool CompileForPackaging(const EHttpGPTTokenEncoding Encoding);
+#endif
+
+	/* \p{L} and \p{N} of the encoding patterns are approximated with a hand-made table: text in scripts missing from it may split unlike tiktoken */
+	void Encode(const FString& Text, TArray<int32>& OutTokens) const;
+	int32 Count(const FString& Text) const;
+
+	/* Text of the tokens. Characters split between tokens that are not decoded together are replaced */
+	FString Decode(const TArray<int32>& Tokens) const;
+
+	/* Beginning of the text fitting in the number of tokens, without the character split by the last token */
+	FString Truncate(const FString& Text, const int32 MaxTokens) const;
+
+	/* Process each text in a worker thread when there is enough text to be worth it */
+	void EncodeBatch(const TArray<FString>& Texts, TArray<TArray<int32>>& OutTokens) const;
+	void CountBatch(const TArray<FString>& Texts, TArray<int32>& OutCounts) const;
+
+	/* Tokens used by the message in a chat request, including the formatting around it and its images */
+	int32 CountMessage(const FHttpGPTChatMessage& Message) const;
+
+	/* Estimated tokens of an image in a chat request. The size of the image is unknown, so high detail assumes a square image */
+	static int32 CountImage(const FHttpGPTChatImage& Image);
+
+	/* Tokens used by the messages in a chat request, including the priming of the reply */
+	int32 CountMessages(const TArray<FHttpGPTChatMessage>& Messages) const;
+
+	/* Tokens added to each chat request to prime the reply: <|start|>assistant<|message|> */
+	static constexpr int32 ReplyTokens = 3;
+
+	EHttpGPTTokenEncoding GetEncoding() const;
+	int32 GetVocabularySize() const;
+
+private:
+	struct FSlot;
+	struct FTokenBytes;
+
+	explicit FHttpGPTTokenizer(const EHttpGPTTokenEncoding InEncoding);
+
+	bool Load();
+	bool MapCompiled(const FString& CompiledPath, const int64 SourceSize, const int64 SourceTime);
+
+	static FString GetTokenizersDirectory();
+	static bool Compile(const FString& SourcePath, const FString& CompiledPath, const int64 SourceSize, const int64 SourceTime);
+
+	/* Calls the function with the bytes of each piece the text is split in before merging, following the pattern of the encoding */
+	template <typename FunctionType>
+	void Split(const uint8* const Text, const int32 Length, FunctionType&& Function) const;
+
+	int32 FindRank(const uint8* const Bytes, const int32 Length) const;
+
+	/* Merge the bytes of the piece by rank until no pair is in the vocabulary. Returns the number of tokens */
+	int32 EncodePiece(const uint8* const Bytes, const int32 Length, TArray<int32>* const OutTokens) const;
+
+	EHttpGPTTokenEncoding Encoding;
+
+	/* Compiled vocabulary mapped in memory, or loaded in LoadedData when mapping is not supported */
+	TUniquePtr<class IMappedFileHandle> MappedFile;
+	TUniquePtr<class IMappedFileRegion> MappedRegion;
+	TArray<uint8> LoadedData;
+
+	/* Open addressing table from the bytes of each token to its rank */
+	const FSlot* Slots = nullptr;
+	uint32 SlotMask = 0u;
+
+	/* Bytes of each token, by rank */
+	const FTokenBytes* Tokens = nullptr;
+	int32 NumTokens = 0;
+
+	const uint8* TokenData = nullptr;
+	uint32 TokenDataSize = 0u;
+};
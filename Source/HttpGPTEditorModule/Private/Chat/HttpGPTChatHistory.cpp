@@ -0,0 +1,435 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "HttpGPTChatHistory.h"
+#include "HttpGPTChatJournal.h"
+#include "HttpGPTChatSearchIndex.h"
+#include <Utils/HttpGPTHelper.h>
+#include <Dom/JsonObject.h>
+#include <Serialization/JsonReader.h>
+#include <Serialization/JsonSerializer.h>
+#include <Misc/FileHelper.h>
+#include <Algo/Reverse.h>
+
+// Superseded records allowed in the journal before it is compacted
+static constexpr int32 JournalCompactionSlack = 64;
+
+void FHttpGPTChatHistory::Open(const FString& InJournalPath, const int32 PageSize)
+{
+	Nodes.Empty();
+	Children.Empty();
+	Items.Empty();
+	PendingItems.Empty();
+	EarlierUpdates.Empty();
+	Head = INDEX_NONE;
+	FirstLoadedIndex = 0;
+	NumRecords = 0;
+
+	JournalPath = InJournalPath;
+
+	if (FHttpGPTChatJournalPage Page; FHttpGPTChatJournal::Get().LoadPage(JournalPath, INDEX_NONE, PageSize, Page))
+	{
+		FirstLoadedIndex = Page.FirstMessage;
+		NumRecords = Page.NumRecords;
+		EarlierUpdates = MoveTemp(Page.EarlierUpdates);
+
+		Nodes.Reserve(Page.Messages.Num());
+		for (int32 Index = 0; Index < Page.Messages.Num(); ++Index)
+		{
+			AddNode(Page.Messages[Index].Role, Page.Messages[Index].Content, Page.Parents[Index]);
+		}
+
+		Head = Page.Head != INDEX_NONE ? Page.Head : Num() - 1;
+
+		// The selected branch may end before the most recent messages
+		while (Head < FirstLoadedIndex && LoadEarlierNodes(PageSize) > 0)
+		{
+		}
+
+		UpdateBranch();
+		CompactIfNeeded();
+	}
+}
+
+bool FHttpGPTChatHistory::HasEarlierMessages() const
+{
+	return (Items.Num() > 0 ? Items[0]->Parent : Head) != INDEX_NONE;
+}
+
+int32 FHttpGPTChatHistory::LoadEarlierMessages(const int32 PageSize)
+{
+	const int32 PreviousNum = Items.Num();
+
+	// The earlier pages may only contain other branches
+	while (HasEarlierMessages() && LoadEarlierNodes(PageSize) > 0)
+	{
+		UpdateBranch();
+
+		if (Items.Num() > PreviousNum)
+		{
+			break;
+		}
+	}
+
+	return Items.Num() - PreviousNum;
+}
+
+int32 FHttpGPTChatHistory::LoadEarlierNodes(const int32 PageSize)
+{
+	FHttpGPTChatJournalPage Page;
+	if (FirstLoadedIndex <= 0 || !FHttpGPTChatJournal::Get().LoadPage(JournalPath, FirstLoadedIndex, PageSize, Page) || Page.Messages.Num() <= 0)
+	{
+		return 0;
+	}
+
+	TArray<FHttpGPTChatItemDataPtr> NewNodes;
+	NewNodes.Reserve(Page.Messages.Num());
+
+	for (int32 Index = 0; Index < Page.Messages.Num(); ++Index)
+	{
+		// Updates found in the pages loaded before are more recent than the ones in this page
+		FString Content;
+		if (!EarlierUpdates.RemoveAndCopyValue(Page.FirstMessage + Index, Content))
+		{
+			Content = Page.Messages[Index].Content;
+		}
+
+		const FHttpGPTChatItemDataPtr Node = NewNodes.Add_GetRef(MakeShared<FHttpGPTChatItemData>(Page.Messages[Index].Role, Content));
+		Node->Index = Page.FirstMessage + Index;
+		Node->Parent = Page.Parents[Index];
+	}
+
+	for (const TPair<int32, FString>& Update : Page.EarlierUpdates)
+	{
+		if (!EarlierUpdates.Contains(Update.Key))
+		{
+			EarlierUpdates.Add(Update.Key, Update.Value);
+		}
+	}
+
+	// Keep the alternatives in the order they were added: the earlier ones come before the ones already loaded
+	for (int32 Index = NewNodes.Num() - 1; Index >= 0; --Index)
+	{
+		Children.FindOrAdd(NewNodes[Index]->Parent).Insert(NewNodes[Index]->Index, 0);
+	}
+
+	Nodes.Insert(NewNodes, 0);
+	FirstLoadedIndex = Page.FirstMessage;
+
+	return NewNodes.Num();
+}
+
+void FHttpGPTChatHistory::LoadAllMessages()
+{
+	while (HasEarlierMessages() && LoadEarlierMessages(TNumericLimits<int32>::Max()) > 0)
+	{
+	}
+}
+
+void FHttpGPTChatHistory::MoveJournal(const FString& NewJournalPath)
+{
+	if (JournalPath.IsEmpty() || JournalPath == NewJournalPath)
+	{
+		return;
+	}
+
+	FHttpGPTChatJournal::Get().Move(JournalPath, NewJournalPath);
+	FHttpGPTChatSearchIndex::Get().RenameSession(GetSessionID(), *FPaths::GetBaseFilename(NewJournalPath));
+
+	JournalPath = NewJournalPath;
+}
+
+void FHttpGPTChatHistory::DeleteJournal()
+{
+	if (JournalPath.IsEmpty())
+	{
+		return;
+	}
+
+	FHttpGPTChatJournal::Get().Delete(JournalPath);
+	FHttpGPTChatSearchIndex::Get().RemoveSession(GetSessionID());
+
+	JournalPath.Empty();
+	NumRecords = 0;
+}
+
+FHttpGPTChatItemDataPtr FHttpGPTChatHistory::Add(const EHttpGPTChatRole Role, const FString& Content)
+{
+	const FHttpGPTChatItemDataPtr Item = AddNode(Role, Content, Head);
+
+	Head = Item->Index;
+	Items.Add(Item);
+
+	if (!JournalPath.IsEmpty())
+	{
+		FHttpGPTChatJournal::Get().AppendMessage(JournalPath, Role, Content, Item->Parent);
+		FHttpGPTChatSearchIndex::Get().UpdateMessage(GetSessionID(), Item->Index, Content);
+		++NumRecords;
+
+		CompactIfNeeded();
+	}
+
+	return Item;
+}
+
+FHttpGPTChatItemDataPtr FHttpGPTChatHistory::AddNode(const EHttpGPTChatRole Role, const FString& Content, const int32 Parent)
+{
+	const FHttpGPTChatItemDataPtr Node = MakeShared<FHttpGPTChatItemData>(Role, Content);
+	Node->Index = Num();
+	Node->Parent = Parent;
+
+	Nodes.Add(Node);
+	Children.FindOrAdd(Parent).Add(Node->Index);
+
+	return Node;
+}
+
+void FHttpGPTChatHistory::Update(const FHttpGPTChatItemDataPtr& Item, const FString& Content)
+{
+	const int32 PreviousLength = Item->Content.Len();
+	const bool bIsAppend = Content.Len() >= PreviousLength && FCString::Strncmp(*Content, *Item->Content, PreviousLength) == 0;
+
+	if (bIsAppend && Content.Len() == PreviousLength)
+	{
+		return;
+	}
+
+	Item->Content = Content;
+	Item->OnContentChanged.ExecuteIfBound(bIsAppend ? PreviousLength : INDEX_NONE);
+
+	PendingItems.AddUnique(Item);
+}
+
+void FHttpGPTChatHistory::Commit(const FHttpGPTChatItemDataPtr& Item)
+{
+	if (PendingItems.Remove(Item) <= 0 || JournalPath.IsEmpty() || GetMessage(Item->Index) != Item)
+	{
+		return;
+	}
+
+	FHttpGPTChatJournal::Get().SetMessage(JournalPath, Item->Index, Item->Content);
+	FHttpGPTChatSearchIndex::Get().UpdateMessage(GetSessionID(), Item->Index, Item->Content);
+	++NumRecords;
+
+	CompactIfNeeded();
+}
+
+void FHttpGPTChatHistory::CommitAll()
+{
+	for (const FHttpGPTChatItemDataPtr& Item : TArray<FHttpGPTChatItemDataPtr>(PendingItems))
+	{
+		Commit(Item);
+	}
+}
+
+void FHttpGPTChatHistory::Empty()
+{
+	Nodes.Empty();
+	Children.Empty();
+	Items.Empty();
+	PendingItems.Empty();
+	EarlierUpdates.Empty();
+	Head = INDEX_NONE;
+	FirstLoadedIndex = 0;
+
+	if (!JournalPath.IsEmpty())
+	{
+		FHttpGPTChatJournal::Get().Rewrite(JournalPath, TArray<FHttpGPTChatMessage>(), TArray<int32>(), INDEX_NONE);
+		FHttpGPTChatSearchIndex::Get().RemoveSession(GetSessionID());
+		NumRecords = 0;
+	}
+}
+
+void FHttpGPTChatHistory::SetHead(const int32 Index)
+{
+	check(Index == INDEX_NONE || GetMessage(Index).IsValid());
+
+	if (Head == Index)
+	{
+		return;
+	}
+
+	Head = Index;
+	UpdateBranch();
+
+	if (!JournalPath.IsEmpty())
+	{
+		FHttpGPTChatJournal::Get().SetHead(JournalPath, Head);
+		++NumRecords;
+
+		CompactIfNeeded();
+	}
+}
+
+void FHttpGPTChatHistory::SwitchBranch(const FHttpGPTChatItemDataPtr& Item, const int32 Direction)
+{
+	const TArray<int32>* const Alternatives = Children.Find(Item->Parent);
+	if (!Alternatives)
+	{
+		return;
+	}
+
+	if (const int32 Branch = Alternatives->Find(Item->Index); Branch != INDEX_NONE && Alternatives->IsValidIndex(Branch + Direction))
+	{
+		SetHead(FindLatestLeaf((*Alternatives)[Branch + Direction]));
+	}
+}
+
+void FHttpGPTChatHistory::GetBranches(const FHttpGPTChatItemDataPtr& Item, int32& OutBranch, int32& OutNumBranches) const
+{
+	OutBranch = 0;
+	OutNumBranches = 1;
+
+	// The alternatives of the first messages are only known once the whole session is loaded
+	if (const TArray<int32>* const Alternatives = Children.Find(Item->Parent))
+	{
+		OutBranch = FMath::Max(Alternatives->Find(Item->Index), 0);
+		OutNumBranches = FMath::Max(Alternatives->Num(), 1);
+	}
+}
+
+void FHttpGPTChatHistory::UpdateBranch()
+{
+	Items.Reset();
+
+	for (FHttpGPTChatItemDataPtr Node = GetMessage(Head); Node.IsValid(); Node = GetMessage(Node->Parent))
+	{
+		Items.Add(Node);
+	}
+
+	Algo::Reverse(Items);
+}
+
+int32 FHttpGPTChatHistory::FindLatestLeaf(const int32 Index) const
+{
+	int32 Leaf = Index;
+	for (const TArray<int32>* Next = Children.Find(Leaf); Next && Next->Num() > 0; Next = Children.Find(Leaf))
+	{
+		Leaf = Next->Last();
+	}
+
+	return Leaf;
+}
+
+void FHttpGPTChatHistory::CompactIfNeeded()
+{
+	// Compaction rewrites every message: it waits until the whole session is loaded
+	if (JournalPath.IsEmpty() || FirstLoadedIndex > 0 || NumRecords <= Nodes.Num() * 2 + JournalCompactionSlack)
+	{
+		return;
+	}
+
+	TArray<FHttpGPTChatMessage> Messages;
+	TArray<int32> Parents;
+	Messages.Reserve(Nodes.Num());
+	Parents.Reserve(Nodes.Num());
+
+	for (const FHttpGPTChatItemDataPtr& Node : Nodes)
+	{
+		Messages.Add(FHttpGPTChatMessage(Node->Role, Node->Content));
+		Parents.Add(Node->Parent);
+	}
+
+	FHttpGPTChatJournal::Get().Rewrite(JournalPath, Messages, Parents, Head);
+	NumRecords = Nodes.Num();
+}
+
+FHttpGPTChatItemDataPtr FHttpGPTChatHistory::LoadMessage(const int32 MessageIndex)
+{
+	if (MessageIndex < 0 || MessageIndex >= Num())
+	{
+		return nullptr;
+	}
+
+	if (MessageIndex < FirstLoadedIndex)
+	{
+		while (MessageIndex < FirstLoadedIndex && LoadEarlierNodes(FirstLoadedIndex - MessageIndex) > 0)
+		{
+		}
+
+		UpdateBranch();
+	}
+
+	const FHttpGPTChatItemDataPtr Item = GetMessage(MessageIndex);
+	if (Item.IsValid() && !Items.Contains(Item))
+	{
+		SetHead(FindLatestLeaf(MessageIndex));
+	}
+
+	return Item;
+}
+
+FHttpGPTChatItemDataPtr FHttpGPTChatHistory::GetMessage(const int32 MessageIndex) const
+{
+	return Nodes.IsValidIndex(MessageIndex - FirstLoadedIndex) ? Nodes[MessageIndex - FirstLoadedIndex] : nullptr;
+}
+
+FName FHttpGPTChatHistory::GetSessionID() const
+{
+	return *FPaths::GetBaseFilename(JournalPath);
+}
+
+int32 FHttpGPTChatHistory::Num() const
+{
+	return FirstLoadedIndex + Nodes.Num();
+}
+
+const TArray<FHttpGPTChatItemDataPtr>& FHttpGPTChatHistory::GetItems() const
+{
+	return Items;
+}
+
+TArray<FHttpGPTChatMessage> FHttpGPTChatHistory::GetMessages(const FString& SystemContext) const
+{
+	TArray<FHttpGPTChatMessage> Output;
+	Output.Reserve(Items.Num() + 1);
+	Output.Add(FHttpGPTChatMessage(EHttpGPTChatRole::System, SystemContext));
+
+	for (const FHttpGPTChatItemDataPtr& Item : Items)
+	{
+		Output.Add(FHttpGPTChatMessage(Item->Role, Item->Content));
+	}
+
+	return Output;
+}
+
+bool FHttpGPTChatHistory::LoadFromFile(const FString& Path, const FString& SystemContext)
+{
+	FString FileContent;
+	if (!FPaths::FileExists(Path) || !FFileHelper::LoadFileToString(FileContent, *Path))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> JsonParsed;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContent);
+	if (!FJsonSerializer::Deserialize(Reader, JsonParsed))
+	{
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>> SessionData = JsonParsed->GetArrayField(TEXT("Data"));
+	for (const TSharedPtr<FJsonValue>& Item : SessionData)
+	{
+		if (const TSharedPtr<FJsonObject> MessageItObj = Item->AsObject())
+		{
+			if (FString RoleString; MessageItObj->TryGetStringField(TEXT("role"), RoleString))
+			{
+				const EHttpGPTChatRole Role = UHttpGPTHelper::NameToRole(*RoleString);
+
+				if (FString Message; MessageItObj->TryGetStringField(TEXT("content"), Message))
+				{
+					if (Role == EHttpGPTChatRole::System && Message == SystemContext)
+					{
+						continue;
+					}
+
+					Add(Role, Message);
+				}
+			}
+		}
+	}
+
+	return true;
+}
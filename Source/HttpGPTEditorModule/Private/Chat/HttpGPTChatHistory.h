@@ -0,0 +1,136 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Structures/HttpGPTChatTypes.h>
+
+DECLARE_DELEGATE_OneParam(FHttpGPTChatItemContentChanged, const int32 /* AppendStart */);
+
+/**
+ *
+ */
+struct FHttpGPTChatItemData
+{
+	FHttpGPTChatItemData(const EHttpGPTChatRole InRole, const FString& InContent) : Role(InRole), Content(InContent)
+	{
+	}
+
+	EHttpGPTChatRole Role;
+	FString Content;
+
+	/* Position of the message in the session journal. Messages are never moved, so it also identifies the message */
+	int32 Index = INDEX_NONE;
+
+	/* Message this one follows, shared by the other branches starting after it. INDEX_NONE for the first messages */
+	int32 Parent = INDEX_NONE;
+
+	/* Executed when the content changes. Bound by the row displaying this message, if it is currently visible.
+	 * AppendStart is the index of the first new character if the previous content was kept, INDEX_NONE otherwise */
+	FHttpGPTChatItemContentChanged OnContentChanged;
+};
+
+using FHttpGPTChatItemDataPtr = TSharedPtr<FHttpGPTChatItemData>;
+
+/**
+ *
+ */
+class FHttpGPTChatHistory
+{
+public:
+	/* Load the most recent messages of the session journal and record the next changes in it */
+	void Open(const FString& InJournalPath, const int32 PageSize);
+
+	/* The selected branch starts before the first loaded message */
+	bool HasEarlierMessages() const;
+
+	/* Load the messages before the first loaded one. Returns the number of messages added at the beginning of the items */
+	int32 LoadEarlierMessages(const int32 PageSize);
+	void LoadAllMessages();
+
+	/* Move the session journal, keeping the queued writes in order */
+	void MoveJournal(const FString& NewJournalPath);
+	void DeleteJournal();
+
+	/* Add a message after the last one of the selected branch */
+	FHttpGPTChatItemDataPtr Add(const EHttpGPTChatRole Role, const FString& Content);
+
+	/* Replace the content of a message and notify the widget displaying it. The new content is journaled when the message is committed */
+	void Update(const FHttpGPTChatItemDataPtr& Item, const FString& Content);
+
+	void Commit(const FHttpGPTChatItemDataPtr& Item);
+	void CommitAll();
+
+	void Empty();
+
+	/* Select the branch ending at the message, so the next messages are added after it. INDEX_NONE starts a new branch from the beginning */
+	void SetHead(const int32 Index);
+
+	/* Select the most recent branch going through the next or previous alternative of the message */
+	void SwitchBranch(const FHttpGPTChatItemDataPtr& Item, const int32 Direction);
+
+	/* Position of the message among the alternatives following the same message */
+	void GetBranches(const FHttpGPTChatItemDataPtr& Item, int32& OutBranch, int32& OutNumBranches) const;
+
+	/* Message at the given index of the session, loading it and selecting its branch if needed */
+	FHttpGPTChatItemDataPtr LoadMessage(const int32 MessageIndex);
+
+	/* Loaded message at the given index of the session */
+	FHttpGPTChatItemDataPtr GetMessage(const int32 MessageIndex) const;
+
+	/* Messages in the session, in every branch, including the ones not loaded yet */
+	int32 Num() const;
+
+	/* Source of the widgets displaying the conversation. Only contains the loaded messages of the selected branch */
+	const TArray<FHttpGPTChatItemDataPtr>& GetItems() const;
+
+	/* Loaded messages of the selected branch to be sent in a request, preceded by the system context */
+	TArray<FHttpGPTChatMessage> GetMessages(const FString& SystemContext) const;
+
+	/* Add the messages of a session saved before the journal. Messages equal to the system context are skipped, as it is added again when sending */
+	bool LoadFromFile(const FString& Path, const FString& SystemContext);
+
+private:
+	FHttpGPTChatItemDataPtr AddNode(const EHttpGPTChatRole Role, const FString& Content, const int32 Parent);
+
+	/* Load the page before the first loaded message. Returns the number of loaded messages */
+	int32 LoadEarlierNodes(const int32 PageSize);
+
+	/* Follow the parents of the head until the first loaded message of the branch */
+	void UpdateBranch();
+
+	/* Last message of the most recent branch going through the message */
+	int32 FindLatestLeaf(const int32 Index) const;
+
+	void CompactIfNeeded();
+
+	FName GetSessionID() const;
+
+	/* Every loaded message, in the order they were added, shared by the branches going through them */
+	TArray<FHttpGPTChatItemDataPtr> Nodes;
+
+	/* Messages following each loaded message, in the order they were added */
+	TMap<int32, TArray<int32>> Children;
+
+	/* Loaded messages of the selected branch */
+	TArray<FHttpGPTChatItemDataPtr> Items;
+
+	/* Last message of the selected branch */
+	int32 Head = INDEX_NONE;
+
+	/* Index of the first loaded message in the session */
+	int32 FirstLoadedIndex = 0;
+
+	/* Journaled updates of messages not loaded yet */
+	TMap<int32, FString> EarlierUpdates;
+
+	/* Messages updated since they were last journaled */
+	TArray<FHttpGPTChatItemDataPtr> PendingItems;
+
+	FString JournalPath;
+
+	/* Records in the journal, including the ones superseded by later updates */
+	int32 NumRecords = 0;
+};
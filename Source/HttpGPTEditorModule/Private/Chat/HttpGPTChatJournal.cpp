@@ -0,0 +1,715 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "HttpGPTChatJournal.h"
+#include <Utils/HttpGPTHelper.h>
+#include <LogHttpGPT.h>
+#include <Async/Async.h>
+#include <Dom/JsonObject.h>
+#include <Serialization/JsonWriter.h>
+#include <Serialization/JsonReader.h>
+#include <Serialization/JsonSerializer.h>
+#include <Policies/CondensedJsonPrintPolicy.h>
+#include <Misc/FileHelper.h>
+#include <HAL/FileManager.h>
+#include <HAL/PlatformFileManager.h>
+
+// Records are written by this class only, so a message record always starts with its operation
+static constexpr ANSICHAR AddRecordPrefix[] = "{\"op\":\"add\"";
+
+static constexpr const TCHAR* JournalExtension = TEXT(".jsonl");
+
+FHttpGPTChatJournal& FHttpGPTChatJournal::Get()
+{
+	static FHttpGPTChatJournal Instance;
+	return Instance;
+}
+
+FHttpGPTChatJournal::~FHttpGPTChatJournal()
+{
+	// The editor module flushes the journal at shutdown: the thread pool may no longer exist during static destruction
+	FScopeLock Lock(&Mutex);
+	if (bIsWriting || PendingOperations.Num() > 0)
+	{
+		UE_LOG(LogHttpGPT, Warning, TEXT("%s: Chat journal destroyed with %d pending operation(s)"), *FString(__FUNCTION__), PendingOperations.Num());
+	}
+}
+
+FString FHttpGPTChatJournal::GetSessionsPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HttpGPT"));
+}
+
+FString FHttpGPTChatJournal::GetJournalPath(const FName& SessionID)
+{
+	return FPaths::Combine(GetSessionsPath(), SessionID.ToString() + JournalExtension);
+}
+
+FString FHttpGPTChatJournal::GetLegacyPath(const FName& SessionID)
+{
+	return FPaths::Combine(GetSessionsPath(), SessionID.ToString() + TEXT(".json"));
+}
+
+FString FHttpGPTChatJournal::GetIndexPath()
+{
+	return FPaths::Combine(GetSessionsPath(), TEXT("Sessions.idx"));
+}
+
+FString FHttpGPTChatJournal::GetSessionName(const FString& Path)
+{
+	return FPaths::GetBaseFilename(Path);
+}
+
+TSharedRef<FJsonObject> FHttpGPTChatJournal::CreateMessageRecord(const EHttpGPTChatRole Role, const FString& Content, const int32 Parent)
+{
+	const TSharedRef<FJsonObject> Record = MakeShared<FJsonObject>();
+	Record->SetStringField("op", "add");
+	Record->SetNumberField("parent", Parent);
+	Record->SetStringField("role", UHttpGPTHelper::RoleToName(Role).ToString().ToLower());
+	Record->SetStringField("content", Content);
+
+	return Record;
+}
+
+void FHttpGPTChatJournal::AppendMessage(const FString& Path, const EHttpGPTChatRole Role, const FString& Content, const int32 Parent)
+{
+	Enqueue(FOperation{EOperation::Append, Path, {SerializeRecord(CreateMessageRecord(Role, Content, Parent))}});
+}
+
+void FHttpGPTChatJournal::SetMessage(const FString& Path, const int32 Index, const FString& Content)
+{
+	const TSharedRef<FJsonObject> Record = MakeShared<FJsonObject>();
+	Record->SetStringField("op", "set");
+	Record->SetNumberField("index", Index);
+	Record->SetStringField("content", Content);
+
+	Enqueue(FOperation{EOperation::Append, Path, {SerializeRecord(Record)}});
+}
+
+TSharedRef<FJsonObject> FHttpGPTChatJournal::CreateHeadRecord(const int32 Index)
+{
+	const TSharedRef<FJsonObject> Record = MakeShared<FJsonObject>();
+	Record->SetStringField("op", "head");
+	Record->SetNumberField("index", Index);
+
+	return Record;
+}
+
+void FHttpGPTChatJournal::SetHead(const FString& Path, const int32 Index)
+{
+	Enqueue(FOperation{EOperation::Append, Path, {SerializeRecord(CreateHeadRecord(Index))}});
+}
+
+void FHttpGPTChatJournal::Rewrite(const FString& Path, const TArray<FHttpGPTChatMessage>& Messages, const TArray<int32>& Parents, const int32 Head)
+{
+	check(Messages.Num() == Parents.Num());
+
+	FOperation Operation{EOperation::Rewrite, Path, {}};
+	Operation.Records.Reserve(Messages.Num() + 1);
+
+	for (int32 Index = 0; Index < Messages.Num(); ++Index)
+	{
+		Operation.Records.Add(SerializeRecord(CreateMessageRecord(Messages[Index].Role, Messages[Index].Content, Parents[Index])));
+	}
+
+	// The branch is only recorded if it doesn't end at the last message
+	if (Head != INDEX_NONE && Head != Messages.Num() - 1)
+	{
+		Operation.Records.Add(SerializeRecord(CreateHeadRecord(Head)));
+	}
+
+	Enqueue(MoveTemp(Operation));
+}
+
+void FHttpGPTChatJournal::Move(const FString& Path, const FString& NewPath)
+{
+	Enqueue(FOperation{EOperation::Move, Path, {NewPath}});
+}
+
+void FHttpGPTChatJournal::Delete(const FString& Path)
+{
+	Enqueue(FOperation{EOperation::Delete, Path, {}});
+}
+
+TArray<FHttpGPTChatSessionInfo> FHttpGPTChatJournal::GetSessions()
+{
+	FScopeLock Lock(&IndexMutex);
+	LoadIndex();
+
+	TArray<FHttpGPTChatSessionInfo> Output;
+	Output.Reserve(Sessions.Num());
+
+	for (const TPair<FString, FSessionEntry>& Session : Sessions)
+	{
+		FHttpGPTChatSessionInfo Info;
+		Info.Name = *Session.Key;
+		Info.NumMessages = Session.Value.NumMessages;
+		Info.Size = Session.Value.Size;
+		Info.LastModified = Session.Value.LastModified;
+
+		Output.Add(MoveTemp(Info));
+	}
+
+	return Output;
+}
+
+bool FHttpGPTChatJournal::LoadPage(const FString& Path, const int32 EndMessage, const int32 MaxMessages, FHttpGPTChatJournalPage& OutPage)
+{
+	Flush();
+
+	FSessionEntry Entry;
+	{
+		FScopeLock Lock(&IndexMutex);
+		LoadIndex();
+
+		const FSessionEntry* const FoundEntry = FindValidEntry(Path);
+		if (!FoundEntry)
+		{
+			return false;
+		}
+
+		Entry = *FoundEntry;
+	}
+
+	const int32 LastMessage = EndMessage == INDEX_NONE ? Entry.NumMessages : FMath::Clamp(EndMessage, 0, Entry.NumMessages);
+	const int32 FirstCheckpoint = FMath::Max(LastMessage - FMath::Max(MaxMessages, 1), 0) / CheckpointInterval;
+	const bool bEndsAtCheckpoint = LastMessage % CheckpointInterval == 0 && Entry.Checkpoints.IsValidIndex(LastMessage / CheckpointInterval);
+
+	OutPage.FirstMessage = FirstCheckpoint * CheckpointInterval;
+	OutPage.NumRecords = Entry.NumRecords;
+
+	const int64 StartOffset = Entry.Checkpoints.IsValidIndex(FirstCheckpoint) ? Entry.Checkpoints[FirstCheckpoint] : Entry.Size;
+	const int64 EndOffset = bEndsAtCheckpoint ? Entry.Checkpoints[LastMessage / CheckpointInterval] : Entry.Size;
+
+	if (EndOffset <= StartOffset)
+	{
+		return true;
+	}
+
+	// Only the bytes of the requested page are read
+	TArray<uint8> Bytes;
+	Bytes.SetNumUninitialized(static_cast<int32>(EndOffset - StartOffset));
+	{
+		const TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+		if (!Handle.IsValid() || !Handle->Seek(StartOffset) || !Handle->Read(Bytes.GetData(), Bytes.Num()))
+		{
+			UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to read %s"), *FString(__FUNCTION__), *Path);
+			return false;
+		}
+	}
+
+	const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+	const FString Content(Converter.Length(), Converter.Get());
+
+	TArray<FString> Lines;
+	Content.ParseIntoArrayLines(Lines);
+
+	for (const FString& Line : Lines)
+	{
+		TSharedPtr<FJsonObject> Record;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Line), Record) || !Record.IsValid())
+		{
+			UE_LOG(LogHttpGPT_Internal, Warning, TEXT("%s: Ignoring invalid record in %s"), *FString(__FUNCTION__), *Path);
+			continue;
+		}
+
+		FString Operation;
+		if (!Record->TryGetStringField(TEXT("op"), Operation))
+		{
+			continue;
+		}
+
+		if (Operation.Equals(TEXT("head")))
+		{
+			Record->TryGetNumberField(TEXT("index"), OutPage.Head);
+			continue;
+		}
+
+		FString MessageContent;
+		if (!Record->TryGetStringField(TEXT("content"), MessageContent))
+		{
+			continue;
+		}
+
+		if (Operation.Equals(TEXT("add")))
+		{
+			const int32 Index = OutPage.FirstMessage + OutPage.Messages.Num();
+			if (Index >= LastMessage)
+			{
+				break;
+			}
+
+			if (FString RoleString; Record->TryGetStringField(TEXT("role"), RoleString))
+			{
+				// Messages journaled before the branches follow the previous message
+				int32 Parent = Index - 1;
+				Record->TryGetNumberField(TEXT("parent"), Parent);
+
+				OutPage.Messages.Add(FHttpGPTChatMessage(UHttpGPTHelper::NameToRole(*RoleString), MessageContent));
+				OutPage.Parents.Add(Parent);
+
+				// Adding a message selects its branch
+				OutPage.Head = INDEX_NONE;
+			}
+		}
+		else if (Operation.Equals(TEXT("set")))
+		{
+			if (int32 Index; Record->TryGetNumberField(TEXT("index"), Index))
+			{
+				if (Index < OutPage.FirstMessage)
+				{
+					OutPage.EarlierUpdates.Add(Index, MessageContent);
+				}
+				else if (OutPage.Messages.IsValidIndex(Index - OutPage.FirstMessage))
+				{
+					OutPage.Messages[Index - OutPage.FirstMessage].Content = MessageContent;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void FHttpGPTChatJournal::Flush()
+{
+	while (true)
+	{
+		{
+			FScopeLock Lock(&Mutex);
+			if (!bIsWriting)
+			{
+				return;
+			}
+		}
+
+		FPlatformProcess::Sleep(0.001f);
+	}
+}
+
+void FHttpGPTChatJournal::Enqueue(FOperation&& Operation)
+{
+	FScopeLock Lock(&Mutex);
+	PendingOperations.Add(MoveTemp(Operation));
+
+	if (bIsWriting)
+	{
+		return;
+	}
+
+	bIsWriting = true;
+	Async(EAsyncExecution::ThreadPool, [this]
+	{
+		ProcessQueue();
+	});
+}
+
+void FHttpGPTChatJournal::ProcessQueue()
+{
+	while (true)
+	{
+		TArray<FOperation> Operations;
+		{
+			FScopeLock Lock(&Mutex);
+			Operations = MoveTemp(PendingOperations);
+			PendingOperations.Reset();
+		}
+
+		if (Operations.Num() <= 0)
+		{
+			// The index is saved once the queue is drained, not after every record
+			SaveIndex();
+
+			FScopeLock Lock(&Mutex);
+			if (PendingOperations.Num() <= 0)
+			{
+				bIsWriting = false;
+				return;
+			}
+
+			continue;
+		}
+
+		for (int32 Index = 0; Index < Operations.Num(); ++Index)
+		{
+			switch (Operations[Index].Type)
+			{
+				case EOperation::Append:
+				{
+					// Consecutive records of the same session are written at once
+					const int32 FirstIndex = Index;
+					while (Operations.IsValidIndex(Index + 1) && Operations[Index + 1].Type == EOperation::Append && Operations[Index + 1].Path == Operations[
+						FirstIndex].Path)
+					{
+						++Index;
+					}
+
+					ExecuteAppend(Operations, FirstIndex, Index);
+					break;
+				}
+
+				case EOperation::Rewrite:
+					ExecuteRewrite(Operations[Index]);
+					break;
+
+				case EOperation::Move:
+					ExecuteMove(Operations[Index]);
+					break;
+
+				case EOperation::Delete:
+					ExecuteDelete(Operations[Index]);
+					break;
+
+				default:
+					break;
+			}
+		}
+	}
+}
+
+void FHttpGPTChatJournal::ExecuteAppend(const TArray<FOperation>& Operations, const int32 FirstIndex, const int32 LastIndex)
+{
+	const FString& Path = Operations[FirstIndex].Path;
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	FSessionEntry Entry;
+	{
+		FScopeLock Lock(&IndexMutex);
+		LoadIndex();
+
+		if (const FSessionEntry* const FoundEntry = FindValidEntry(Path))
+		{
+			Entry = *FoundEntry;
+		}
+	}
+
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+
+	const TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*Path, true));
+	if (!Handle.IsValid())
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to append to %s"), *FString(__FUNCTION__), *Path);
+		return;
+	}
+
+	// Terminate a record interrupted by a crash, so it doesn't corrupt the next one
+	if (Entry.bIsIncomplete)
+	{
+		Handle->Write(reinterpret_cast<const uint8*>("\n"), 1);
+		Entry.bIsIncomplete = false;
+	}
+
+	for (int32 Index = FirstIndex; Index <= LastIndex; ++Index)
+	{
+		for (const FString& Record : Operations[Index].Records)
+		{
+			WriteRecord(*Handle, Record, Entry);
+		}
+	}
+
+	Handle->Flush();
+	Entry.Size = Handle->Tell();
+	Entry.LastModified = FDateTime::UtcNow();
+
+	FScopeLock Lock(&IndexMutex);
+	Sessions.Add(GetSessionName(Path), MoveTemp(Entry));
+	bIndexDirty = true;
+}
+
+void FHttpGPTChatJournal::ExecuteRewrite(const FOperation& Operation)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Operation.Path));
+
+	// Write the new journal aside: the previous one stays valid until the new one is complete
+	const FString TempPath = Operation.Path + TEXT(".tmp");
+
+	FSessionEntry Entry;
+	{
+		const TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*TempPath));
+		if (!Handle.IsValid())
+		{
+			UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to rewrite %s"), *FString(__FUNCTION__), *Operation.Path);
+			return;
+		}
+
+		for (const FString& Record : Operation.Records)
+		{
+			WriteRecord(*Handle, Record, Entry);
+		}
+
+		Handle->Flush();
+		Entry.Size = Handle->Tell();
+	}
+
+	if (!IFileManager::Get().Move(*Operation.Path, *TempPath, true, true))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to replace %s"), *FString(__FUNCTION__), *Operation.Path);
+		return;
+	}
+
+	Entry.LastModified = FDateTime::UtcNow();
+
+	FScopeLock Lock(&IndexMutex);
+	LoadIndex();
+
+	Sessions.Add(GetSessionName(Operation.Path), MoveTemp(Entry));
+	bIndexDirty = true;
+}
+
+void FHttpGPTChatJournal::ExecuteMove(const FOperation& Operation)
+{
+	const FString& NewPath = Operation.Records[0];
+
+	if (FPaths::FileExists(Operation.Path) && !IFileManager::Get().Move(*NewPath, *Operation.Path, true, true))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to move %s to %s"), *FString(__FUNCTION__), *Operation.Path, *NewPath);
+		return;
+	}
+
+	FScopeLock Lock(&IndexMutex);
+	LoadIndex();
+
+	if (FSessionEntry Entry; Sessions.RemoveAndCopyValue(GetSessionName(Operation.Path), Entry))
+	{
+		Sessions.Add(GetSessionName(NewPath), MoveTemp(Entry));
+		bIndexDirty = true;
+	}
+}
+
+void FHttpGPTChatJournal::ExecuteDelete(const FOperation& Operation)
+{
+	IFileManager::Get().Delete(*Operation.Path, false, true, true);
+
+	// Legacy session files share the name of the journals converted from them
+	if (!Operation.Path.EndsWith(JournalExtension))
+	{
+		return;
+	}
+
+	FScopeLock Lock(&IndexMutex);
+	LoadIndex();
+
+	if (Sessions.Remove(GetSessionName(Operation.Path)) > 0)
+	{
+		bIndexDirty = true;
+	}
+}
+
+void FHttpGPTChatJournal::WriteRecord(IFileHandle& Handle, const FString& Record, FSessionEntry& Entry)
+{
+	if (Record.StartsWith(ANSI_TO_TCHAR(AddRecordPrefix), ESearchCase::CaseSensitive))
+	{
+		if (Entry.NumMessages % CheckpointInterval == 0)
+		{
+			Entry.Checkpoints.Add(Handle.Tell());
+		}
+
+		++Entry.NumMessages;
+	}
+
+	++Entry.NumRecords;
+
+	const FTCHARToUTF8 Converter(*Record);
+	Handle.Write(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+}
+
+bool FHttpGPTChatJournal::ScanJournal(const FString& Path, FSessionEntry& OutEntry)
+{
+	OutEntry = FSessionEntry();
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	constexpr int32 PrefixLength = UE_ARRAY_COUNT(AddRecordPrefix) - 1;
+
+	int32 LineStart = 0;
+	for (int32 Index = 0; Index < Bytes.Num(); ++Index)
+	{
+		if (Bytes[Index] != '\n')
+		{
+			continue;
+		}
+
+		if (Index > LineStart)
+		{
+			if (Index - LineStart >= PrefixLength && FMemory::Memcmp(Bytes.GetData() + LineStart, AddRecordPrefix, PrefixLength) == 0)
+			{
+				if (OutEntry.NumMessages % CheckpointInterval == 0)
+				{
+					OutEntry.Checkpoints.Add(LineStart);
+				}
+
+				++OutEntry.NumMessages;
+			}
+
+			++OutEntry.NumRecords;
+		}
+
+		LineStart = Index + 1;
+	}
+
+	OutEntry.Size = Bytes.Num();
+	OutEntry.bIsIncomplete = LineStart < Bytes.Num();
+	OutEntry.LastModified = IFileManager::Get().GetTimeStamp(*Path);
+
+	return true;
+}
+
+FHttpGPTChatJournal::FSessionEntry* FHttpGPTChatJournal::FindValidEntry(const FString& Path)
+{
+	const FString SessionName = GetSessionName(Path);
+	const int64 FileSize = IFileManager::Get().FileSize(*Path);
+
+	FSessionEntry* Entry = Sessions.Find(SessionName);
+	if (FileSize < 0)
+	{
+		return Entry;
+	}
+
+	if (!Entry || Entry->Size != FileSize)
+	{
+		UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Rebuilding the index of %s"), *FString(__FUNCTION__), *Path);
+
+		FSessionEntry NewEntry;
+		if (!ScanJournal(Path, NewEntry))
+		{
+			return Entry;
+		}
+
+		Entry = &Sessions.Add(SessionName, MoveTemp(NewEntry));
+		bIndexDirty = true;
+	}
+
+	return Entry;
+}
+
+void FHttpGPTChatJournal::LoadIndex()
+{
+	if (bIndexLoaded)
+	{
+		return;
+	}
+
+	bIndexLoaded = true;
+
+	FString FileContent;
+	TSharedPtr<FJsonObject> JsonParsed;
+
+	if (FFileHelper::LoadFileToString(FileContent, *GetIndexPath()) && FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(FileContent), JsonParsed) &&
+		JsonParsed.IsValid())
+	{
+		for (const TSharedPtr<FJsonValue>& Item : JsonParsed->GetArrayField(TEXT("Sessions")))
+		{
+			const TSharedPtr<FJsonObject> SessionObj = Item->AsObject();
+			if (!SessionObj.IsValid())
+			{
+				continue;
+			}
+
+			FSessionEntry Entry;
+			Entry.NumMessages = SessionObj->GetIntegerField(TEXT("Messages"));
+			Entry.NumRecords = SessionObj->GetIntegerField(TEXT("Records"));
+			Entry.Size = static_cast<int64>(SessionObj->GetNumberField(TEXT("Size")));
+			Entry.bIsIncomplete = SessionObj->GetBoolField(TEXT("Incomplete"));
+			FDateTime::ParseIso8601(*SessionObj->GetStringField(TEXT("Modified")), Entry.LastModified);
+
+			for (const TSharedPtr<FJsonValue>& Checkpoint : SessionObj->GetArrayField(TEXT("Checkpoints")))
+			{
+				Entry.Checkpoints.Add(static_cast<int64>(Checkpoint->AsNumber()));
+			}
+
+			Sessions.Add(SessionObj->GetStringField(TEXT("Name")), MoveTemp(Entry));
+		}
+
+		return;
+	}
+
+	// First use: index the existing journals once. Sessions saved before the journal are listed until they are converted
+	TArray<FString> FoundFiles;
+	IFileManager::Get().FindFiles(FoundFiles, *FPaths::Combine(GetSessionsPath(), TEXT("*.json*")), true, false);
+
+	for (const FString& FileIt : FoundFiles)
+	{
+		const FString Extension = FPaths::GetExtension(FileIt);
+		if (Extension.Equals(TEXT("jsonl")))
+		{
+			if (FSessionEntry Entry; ScanJournal(FPaths::Combine(GetSessionsPath(), FileIt), Entry))
+			{
+				Sessions.Add(GetSessionName(FileIt), MoveTemp(Entry));
+			}
+		}
+		else if (Extension.Equals(TEXT("json")) && !Sessions.Contains(GetSessionName(FileIt)))
+		{
+			FSessionEntry Entry;
+			Entry.LastModified = IFileManager::Get().GetTimeStamp(*FPaths::Combine(GetSessionsPath(), FileIt));
+
+			Sessions.Add(GetSessionName(FileIt), MoveTemp(Entry));
+		}
+	}
+
+	bIndexDirty = true;
+}
+
+void FHttpGPTChatJournal::SaveIndex()
+{
+	FString IndexContent;
+	{
+		FScopeLock Lock(&IndexMutex);
+		if (!bIndexDirty)
+		{
+			return;
+		}
+
+		bIndexDirty = false;
+
+		TArray<TSharedPtr<FJsonValue>> SessionsData;
+		for (const TPair<FString, FSessionEntry>& Session : Sessions)
+		{
+			const TSharedRef<FJsonObject> SessionObj = MakeShared<FJsonObject>();
+			SessionObj->SetStringField("Name", Session.Key);
+			SessionObj->SetNumberField("Messages", Session.Value.NumMessages);
+			SessionObj->SetNumberField("Records", Session.Value.NumRecords);
+			SessionObj->SetNumberField("Size", static_cast<double>(Session.Value.Size));
+			SessionObj->SetBoolField("Incomplete", Session.Value.bIsIncomplete);
+			SessionObj->SetStringField("Modified", Session.Value.LastModified.ToIso8601());
+
+			TArray<TSharedPtr<FJsonValue>> Checkpoints;
+			for (const int64 Checkpoint : Session.Value.Checkpoints)
+			{
+				Checkpoints.Add(MakeShared<FJsonValueNumber>(static_cast<double>(Checkpoint)));
+			}
+
+			SessionObj->SetArrayField("Checkpoints", Checkpoints);
+			SessionsData.Add(MakeShared<FJsonValueObject>(SessionObj));
+		}
+
+		const TSharedRef<FJsonObject> IndexObj = MakeShared<FJsonObject>();
+		IndexObj->SetArrayField("Sessions", SessionsData);
+
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(
+			&IndexContent);
+		FJsonSerializer::Serialize(IndexObj, Writer);
+	}
+
+	// A stale index is repaired when the sessions are opened, as the journal sizes won't match
+	if (!FFileHelper::SaveStringToFile(IndexContent, *GetIndexPath(), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to save the session index"), *FString(__FUNCTION__));
+	}
+}
+
+FString FHttpGPTChatJournal::SerializeRecord(const TSharedRef<FJsonObject>& Record)
+{
+	FString Output;
+	const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Output);
+	FJsonSerializer::Serialize(Record, Writer);
+
+	// Line breaks in the content are escaped, so each record is a single line
+	Output.Append(TEXT("\n"));
+	return Output;
+}
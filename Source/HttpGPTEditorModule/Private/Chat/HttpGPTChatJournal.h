@@ -0,0 +1,149 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Structures/HttpGPTChatTypes.h>
+
+class FJsonObject;
+class IFileHandle;
+
+/**
+ *
+ */
+struct FHttpGPTChatSessionInfo
+{
+	FName Name;
+	int32 NumMessages = 0;
+	int64 Size = 0;
+	FDateTime LastModified;
+};
+
+/**
+ *
+ */
+struct FHttpGPTChatJournalPage
+{
+	TArray<FHttpGPTChatMessage> Messages;
+
+	/* Index of the message each loaded message answers or follows, INDEX_NONE for the first messages of the branches */
+	TArray<int32> Parents;
+
+	/* Last message of the selected branch, INDEX_NONE for the last message of the session */
+	int32 Head = INDEX_NONE;
+
+	/* Index of the first loaded message in the session */
+	int32 FirstMessage = 0;
+
+	/* Records in the whole journal, including the ones superseded by later updates */
+	int32 NumRecords = 0;
+
+	/* Updates found in this page for messages before it */
+	TMap<int32, FString> EarlierUpdates;
+};
+
+/**
+ *
+ */
+class FHttpGPTChatJournal
+{
+public:
+	static FHttpGPTChatJournal& Get();
+	~FHttpGPTChatJournal();
+
+	static FString GetSessionsPath();
+	static FString GetJournalPath(const FName& SessionID);
+
+	/* Sessions saved before the journal, as a single JSON document */
+	static FString GetLegacyPath(const FName& SessionID);
+
+	/* The operations below are queued and written in order by a background thread */
+	void AppendMessage(const FString& Path, const EHttpGPTChatRole Role, const FString& Content, const int32 Parent);
+	void SetMessage(const FString& Path, const int32 Index, const FString& Content);
+
+	/* Select the branch ending at the message. Adding a message selects it too, without this record */
+	void SetHead(const FString& Path, const int32 Index);
+
+	/* Replace the journal with one record per message */
+	void Rewrite(const FString& Path, const TArray<FHttpGPTChatMessage>& Messages, const TArray<int32>& Parents, const int32 Head);
+
+	void Move(const FString& Path, const FString& NewPath);
+	void Delete(const FString& Path);
+
+	/* Sessions in the index, without reading their journals */
+	TArray<FHttpGPTChatSessionInfo> GetSessions();
+
+	/* Replay the most recent messages before EndMessage, after the queued operations are written. INDEX_NONE loads the end of the session.
+	 * Pages start at a checkpoint, so they may contain a few more messages than requested. Incomplete records left by a crash are ignored */
+	bool LoadPage(const FString& Path, const int32 EndMessage, const int32 MaxMessages, FHttpGPTChatJournalPage& OutPage);
+
+	/* Block until the queued operations are written. Called by the editor module at shutdown */
+	void Flush();
+
+private:
+	enum class EOperation : uint8
+	{
+		Append,
+		Rewrite,
+		Move,
+		Delete
+	};
+
+	struct FOperation
+	{
+		EOperation Type;
+		FString Path;
+		TArray<FString> Records;
+	};
+
+	struct FSessionEntry
+	{
+		int32 NumMessages = 0;
+		int32 NumRecords = 0;
+		int64 Size = 0;
+		FDateTime LastModified;
+
+		/* Byte offset of every CheckpointInterval-th message record */
+		TArray<int64> Checkpoints;
+
+		/* The last record was interrupted and has no line break */
+		bool bIsIncomplete = false;
+	};
+
+	static constexpr int32 CheckpointInterval = 32;
+
+	void Enqueue(FOperation&& Operation);
+	void ProcessQueue();
+
+	void ExecuteAppend(const TArray<FOperation>& Operations, const int32 FirstIndex, const int32 LastIndex);
+	void ExecuteRewrite(const FOperation& Operation);
+	void ExecuteMove(const FOperation& Operation);
+	void ExecuteDelete(const FOperation& Operation);
+
+	static void WriteRecord(IFileHandle& Handle, const FString& Record, FSessionEntry& Entry);
+	static bool ScanJournal(const FString& Path, FSessionEntry& OutEntry);
+	static FString SerializeRecord(const TSharedRef<FJsonObject>& Record);
+	static TSharedRef<FJsonObject> CreateMessageRecord(const EHttpGPTChatRole Role, const FString& Content, const int32 Parent);
+	static TSharedRef<FJsonObject> CreateHeadRecord(const int32 Index);
+	static FString GetSessionName(const FString& Path);
+
+	/* Entry of the session, scanned again if the journal was modified outside of the index. Requires the index lock */
+	FSessionEntry* FindValidEntry(const FString& Path);
+
+	static FString GetIndexPath();
+	void LoadIndex();
+	void SaveIndex();
+
+	TArray<FOperation> PendingOperations;
+	bool bIsWriting = false;
+
+	FCriticalSection Mutex;
+
+	TMap<FString, FSessionEntry> Sessions;
+	bool bIndexLoaded = false;
+	bool bIndexDirty = false;
+
+	FCriticalSection IndexMutex;
+};
@@ -0,0 +1,117 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "HttpGPTChatScheduler.h"
+#include <Tasks/HttpGPTBaseTask.h>
+#include <Management/HttpGPTSettings.h>
+#include <LogHttpGPT.h>
+
+FHttpGPTChatScheduler& FHttpGPTChatScheduler::Get()
+{
+	static FHttpGPTChatScheduler Instance;
+	return Instance;
+}
+
+FHttpGPTChatScheduler::~FHttpGPTChatScheduler()
+{
+	if (TickerHandle.IsValid())
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#endif
+	}
+}
+
+void FHttpGPTChatScheduler::Enqueue(const void* const Owner, const FHttpGPTChatSchedulerStart& Start)
+{
+	check(IsInGameThread());
+
+	Queue.Add(FEntry{Owner, Start});
+	Pump();
+}
+
+void FHttpGPTChatScheduler::Cancel(const void* const Owner)
+{
+	check(IsInGameThread());
+
+	Queue.RemoveAll([Owner](const FEntry& Entry)
+	{
+		return Entry.Owner == Owner;
+	});
+}
+
+bool FHttpGPTChatScheduler::IsQueued(const void* const Owner) const
+{
+	return Queue.ContainsByPredicate([Owner](const FEntry& Entry)
+	{
+		return Entry.Owner == Owner;
+	});
+}
+
+int32 FHttpGPTChatScheduler::GetNumRunning() const
+{
+	return Running.Num();
+}
+
+void FHttpGPTChatScheduler::Pump()
+{
+	// Tasks don't notify their end to native listeners: finished tasks release their slots here
+	Running.RemoveAll([](const TWeakObjectPtr<UHttpGPTBaseTask>& Task)
+	{
+		return !Task.IsValid() || !UHttpGPTTaskStatus::IsTaskActive(Task.Get());
+	});
+
+	const int32 MaxRunning = FMath::Max(UHttpGPTSettings::Get()->ChatConcurrentRequests, 1);
+
+	while (Running.Num() < MaxRunning && Queue.Num() > 0)
+	{
+		const FEntry Entry = Queue[0];
+		Queue.RemoveAt(0);
+
+		// The owner may be gone: its delegate is unbound
+		if (UHttpGPTBaseTask* const Task = Entry.Start.IsBound() ? Entry.Start.Execute() : nullptr; Task && UHttpGPTTaskStatus::IsTaskActive(Task))
+		{
+			Running.Add(Task);
+		}
+	}
+
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: %d chat requests running, %d queued"), *FString(__FUNCTION__), Running.Num(), Queue.Num());
+
+	const bool bNeedsTicker = Running.Num() > 0 || Queue.Num() > 0;
+	if (bNeedsTicker && !TickerHandle.IsValid())
+	{
+		const FTickerDelegate TickerDelegate = FTickerDelegate::CreateRaw(this, &FHttpGPTChatScheduler::Tick);
+
+#if ENGINE_MAJOR_VERSION >= 5
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TickerDelegate, 0.1f);
+#else
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(TickerDelegate, 0.1f);
+#endif
+	}
+}
+
+bool FHttpGPTChatScheduler::Tick([[maybe_unused]] const float DeltaTime)
+{
+	const int32 PreviousRunning = Running.Num();
+
+	Running.RemoveAll([](const TWeakObjectPtr<UHttpGPTBaseTask>& Task)
+	{
+		return !Task.IsValid() || !UHttpGPTTaskStatus::IsTaskActive(Task.Get());
+	});
+
+	if (Running.Num() != PreviousRunning)
+	{
+		Pump();
+	}
+
+	if (Running.Num() > 0 || Queue.Num() > 0)
+	{
+		return true;
+	}
+
+	TickerHandle.Reset();
+	return false;
+}
@@ -0,0 +1,51 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Containers/Ticker.h>
+
+class UHttpGPTBaseTask;
+
+/* Create and activate the request. The returned task holds the slot until it ends */
+DECLARE_DELEGATE_RetVal(UHttpGPTBaseTask*, FHttpGPTChatSchedulerStart);
+
+/**
+ *
+ */
+class FHttpGPTChatScheduler
+{
+public:
+	static FHttpGPTChatScheduler& Get();
+	~FHttpGPTChatScheduler();
+
+	/* Start the request when there are less running requests than configured in the plugin settings. Requests start in the order they are queued */
+	void Enqueue(const void* const Owner, const FHttpGPTChatSchedulerStart& Start);
+
+	/* Remove the requests of the owner that didn't start yet */
+	void Cancel(const void* const Owner);
+
+	bool IsQueued(const void* const Owner) const;
+	int32 GetNumRunning() const;
+
+private:
+	struct FEntry
+	{
+		const void* Owner = nullptr;
+		FHttpGPTChatSchedulerStart Start;
+	};
+
+	void Pump();
+	bool Tick(const float DeltaTime);
+
+	TArray<FEntry> Queue;
+	TArray<TWeakObjectPtr<UHttpGPTBaseTask>> Running;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::FDelegateHandle TickerHandle;
+#else
+	FDelegateHandle TickerHandle;
+#endif
+};
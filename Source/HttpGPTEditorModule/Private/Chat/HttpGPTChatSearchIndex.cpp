@@ -0,0 +1,602 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "HttpGPTChatSearchIndex.h"
+#include "HttpGPTChatJournal.h"
+#include <LogHttpGPT.h>
+#include <Async/Async.h>
+#include <Misc/FileHelper.h>
+#include <Serialization/MemoryReader.h>
+#include <Serialization/MemoryWriter.h>
+
+// Change this version to discard the saved index when its format changes
+static constexpr int32 SearchIndexVersion = 1;
+
+static constexpr int32 MinTokenLength = 2;
+static constexpr int32 MaxTokenLength = 32;
+static constexpr int32 PreviewLength = 160;
+
+// BM25 parameters: how fast repeated words stop adding relevance, and how much long messages are penalized
+static constexpr float RankingSaturation = 1.2f;
+static constexpr float RankingLengthWeight = 0.75f;
+
+FHttpGPTChatSearchIndex& FHttpGPTChatSearchIndex::Get()
+{
+	static FHttpGPTChatSearchIndex Instance;
+	return Instance;
+}
+
+FString FHttpGPTChatSearchIndex::GetIndexPath()
+{
+	return FPaths::Combine(FHttpGPTChatJournal::GetSessionsPath(), TEXT("Search.idx"));
+}
+
+void FHttpGPTChatSearchIndex::Initialize()
+{
+	check(IsInGameThread());
+
+	if (bIsInitialized)
+	{
+		return;
+	}
+
+	bIsInitialized = true;
+	Load();
+
+	// The saved index is trusted for the sessions whose journal didn't change since it was saved
+	TArray<FName> StaleSessions;
+	TSet<FName> JournalSessions;
+
+	for (const FHttpGPTChatSessionInfo& Session : FHttpGPTChatJournal::Get().GetSessions())
+	{
+		JournalSessions.Add(Session.Name);
+
+		const int32* const SessionId = SessionIds.Find(Session.Name);
+		if (!SessionId || SessionSizes[*SessionId] != Session.Size)
+		{
+			StaleSessions.Add(Session.Name);
+		}
+	}
+
+	for (const FName& SessionID : TArray<FName>(Sessions))
+	{
+		if (!SessionID.IsNone() && !JournalSessions.Contains(SessionID))
+		{
+			RemoveSession(SessionID);
+		}
+	}
+
+	if (StaleSessions.Num() <= 0)
+	{
+		return;
+	}
+
+	PendingSessions.Append(StaleSessions);
+
+	Async(EAsyncExecution::ThreadPool, [StaleSessions]
+	{
+		TMap<FName, TArray<FHttpGPTChatMessage>> ScannedSessions;
+
+		for (const FName& SessionID : StaleSessions)
+		{
+			FHttpGPTChatJournalPage Page;
+			FHttpGPTChatJournal::Get().LoadPage(FHttpGPTChatJournal::GetJournalPath(SessionID), INDEX_NONE, MAX_int32, Page);
+			ScannedSessions.Add(SessionID, MoveTemp(Page.Messages));
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [ScannedSessions = MoveTemp(ScannedSessions)]() mutable
+		{
+			Get().OnSessionsScanned(MoveTemp(ScannedSessions));
+		});
+	});
+}
+
+void FHttpGPTChatSearchIndex::OnSessionsScanned(TMap<FName, TArray<FHttpGPTChatMessage>>&& ScannedSessions)
+{
+	check(IsInGameThread());
+
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Indexing %d chat sessions"), *FString(__FUNCTION__), ScannedSessions.Num());
+
+	PendingSessions.Empty();
+
+	for (const TPair<FName, TArray<FHttpGPTChatMessage>>& Session : ScannedSessions)
+	{
+		ResetSession(Session.Key, Session.Value);
+	}
+
+	// Messages written during the scan may be missing in it. Updates replace the indexed message, so applying them again is harmless
+	for (const FDeferredUpdate& Update : DeferredUpdates)
+	{
+		ApplyUpdate(Update.SessionID, Update.MessageIndex, Update.Content);
+	}
+
+	DeferredUpdates.Empty();
+}
+
+bool FHttpGPTChatSearchIndex::IsBuilding() const
+{
+	return PendingSessions.Num() > 0;
+}
+
+void FHttpGPTChatSearchIndex::Tokenize(const FString& Content, TMap<FString, int32>& OutFrequencies, int32& OutNumTokens)
+{
+	OutNumTokens = 0;
+
+	FString Token;
+	Token.Reserve(MaxTokenLength);
+
+	const auto AddToken = [&OutFrequencies, &OutNumTokens, &Token]
+	{
+		if (Token.Len() >= MinTokenLength)
+		{
+			++OutFrequencies.FindOrAdd(Token);
+			++OutNumTokens;
+		}
+
+		Token.Reset();
+	};
+
+	for (const TCHAR Character : Content)
+	{
+		if (FChar::IsAlnum(Character) || Character == TEXT('_'))
+		{
+			if (Token.Len() < MaxTokenLength)
+			{
+				Token.AppendChar(FChar::ToLower(Character));
+			}
+		}
+		else
+		{
+			AddToken();
+		}
+	}
+
+	AddToken();
+}
+
+uint64 FHttpGPTChatSearchIndex::GetDocumentKey(const int32 Session, const int32 Message)
+{
+	return static_cast<uint64>(static_cast<uint32>(Session)) << 32 | static_cast<uint32>(Message);
+}
+
+int32 FHttpGPTChatSearchIndex::FindOrAddSession(const FName& SessionID)
+{
+	if (const int32* const SessionId = SessionIds.Find(SessionID))
+	{
+		return *SessionId;
+	}
+
+	const int32 NewSessionId = Sessions.Add(SessionID);
+	SessionSizes.Add(INDEX_NONE);
+	SessionDocuments.AddDefaulted();
+	SessionIds.Add(SessionID, NewSessionId);
+
+	return NewSessionId;
+}
+
+void FHttpGPTChatSearchIndex::RemoveDocument(const int32 Document)
+{
+	FDocument& Removed = Documents[Document];
+	if (Removed.bIsRemoved)
+	{
+		return;
+	}
+
+	// Postings are only filtered when the index is saved: removed documents are skipped by the queries
+	Removed.bIsRemoved = true;
+	Removed.Preview.Empty();
+
+	DocumentKeys.Remove(GetDocumentKey(Removed.Session, Removed.Message));
+
+	--NumActiveDocuments;
+	NumActiveTokens -= Removed.NumTokens;
+}
+
+void FHttpGPTChatSearchIndex::UpdateMessage(const FName& SessionID, const int32 MessageIndex, const FString& Content)
+{
+	check(IsInGameThread());
+
+	if (PendingSessions.Contains(SessionID))
+	{
+		DeferredUpdates.Add(FDeferredUpdate{SessionID, MessageIndex, Content});
+	}
+
+	ApplyUpdate(SessionID, MessageIndex, Content);
+}
+
+void FHttpGPTChatSearchIndex::ApplyUpdate(const FName& SessionID, const int32 MessageIndex, const FString& Content)
+{
+	const int32 Session = FindOrAddSession(SessionID);
+
+	if (const int32* const Existing = DocumentKeys.Find(GetDocumentKey(Session, MessageIndex)))
+	{
+		RemoveDocument(*Existing);
+	}
+
+	TMap<FString, int32> Frequencies;
+	int32 NumTokens = 0;
+	Tokenize(Content, Frequencies, NumTokens);
+
+	if (NumTokens <= 0)
+	{
+		return;
+	}
+
+	FDocument NewDocument;
+	NewDocument.Session = Session;
+	NewDocument.Message = MessageIndex;
+	NewDocument.NumTokens = NumTokens;
+	NewDocument.Preview = Content.Left(PreviewLength).Replace(TEXT("\n"), TEXT(" "));
+
+	const int32 Document = Documents.Add(MoveTemp(NewDocument));
+	DocumentKeys.Add(GetDocumentKey(Session, MessageIndex), Document);
+	SessionDocuments[Session].Add(Document);
+
+	for (const TPair<FString, int32>& Term : Frequencies)
+	{
+		Postings.FindOrAdd(Term.Key).Add(FPosting{Document, Term.Value});
+	}
+
+	++NumActiveDocuments;
+	NumActiveTokens += NumTokens;
+}
+
+void FHttpGPTChatSearchIndex::ResetSession(const FName& SessionID, const TArray<FHttpGPTChatMessage>& Messages)
+{
+	check(IsInGameThread());
+
+	RemoveSession(SessionID);
+
+	for (int32 Index = 0; Index < Messages.Num(); ++Index)
+	{
+		ApplyUpdate(SessionID, Index, Messages[Index].Content);
+	}
+}
+
+void FHttpGPTChatSearchIndex::RemoveSession(const FName& SessionID)
+{
+	check(IsInGameThread());
+
+	if (const int32* const Session = SessionIds.Find(SessionID))
+	{
+		RemoveSessionDocuments(*Session);
+	}
+}
+
+void FHttpGPTChatSearchIndex::RemoveSessionDocuments(const int32 Session)
+{
+	for (const int32 Document : SessionDocuments[Session])
+	{
+		RemoveDocument(Document);
+	}
+
+	SessionDocuments[Session].Empty();
+}
+
+void FHttpGPTChatSearchIndex::RenameSession(const FName& SessionID, const FName& NewSessionID)
+{
+	check(IsInGameThread());
+
+	int32 Session = INDEX_NONE;
+	if (SessionID == NewSessionID || !SessionIds.RemoveAndCopyValue(SessionID, Session))
+	{
+		return;
+	}
+
+	// The session replaced by the rename keeps its id, without a name
+	if (int32 Replaced = INDEX_NONE; SessionIds.RemoveAndCopyValue(NewSessionID, Replaced))
+	{
+		RemoveSessionDocuments(Replaced);
+		Sessions[Replaced] = NAME_None;
+	}
+
+	// Documents reference the session by its id: only the name changes
+	Sessions[Session] = NewSessionID;
+	SessionIds.Add(NewSessionID, Session);
+}
+
+TArray<FHttpGPTChatSearchHitPtr> FHttpGPTChatSearchIndex::Search(const FString& Query, const int32 MaxHits) const
+{
+	TMap<FString, int32> QueryTerms;
+	int32 NumQueryTokens = 0;
+	Tokenize(Query, QueryTerms, NumQueryTokens);
+
+	TArray<const TArray<FPosting>*> TermPostings;
+	for (const TPair<FString, int32>& Term : QueryTerms)
+	{
+		const TArray<FPosting>* const Found = Postings.Find(Term.Key);
+		if (!Found)
+		{
+			return TArray<FHttpGPTChatSearchHitPtr>();
+		}
+
+		TermPostings.Add(Found);
+	}
+
+	if (TermPostings.Num() <= 0 || NumActiveDocuments <= 0)
+	{
+		return TArray<FHttpGPTChatSearchHitPtr>();
+	}
+
+	// Start with the rarest term: the other terms only filter its documents
+	TermPostings.Sort([](const TArray<FPosting>& Lhs, const TArray<FPosting>& Rhs)
+	{
+		return Lhs.Num() < Rhs.Num();
+	});
+
+	const float AverageLength = static_cast<float>(NumActiveTokens) / NumActiveDocuments;
+
+	// BM25 relevance. Document frequencies include removed documents until the index is saved, which only slightly affects the ranking
+	const auto ScoreTerm = [this, AverageLength](const TArray<FPosting>& TermPosting, const FPosting& Posting)
+	{
+		const float InverseFrequency = FMath::Loge(1.f + (NumActiveDocuments - TermPosting.Num() + 0.5f) / (TermPosting.Num() + 0.5f));
+		const float LengthRatio = Documents[Posting.Document].NumTokens / AverageLength;
+
+		return InverseFrequency * Posting.Frequency * (RankingSaturation + 1.f) / (Posting.Frequency + RankingSaturation * (1.f - RankingLengthWeight + RankingLengthWeight * LengthRatio));
+	};
+
+	TMap<int32, float> Scores;
+	for (const FPosting& Posting : *TermPostings[0])
+	{
+		if (!Documents[Posting.Document].bIsRemoved)
+		{
+			Scores.Add(Posting.Document, ScoreTerm(*TermPostings[0], Posting));
+		}
+	}
+
+	for (int32 TermIndex = 1; TermIndex < TermPostings.Num() && Scores.Num() > 0; ++TermIndex)
+	{
+		TMap<int32, float> Matches;
+		for (const FPosting& Posting : *TermPostings[TermIndex])
+		{
+			if (const float* const Score = Scores.Find(Posting.Document))
+			{
+				Matches.Add(Posting.Document, *Score + ScoreTerm(*TermPostings[TermIndex], Posting));
+			}
+		}
+
+		Scores = MoveTemp(Matches);
+	}
+
+	Scores.ValueSort([](const float Lhs, const float Rhs)
+	{
+		return Lhs > Rhs;
+	});
+
+	TArray<FHttpGPTChatSearchHitPtr> Output;
+	for (const TPair<int32, float>& Score : Scores)
+	{
+		if (Output.Num() >= MaxHits)
+		{
+			break;
+		}
+
+		const FDocument& Document = Documents[Score.Key];
+
+		const FHttpGPTChatSearchHitPtr Hit = MakeShared<FHttpGPTChatSearchHit>();
+		Hit->SessionID = Sessions[Document.Session];
+		Hit->MessageIndex = Document.Message;
+		Hit->Score = Score.Value;
+		Hit->Preview = Document.Preview;
+
+		Output.Add(Hit);
+	}
+
+	return Output;
+}
+
+/* Counts read from the file are only trusted if the remaining data can hold that many elements */
+static bool IsValidCount(FArchive& Ar, const int32 Count, const int32 MinElementSize)
+{
+	if (Count < 0 || static_cast<int64>(Count) * MinElementSize > Ar.TotalSize() - Ar.Tell())
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	return !Ar.IsError();
+}
+
+bool FHttpGPTChatSearchIndex::Load()
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *GetIndexPath(), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+
+	int32 Version = 0;
+	Reader << Version;
+	if (Version != SearchIndexVersion)
+	{
+		return false;
+	}
+
+	Reader << Sessions << SessionSizes;
+
+	int32 NumDocuments = 0;
+	Reader << NumDocuments;
+
+	// Session, message and tokens, plus the length of the preview
+	if (Sessions.Num() != SessionSizes.Num() || !IsValidCount(Reader, NumDocuments, 4 * sizeof(int32)))
+	{
+		Reader.SetError();
+		NumDocuments = 0;
+	}
+
+	Documents.SetNum(NumDocuments);
+	SessionDocuments.SetNum(Sessions.Num());
+
+	for (int32 Index = 0; Index < NumDocuments; ++Index)
+	{
+		FDocument& Document = Documents[Index];
+		Reader << Document.Session << Document.Message << Document.NumTokens << Document.Preview;
+
+		if (!Sessions.IsValidIndex(Document.Session))
+		{
+			Reader.SetError();
+			break;
+		}
+
+		DocumentKeys.Add(GetDocumentKey(Document.Session, Document.Message), Index);
+		SessionDocuments[Document.Session].Add(Index);
+
+		++NumActiveDocuments;
+		NumActiveTokens += Document.NumTokens;
+	}
+
+	int32 NumTerms = 0;
+	Reader << NumTerms;
+
+	// Length of the term and number of postings
+	if (IsValidCount(Reader, NumTerms, 2 * sizeof(int32)))
+	{
+		Postings.Reserve(NumTerms);
+	}
+
+	for (int32 Index = 0; Index < NumTerms && !Reader.IsError(); ++Index)
+	{
+		FString Term;
+		int32 NumPostings = 0;
+		Reader << Term << NumPostings;
+
+		// Document and frequency
+		if (!IsValidCount(Reader, NumPostings, 2 * sizeof(int32)))
+		{
+			break;
+		}
+
+		TArray<FPosting>& TermPostings = Postings.Add(Term);
+		TermPostings.SetNum(NumPostings);
+
+		for (FPosting& Posting : TermPostings)
+		{
+			Reader << Posting.Document << Posting.Frequency;
+
+			if (!Documents.IsValidIndex(Posting.Document))
+			{
+				Reader.SetError();
+				break;
+			}
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogHttpGPT, Warning, TEXT("%s: The chat search index is corrupted and will be rebuilt"), *FString(__FUNCTION__));
+
+		Sessions.Empty();
+		SessionSizes.Empty();
+		SessionDocuments.Empty();
+		Documents.Empty();
+		DocumentKeys.Empty();
+		Postings.Empty();
+		NumActiveDocuments = 0;
+		NumActiveTokens = 0;
+
+		return false;
+	}
+
+	for (int32 Index = 0; Index < Sessions.Num(); ++Index)
+	{
+		if (!Sessions[Index].IsNone())
+		{
+			SessionIds.Add(Sessions[Index], Index);
+		}
+	}
+
+	return true;
+}
+
+void FHttpGPTChatSearchIndex::Save()
+{
+	check(IsInGameThread());
+
+	// Sessions still being scanned are indexed again on the next initialization
+	if (!bIsInitialized || IsBuilding())
+	{
+		return;
+	}
+
+	// The saved sizes must match the written journals
+	FHttpGPTChatJournal::Get().Flush();
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	// Size of each journal when it was indexed, to detect the sessions modified without the index on the next load
+	SessionSizes.Init(INDEX_NONE, Sessions.Num());
+	for (const FHttpGPTChatSessionInfo& Session : FHttpGPTChatJournal::Get().GetSessions())
+	{
+		if (const int32* const SessionId = SessionIds.Find(Session.Name))
+		{
+			SessionSizes[*SessionId] = Session.Size;
+		}
+	}
+
+	int32 Version = SearchIndexVersion;
+	Writer << Version;
+	Writer << Sessions << SessionSizes;
+
+	// Removed documents are dropped here, so the saved postings don't need to be filtered
+	TArray<int32> DocumentRemap;
+	DocumentRemap.Init(INDEX_NONE, Documents.Num());
+
+	int32 NumDocuments = NumActiveDocuments;
+	Writer << NumDocuments;
+
+	int32 NextDocument = 0;
+	for (int32 Index = 0; Index < Documents.Num(); ++Index)
+	{
+		FDocument& Document = Documents[Index];
+		if (Document.bIsRemoved)
+		{
+			continue;
+		}
+
+		DocumentRemap[Index] = NextDocument++;
+		Writer << Document.Session << Document.Message << Document.NumTokens << Document.Preview;
+	}
+
+	TArray<FString> Terms;
+	TArray<TArray<FPosting>> TermPostings;
+	for (const TPair<FString, TArray<FPosting>>& Term : Postings)
+	{
+		TArray<FPosting> Remapped;
+		for (const FPosting& Posting : Term.Value)
+		{
+			if (DocumentRemap[Posting.Document] != INDEX_NONE)
+			{
+				Remapped.Add(FPosting{DocumentRemap[Posting.Document], Posting.Frequency});
+			}
+		}
+
+		if (Remapped.Num() > 0)
+		{
+			Terms.Add(Term.Key);
+			TermPostings.Add(MoveTemp(Remapped));
+		}
+	}
+
+	int32 NumTerms = Terms.Num();
+	Writer << NumTerms;
+
+	for (int32 Index = 0; Index < NumTerms; ++Index)
+	{
+		int32 NumPostings = TermPostings[Index].Num();
+		Writer << Terms[Index] << NumPostings;
+
+		for (FPosting& Posting : TermPostings[Index])
+		{
+			Writer << Posting.Document << Posting.Frequency;
+		}
+	}
+
+	if (!FFileHelper::SaveArrayToFile(Data, *GetIndexPath()))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to save the chat search index"), *FString(__FUNCTION__));
+	}
+}
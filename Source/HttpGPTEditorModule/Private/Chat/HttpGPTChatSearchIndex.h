@@ -0,0 +1,100 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Structures/HttpGPTChatTypes.h>
+
+/**
+ *
+ */
+struct FHttpGPTChatSearchHit
+{
+	FName SessionID;
+	int32 MessageIndex = INDEX_NONE;
+	float Score = 0.f;
+	FString Preview;
+};
+
+using FHttpGPTChatSearchHitPtr = TSharedPtr<FHttpGPTChatSearchHit>;
+
+/**
+ *
+ */
+class FHttpGPTChatSearchIndex
+{
+public:
+	static FHttpGPTChatSearchIndex& Get();
+
+	/* Load the saved index and index the sessions modified since it was saved, in the background */
+	void Initialize();
+
+	/* Save the index next to the session journals */
+	void Save();
+
+	bool IsBuilding() const;
+
+	/* Messages containing every word of the query, the most relevant first */
+	TArray<FHttpGPTChatSearchHitPtr> Search(const FString& Query, const int32 MaxHits) const;
+
+	void UpdateMessage(const FName& SessionID, const int32 MessageIndex, const FString& Content);
+	void ResetSession(const FName& SessionID, const TArray<FHttpGPTChatMessage>& Messages);
+	void RemoveSession(const FName& SessionID);
+	void RenameSession(const FName& SessionID, const FName& NewSessionID);
+
+private:
+	struct FPosting
+	{
+		int32 Document = INDEX_NONE;
+		int32 Frequency = 0;
+	};
+
+	struct FDocument
+	{
+		int32 Session = INDEX_NONE;
+		int32 Message = INDEX_NONE;
+		int32 NumTokens = 0;
+		FString Preview;
+		bool bIsRemoved = false;
+	};
+
+	static void Tokenize(const FString& Content, TMap<FString, int32>& OutFrequencies, int32& OutNumTokens);
+	static uint64 GetDocumentKey(const int32 Session, const int32 Message);
+
+	int32 FindOrAddSession(const FName& SessionID);
+	void RemoveDocument(const int32 Document);
+	void RemoveSessionDocuments(const int32 Session);
+	void ApplyUpdate(const FName& SessionID, const int32 MessageIndex, const FString& Content);
+	void OnSessionsScanned(TMap<FName, TArray<FHttpGPTChatMessage>>&& ScannedSessions);
+
+	static FString GetIndexPath();
+	bool Load();
+
+	TArray<FName> Sessions;
+	TArray<int64> SessionSizes;
+	TMap<FName, int32> SessionIds;
+	TArray<TArray<int32>> SessionDocuments;
+
+	TArray<FDocument> Documents;
+	TMap<uint64, int32> DocumentKeys;
+	TMap<FString, TArray<FPosting>> Postings;
+
+	int32 NumActiveDocuments = 0;
+	int64 NumActiveTokens = 0;
+
+	bool bIsInitialized = false;
+
+	/* Sessions being scanned in the background: their updates are applied after the scan */
+	TSet<FName> PendingSessions;
+
+	struct FDeferredUpdate
+	{
+		FName SessionID;
+		int32 MessageIndex;
+		FString Content;
+	};
+
+	TArray<FDeferredUpdate> DeferredUpdates;
+};
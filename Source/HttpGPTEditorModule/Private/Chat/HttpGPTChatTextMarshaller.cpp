@@ -0,0 +1,50 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "HttpGPTChatTextMarshaller.h"
+#include <Framework/Text/TextLayout.h>
+
+TSharedRef<FHttpGPTChatTextMarshaller> FHttpGPTChatTextMarshaller::Create()
+{
+	return MakeShareable(new FHttpGPTChatTextMarshaller());
+}
+
+void FHttpGPTChatTextMarshaller::SetText(const FString& SourceString, FTextLayout& TargetTextLayout)
+{
+	// The marshaller is owned by a single text widget, so the layout outlives it
+	TextLayout = &TargetTextLayout;
+
+	FPlainTextLayoutMarshaller::SetText(SourceString, TargetTextLayout);
+}
+
+bool FHttpGPTChatTextMarshaller::AppendText(const FString& Text)
+{
+	if (!TextLayout || TextLayout->GetLineModels().Num() <= 0)
+	{
+		return false;
+	}
+
+	TArray<FString> Lines;
+	Text.ParseIntoArray(Lines, TEXT("\n"), false);
+
+	for (int32 Index = 0; Index < Lines.Num(); ++Index)
+	{
+		const int32 LastLineIndex = TextLayout->GetLineModels().Num() - 1;
+		const FTextLocation EndLocation(LastLineIndex, TextLayout->GetLineModels()[LastLineIndex].Text->Len());
+
+		// Each line break starts a new line model: the previous lines keep their shaped text
+		if (Index > 0 && !TextLayout->SplitLineAt(EndLocation))
+		{
+			return false;
+		}
+
+		const FString Line = Lines[Index].Replace(TEXT("\r"), TEXT(""));
+		if (Line.Len() > 0 && !TextLayout->InsertAt(Index > 0 ? FTextLocation(LastLineIndex + 1, 0) : EndLocation, Line))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,28 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Framework/Text/PlainTextLayoutMarshaller.h>
+
+class FTextLayout;
+
+/**
+ *
+ */
+class FHttpGPTChatTextMarshaller final : public FPlainTextLayoutMarshaller
+{
+public:
+	static TSharedRef<FHttpGPTChatTextMarshaller> Create();
+
+	/* FPlainTextLayoutMarshaller */
+	virtual void SetText(const FString& SourceString, FTextLayout& TargetTextLayout) override;
+
+	/* Insert the text at the end of the last line. Only the modified lines are shaped again. Returns false if there's no layout to append to */
+	bool AppendText(const FString& Text);
+
+private:
+	FTextLayout* TextLayout = nullptr;
+};
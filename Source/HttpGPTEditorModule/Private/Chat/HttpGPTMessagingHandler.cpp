@@ -4,7 +4,6 @@
 
 #include "HttpGPTMessagingHandler.h"
 #include <HttpGPTInternalFuncs.h>
-#include <Widgets/Layout/SScrollBox.h>
 
 #ifdef UE_INLINE_GENERATED_CPP_BY_NAME
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HttpGPTMessagingHandler)
@@ -39,12 +38,6 @@ void UHttpGPTMessagingHandler::ProcessCompleted(const FHttpGPTChatResponse& Resp
 
 void UHttpGPTMessagingHandler::ProcessResponse(const FHttpGPTChatResponse& Response)
 {
-	bool bScrollToEnd = false;
-	if (ScrollBoxReference.IsValid())
-	{
-		bScrollToEnd = FMath::Abs(ScrollBoxReference->GetScrollOffsetOfEnd() - ScrollBoxReference->GetScrollOffset()) <= 8.f;
-	}
-
 	if (!Response.bSuccess)
 	{
 		const FStringFormatOrderedArguments Arguments_ErrorDetails{
@@ -59,19 +52,13 @@ void UHttpGPTMessagingHandler::ProcessResponse(const FHttpGPTChatResponse& Respo
 	{
 		OnMessageContentUpdated.ExecuteIfBound(Response.Choices[0].Message.Content);
 	}
-	else
-	{
-		return;
-	}
-
-	if (ScrollBoxReference.IsValid() && bScrollToEnd)
-	{
-		ScrollBoxReference->ScrollToEnd();
-	}
 }
 
 void UHttpGPTMessagingHandler::Destroy()
 {
+	OnMessageCompleted.ExecuteIfBound();
+	OnMessageCompleted.Unbind();
+
 	ClearFlags(RF_Standalone);
 
 #if ENGINE_MAJOR_VERSION >= 5
@@ -21,6 +21,9 @@ public:
 
 	FMessageContentUpdated OnMessageContentUpdated;
 
+	/* Executed when the request ends, successfully or not. The message content won't change anymore */
+	FSimpleDelegate OnMessageCompleted;
+
 	UFUNCTION()
 	void RequestSent();
 
@@ -33,8 +36,6 @@ public:
 	UFUNCTION()
 	void ProcessCompleted(const FHttpGPTChatResponse& Response);
 
-	TSharedPtr<class SScrollBox> ScrollBoxReference;
-
 	void Destroy();
 
 private:
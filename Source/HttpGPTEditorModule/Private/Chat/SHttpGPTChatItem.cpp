@@ -3,36 +3,25 @@
 // Repo: https://github.com/lucoiso/UEHttpGPT
 
 #include "SHttpGPTChatItem.h"
-#include "HttpGPTMessagingHandler.h"
+#include "HttpGPTChatTextMarshaller.h"
 #include <Widgets/Text/SMultiLineEditableText.h>
+#include <Widgets/Input/STextEntryPopup.h>
 
 void SHttpGPTChatItem::Construct(const FArguments& InArgs)
 {
-	MessageRole = InArgs._MessageRole;
-	InputText = InArgs._InputText;
+	ItemData = InArgs._ItemData;
+	check(ItemData.IsValid());
 
-	if (MessageRole == EHttpGPTChatRole::Assistant)
-	{
-		MessagingHandlerObject = NewObject<UHttpGPTMessagingHandler>();
-		MessagingHandlerObject->SetFlags(RF_Standalone);
-		MessagingHandlerObject->ScrollBoxReference = InArgs._ScrollBox;
+	BranchText = InArgs._BranchText;
+	IsBranchingEnabled = InArgs._IsBranchingEnabled;
+	OnRegenerate = InArgs._OnRegenerate;
+	OnEdited = InArgs._OnEdited;
+	OnBranchSwitched = InArgs._OnBranchSwitched;
 
-		MessagingHandlerObject->OnMessageContentUpdated.BindLambda([this](FString Content)
-		{
-			if (!Message.IsValid())
-			{
-				return;
-			}
+	// Rows are recycled by the list view: only the row currently displaying the message receives its updates
+	ItemData->OnContentChanged.BindSP(this, &SHttpGPTChatItem::HandleContentChanged);
 
-#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1)
-			const FTextSelection SelectedText = Message->GetSelection();
-			Message->SetText(FText::FromString(Content));
-			Message->SelectText(SelectedText.GetBeginning(), SelectedText.GetEnd());
-#else
-                Message->SetText(FText::FromString(Content));
-#endif
-		});
-	}
+	MessageMarshaller = FHttpGPTChatTextMarshaller::Create();
 
 	ChildSlot
 	[
@@ -40,6 +29,70 @@ void SHttpGPTChatItem::Construct(const FArguments& InArgs)
 	];
 }
 
+SHttpGPTChatItem::~SHttpGPTChatItem()
+{
+	if (ItemData.IsValid() && ItemData->OnContentChanged.IsBoundToObject(this))
+	{
+		ItemData->OnContentChanged.Unbind();
+	}
+}
+
+void SHttpGPTChatItem::HandleContentChanged(const int32 AppendStart)
+{
+	if (!Message.IsValid())
+	{
+		return;
+	}
+
+	// Streamed responses only add text at the end: the new run is inserted into the existing layout instead of shaping the whole message again
+	if (AppendStart != INDEX_NONE && MessageMarshaller.IsValid() && MessageMarshaller->AppendText(ItemData->Content.Mid(AppendStart)))
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		Message->Invalidate(EInvalidateWidgetReason::Layout);
+#else
+		Message->Invalidate(EInvalidateWidget::Layout);
+#endif
+		return;
+	}
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1)
+	const FTextSelection SelectedText = Message->GetSelection();
+	Message->SetText(FText::FromString(ItemData->Content));
+	Message->SelectText(SelectedText.GetBeginning(), SelectedText.GetEnd());
+#else
+    Message->SetText(FText::FromString(ItemData->Content));
+#endif
+}
+
+FReply SHttpGPTChatItem::HandleEditButton()
+{
+	const TSharedRef<STextEntryPopup> TextEntry = SNew(STextEntryPopup).Label(FText::FromString("Edit Message")).DefaultText(
+		FText::FromString(ItemData->Content)).OnTextCommitted(this, &SHttpGPTChatItem::HandleEditCommitted);
+
+	FSlateApplication& SlateApp = FSlateApplication::Get();
+	SlateApp.PushMenu(AsShared(), FWidgetPath(), TextEntry, SlateApp.GetCursorPos(), FPopupTransitionEffect::TypeInPopup);
+
+	return FReply::Handled();
+}
+
+void SHttpGPTChatItem::HandleEditCommitted(const FText& NewText, const ETextCommit::Type CommitType)
+{
+	if (CommitType == ETextCommit::OnEnter)
+	{
+		// The edited message starts a new branch: the original one is kept
+		if (const FString NewContent = NewText.ToString(); !NewContent.IsEmpty() && !NewContent.Equals(ItemData->Content, ESearchCase::CaseSensitive))
+		{
+			OnEdited.ExecuteIfBound(NewContent);
+		}
+
+		FSlateApplication::Get().DismissAllMenus();
+	}
+	else if (CommitType == ETextCommit::OnCleared)
+	{
+		FSlateApplication::Get().DismissAllMenus();
+	}
+}
+
 static FSlateColor& operator*=(FSlateColor& Lhs, const float Rhs)
 {
 	FLinearColor NewColor = Lhs.GetSpecifiedColor() * Rhs;
@@ -58,13 +111,13 @@ TSharedRef<SWidget> SHttpGPTChatItem::ConstructContent()
 	FMargin BoxMargin(SlotPadding * PaddingMultiplier, SlotPadding, SlotPadding, SlotPadding);
 	FSlateColor MessageColor(FLinearColor::White);
 
-	if (MessageRole == EHttpGPTChatRole::Assistant)
+	if (ItemData->Role == EHttpGPTChatRole::Assistant)
 	{
 		RoleText = FText::FromString(TEXT("Assistant:"));
 		BoxMargin = FMargin(SlotPadding, SlotPadding, SlotPadding * PaddingMultiplier, SlotPadding);
 		MessageColor *= 0.3f;
 	}
-	else if (MessageRole == EHttpGPTChatRole::System)
+	else if (ItemData->Role == EHttpGPTChatRole::System)
 	{
 		RoleText = FText::FromString(TEXT("System:"));
 		BoxMargin = FMargin(SlotPadding * PaddingMultiplier * 0.5f, SlotPadding);
@@ -84,23 +137,74 @@ TSharedRef<SWidget> SHttpGPTChatItem::ConstructContent()
 				SNew(SVerticalBox)
 				+ SVerticalBox::Slot().Padding(SlotPadding).AutoHeight()
 				[
-					SAssignNew(Role, STextBlock).Font(FCoreStyle::GetDefaultFontStyle("Bold", 10)).Text(RoleText)
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot().FillWidth(1.f).VAlign(VAlign_Center)
+					[
+						SNew(STextBlock).Font(FCoreStyle::GetDefaultFontStyle("Bold", 10)).Text(RoleText)
+					]
+					+ SHorizontalBox::Slot().AutoWidth().VAlign(VAlign_Center)
+					[
+						ConstructBranchNavigation()
+					]
+					+ SHorizontalBox::Slot().AutoWidth().VAlign(VAlign_Center).Padding(SlotPadding, 0.f, 0.f, 0.f)
+					[
+						ConstructActionButton()
+					]
 				]
 				+ SVerticalBox::Slot().Padding(MessageMargin).FillHeight(1.f)
 				[
-					SAssignNew(Message, SMultiLineEditableText).AllowMultiLine(true).AutoWrapText(true).IsReadOnly(true).AllowContextMenu(true).Text(
-						FText::FromString(InputText))
+					SAssignNew(Message, SMultiLineEditableText).AllowMultiLine(true).AutoWrapText(true).IsReadOnly(true).AllowContextMenu(true).Marshaller(
+						MessageMarshaller.ToSharedRef()).Text(FText::FromString(ItemData->Content))
 				]
 			]
 		];
 }
 
-FString SHttpGPTChatItem::GetRoleText() const
+TSharedRef<SWidget> SHttpGPTChatItem::ConstructBranchNavigation()
 {
-	return Role.IsValid() ? Role->GetText().ToString() : FString();
+	return SNew(SHorizontalBox).IsEnabled(IsBranchingEnabled).Visibility_Lambda([this]
+		{
+			return BranchText.Get().IsEmpty() ? EVisibility::Collapsed : EVisibility::Visible;
+		})
+		+ SHorizontalBox::Slot().AutoWidth()
+		[
+			SNew(SButton).Text(FText::FromString(TEXT("<"))).ToolTipText(FText::FromString(TEXT("Previous Branch"))).OnClicked_Lambda([this]
+			{
+				OnBranchSwitched.ExecuteIfBound(-1);
+				return FReply::Handled();
+			})
+		]
+		+ SHorizontalBox::Slot().AutoWidth().VAlign(VAlign_Center).Padding(4.f, 0.f)
+		[
+			SNew(STextBlock).Text(BranchText)
+		]
+		+ SHorizontalBox::Slot().AutoWidth()
+		[
+			SNew(SButton).Text(FText::FromString(TEXT(">"))).ToolTipText(FText::FromString(TEXT("Next Branch"))).OnClicked_Lambda([this]
+			{
+				OnBranchSwitched.ExecuteIfBound(1);
+				return FReply::Handled();
+			})
+		];
 }
 
-FString SHttpGPTChatItem::GetMessageText() const
+TSharedRef<SWidget> SHttpGPTChatItem::ConstructActionButton()
 {
-	return Message.IsValid() ? Message->GetText().ToString() : FString();
+	if (ItemData->Role == EHttpGPTChatRole::Assistant && OnRegenerate.IsBound())
+	{
+		return SNew(SButton).Text(FText::FromString(TEXT("Regenerate"))).ToolTipText(FText::FromString(TEXT("Answer Again in a New Branch"))).IsEnabled(
+			IsBranchingEnabled).OnClicked_Lambda([this]
+		{
+			OnRegenerate.ExecuteIfBound();
+			return FReply::Handled();
+		});
+	}
+
+	if (ItemData->Role == EHttpGPTChatRole::User && OnEdited.IsBound())
+	{
+		return SNew(SButton).Text(FText::FromString(TEXT("Edit"))).ToolTipText(FText::FromString(TEXT("Edit and Send in a New Branch"))).IsEnabled(
+			IsBranchingEnabled).OnClicked(this, &SHttpGPTChatItem::HandleEditButton);
+	}
+
+	return SNullWidget::NullWidget;
 }
@@ -6,37 +6,58 @@
 
 #include <CoreMinimal.h>
 #include <Widgets/SCompoundWidget.h>
-#include <Structures/HttpGPTChatTypes.h>
+#include "HttpGPTChatHistory.h"
 
 static const FName NewSessionName = TEXT("New Session");
 
+DECLARE_DELEGATE_OneParam(FHttpGPTChatItemEdited, const FString& /* Content */);
+DECLARE_DELEGATE_OneParam(FHttpGPTChatItemBranchSwitched, const int32 /* Direction */);
+
+/**
+ *
+ */
 class SHttpGPTChatItem final : public SCompoundWidget
 {
 public:
-	SLATE_BEGIN_ARGS(SHttpGPTChatItem) : _MessageRole(), _InputText(), _ScrollBox()
+	SLATE_BEGIN_ARGS(SHttpGPTChatItem) : _ItemData()
 		{
 		}
 
-		SLATE_ARGUMENT(EHttpGPTChatRole, MessageRole)
-		SLATE_ARGUMENT(FString, InputText)
-		SLATE_ARGUMENT(TSharedPtr<class SScrollBox>, ScrollBox)
-	SLATE_END_ARGS()
+		SLATE_ARGUMENT(FHttpGPTChatItemDataPtr, ItemData)
 
-	void Construct(const FArguments& InArgs);
+		/* Position among the alternatives of the message, empty if it has none */
+		SLATE_ATTRIBUTE(FText, BranchText)
+		SLATE_ATTRIBUTE(bool, IsBranchingEnabled)
 
-	FString GetRoleText() const;
-	FString GetMessageText() const;
+		SLATE_EVENT(FSimpleDelegate, OnRegenerate)
+		SLATE_EVENT(FHttpGPTChatItemEdited, OnEdited)
+		SLATE_EVENT(FHttpGPTChatItemBranchSwitched, OnBranchSwitched)
+	SLATE_END_ARGS()
 
-	TWeakObjectPtr<class UHttpGPTMessagingHandler> MessagingHandlerObject;
+	void Construct(const FArguments& InArgs);
+	virtual ~SHttpGPTChatItem() override;
 
 private:
 	TSharedRef<SWidget> ConstructContent();
+	TSharedRef<SWidget> ConstructBranchNavigation();
+	TSharedRef<SWidget> ConstructActionButton();
+
+	void HandleContentChanged(const int32 AppendStart);
+
+	FReply HandleEditButton();
+	void HandleEditCommitted(const FText& NewText, const ETextCommit::Type CommitType);
+
+	FHttpGPTChatItemDataPtr ItemData;
+
+	TAttribute<FText> BranchText;
+	TAttribute<bool> IsBranchingEnabled;
 
-	EHttpGPTChatRole MessageRole;
-	FString InputText;
+	FSimpleDelegate OnRegenerate;
+	FHttpGPTChatItemEdited OnEdited;
+	FHttpGPTChatItemBranchSwitched OnBranchSwitched;
 
-	TSharedPtr<class STextBlock> Role;
 	TSharedPtr<class SMultiLineEditableText> Message;
+	TSharedPtr<class FHttpGPTChatTextMarshaller> MessageMarshaller;
 };
 
 using SHttpGPTChatItemPtr = TSharedPtr<SHttpGPTChatItem>;
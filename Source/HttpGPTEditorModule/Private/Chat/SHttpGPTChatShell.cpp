@@ -4,12 +4,19 @@
 
 #include "SHttpGPTChatShell.h"
 #include "SHttpGPTChatView.h"
+#include "HttpGPTChatJournal.h"
+#include <Management/HttpGPTSettings.h>
+#include <LogHttpGPT.h>
 #include <Widgets/Views/SListView.h>
 #include <Widgets/Text/SInlineEditableTextBlock.h>
 #include <Widgets/Input/STextEntryPopup.h>
+#include <Widgets/Input/SSearchBox.h>
 
 using FOnChatSessionNameChanged = TDelegate<void(FNamePtr, const FName&)>;
 
+// Hits displayed for a query: more specific queries are faster than scrolling a longer list
+static constexpr int32 MaxSearchResults = 100;
+
 class SHttpGPTChatSessionOption : public STableRow<FNamePtr>
 {
 public:
@@ -18,6 +25,7 @@ public:
 		}
 
 		SLATE_EVENT(FOnChatSessionNameChanged, OnNameChanged)
+		SLATE_ATTRIBUTE(FText, StatusText)
 	SLATE_END_ARGS()
 
 	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTableView, const FNamePtr& InItem)
@@ -25,10 +33,20 @@ public:
 		OnNameChanged = InArgs._OnNameChanged;
 		Item = InItem;
 
-		STableRow<FNamePtr>::Construct(
-			STableRow<FNamePtr>::FArguments().Padding(8.f).Content()[SAssignNew(SessionName, STextBlock)
-			.Text(this, &SHttpGPTChatSessionOption::GetName)
-			.ToolTipText(this, &SHttpGPTChatSessionOption::GetName)], InOwnerTableView);
+		STableRow<FNamePtr>::Construct(STableRow<FNamePtr>::FArguments().Padding(8.f).Content()
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot().FillWidth(1.f)
+				[
+					SAssignNew(SessionName, STextBlock)
+					.Text(this, &SHttpGPTChatSessionOption::GetName)
+					.ToolTipText(this, &SHttpGPTChatSessionOption::GetName)
+				]
+				+ SHorizontalBox::Slot().AutoWidth().Padding(4.f, 0.f, 0.f, 0.f)
+				[
+					SNew(STextBlock).Font(FCoreStyle::GetDefaultFontStyle("Italic", 8)).Text(InArgs._StatusText)
+				]
+			], InOwnerTableView);
 	}
 
 	FText GetName() const
@@ -80,25 +98,68 @@ void SHttpGPTChatShell::Construct([[maybe_unused]] const FArguments&)
 		ConstructContent()
 	];
 
+	// Sessions opened below update the index: it must be loaded first
+	FHttpGPTChatSearchIndex::Get().Initialize();
 	InitializeChatSessionOptions();
 }
 
-SHttpGPTChatShell::~SHttpGPTChatShell() = default;
+SHttpGPTChatShell::~SHttpGPTChatShell()
+{
+	// Closed sessions commit their pending messages to the index before it is saved
+	if (ShellBox.IsValid())
+	{
+		ShellBox->SetContent(SNullWidget::NullWidget);
+	}
+
+	CurrentView.Reset();
+	SessionViews.Empty();
+
+	FHttpGPTChatSearchIndex::Get().Save();
+}
 
 TSharedRef<SWidget> SHttpGPTChatShell::ConstructContent()
 {
 	return SNew(SHorizontalBox)
 		+ SHorizontalBox::Slot().FillWidth(0.2f)
 		[
-			SAssignNew(ChatSessionListView, SListView<FNamePtr>)
-			.ListItemsSource(&ChatSessions)
-			.OnGenerateRow(this, &SHttpGPTChatShell::OnGenerateChatSessionRow)
-			.OnSelectionChanged(this, &SHttpGPTChatShell::OnChatSessionSelectionChanged)
-			.SelectionMode(ESelectionMode::Single)
-			.ClearSelectionOnClick(false)
-			.OnMouseButtonDoubleClick(this, &SHttpGPTChatShell::OnChatSessionDoubleClicked)
-			.OnKeyDownHandler(this, &SHttpGPTChatShell::OnChatSessionKeyDown)
-
+			SNew(SVerticalBox)
+			+ SVerticalBox::Slot().AutoHeight().Padding(0.f, 0.f, 0.f, 4.f)
+			[
+				SNew(SSearchBox)
+				.HintText(this, &SHttpGPTChatShell::GetSearchHintText)
+				.OnTextChanged(this, &SHttpGPTChatShell::OnSearchTextChanged)
+			]
+			+ SVerticalBox::Slot().FillHeight(1.f)
+			[
+				SNew(SOverlay)
+				+ SOverlay::Slot()
+				[
+					SAssignNew(ChatSessionListView, SListView<FNamePtr>)
+					.ListItemsSource(&ChatSessions)
+					.OnGenerateRow(this, &SHttpGPTChatShell::OnGenerateChatSessionRow)
+					.OnSelectionChanged(this, &SHttpGPTChatShell::OnChatSessionSelectionChanged)
+					.SelectionMode(ESelectionMode::Single)
+					.ClearSelectionOnClick(false)
+					.OnMouseButtonDoubleClick(this, &SHttpGPTChatShell::OnChatSessionDoubleClicked)
+					.OnKeyDownHandler(this, &SHttpGPTChatShell::OnChatSessionKeyDown)
+					.Visibility_Lambda([this]
+					{
+						return IsSearching() ? EVisibility::Collapsed : EVisibility::Visible;
+					})
+				]
+				+ SOverlay::Slot()
+				[
+					SAssignNew(SearchResultsListView, SListView<FHttpGPTChatSearchHitPtr>)
+					.ListItemsSource(&SearchResults)
+					.OnGenerateRow(this, &SHttpGPTChatShell::OnGenerateSearchResultRow)
+					.SelectionMode(ESelectionMode::Single)
+					.OnMouseButtonClick(this, &SHttpGPTChatShell::OnSearchResultClicked)
+					.Visibility_Lambda([this]
+					{
+						return IsSearching() ? EVisibility::Visible : EVisibility::Collapsed;
+					})
+				]
+			]
 		]
 		+ SHorizontalBox::Slot().FillWidth(0.8f)
 		[
@@ -110,15 +171,19 @@ void SHttpGPTChatShell::InitializeChatSessionOptions()
 {
 	ChatSessions.Empty();
 
-	if (const FString SessionsPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HttpGPT")); FPaths::DirectoryExists(SessionsPath))
+	if (const FString SessionsPath = FHttpGPTChatJournal::GetSessionsPath(); FPaths::DirectoryExists(SessionsPath))
 	{
-		TArray<FString> FoundFiles;
-		IFileManager::Get().FindFilesRecursive(FoundFiles, *SessionsPath, TEXT("*.json"), true, false, true);
+		// The session index avoids reading the directory and the journals
+		TArray<FHttpGPTChatSessionInfo> FoundSessions = FHttpGPTChatJournal::Get().GetSessions();
+		FoundSessions.Sort([](const FHttpGPTChatSessionInfo& Lhs, const FHttpGPTChatSessionInfo& Rhs)
+		{
+			return Lhs.LastModified > Rhs.LastModified;
+		});
 
 		TArray<FString> FoundBaseFileNames;
-		Algo::Transform(FoundFiles, FoundBaseFileNames, [](const FString& Iterator)
+		Algo::Transform(FoundSessions, FoundBaseFileNames, [](const FHttpGPTChatSessionInfo& Iterator)
 		{
-			return FPaths::GetBaseFilename(Iterator);
+			return Iterator.Name.ToString();
 		});
 
 		for (const FString& FileIt : FoundBaseFileNames)
@@ -152,7 +217,10 @@ void SHttpGPTChatShell::InitializeChatSession(const FNamePtr& InItem)
 		return;
 	}
 
-	ShellBox->SetContent(SAssignNew(CurrentView, SHttpGPTChatView).SessionID(*InItem));
+	CurrentView = FindOrCreateSessionView(*InItem);
+	ShellBox->SetContent(CurrentView.ToSharedRef());
+
+	EvictSessionViews();
 
 	if (ChatSessionListView.IsValid())
 	{
@@ -165,9 +233,61 @@ void SHttpGPTChatShell::InitializeChatSession(const FNamePtr& InItem)
 	}
 }
 
+TSharedRef<SHttpGPTChatView> SHttpGPTChatShell::FindOrCreateSessionView(const FName& SessionID)
+{
+	SessionViewsUsage.Remove(SessionID);
+	SessionViewsUsage.Add(SessionID);
+
+	if (const TSharedPtr<SHttpGPTChatView>* const FoundView = SessionViews.Find(SessionID))
+	{
+		return FoundView->ToSharedRef();
+	}
+
+	const TSharedRef<SHttpGPTChatView> NewView = SNew(SHttpGPTChatView).SessionID(SessionID);
+	SessionViews.Add(SessionID, NewView);
+
+	return NewView;
+}
+
+void SHttpGPTChatShell::EvictSessionViews()
+{
+	const int32 MaxViews = FMath::Max(UHttpGPTSettings::Get()->ChatOpenSessions, 1);
+
+	for (int32 Index = 0; Index < SessionViewsUsage.Num() && SessionViews.Num() > MaxViews;)
+	{
+		const FName SessionID = SessionViewsUsage[Index];
+		const TSharedPtr<SHttpGPTChatView> View = SessionViews.FindRef(SessionID);
+
+		// Streaming answers keep running: the session is closed after a later switch
+		if (View.IsValid() && (View == CurrentView || View->HasPendingRequests()))
+		{
+			++Index;
+			continue;
+		}
+
+		UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Closing session %s"), *FString(__FUNCTION__), *SessionID.ToString());
+
+		// Only the messages still pending are journaled, in the background
+		SessionViews.Remove(SessionID);
+		SessionViewsUsage.RemoveAt(Index);
+	}
+}
+
 TSharedRef<ITableRow> SHttpGPTChatShell::OnGenerateChatSessionRow(FNamePtr InItem, const TSharedRef<STableViewBase>& OwnerTable)
 {
-	return SNew(SHttpGPTChatSessionOption, OwnerTable, InItem).OnNameChanged(this, &SHttpGPTChatShell::OnChatSessionNameChanged);
+	return SNew(SHttpGPTChatSessionOption, OwnerTable, InItem).OnNameChanged(this, &SHttpGPTChatShell::OnChatSessionNameChanged).StatusText(
+		this, &SHttpGPTChatShell::GetChatSessionStatus, InItem);
+}
+
+FText SHttpGPTChatShell::GetChatSessionStatus(const FNamePtr InItem) const
+{
+	if (!InItem.IsValid())
+	{
+		return FText::GetEmpty();
+	}
+
+	const TSharedPtr<SHttpGPTChatView> View = SessionViews.FindRef(*InItem);
+	return View.IsValid() ? View->GetStatusText() : FText::GetEmpty();
 }
 
 void SHttpGPTChatShell::OnChatSessionSelectionChanged(const FNamePtr InItem, [[maybe_unused]] ESelectInfo::Type SelectInfo)
@@ -192,20 +312,21 @@ void SHttpGPTChatShell::OnChatSessionNameChanged(const FNamePtr InItem, const FN
 		ChatSessions.EmplaceAt(0, MakeShared<FName>(NewSessionName));
 	}
 
-	if (const FString SessionPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HttpGPT"), InItem->ToString()); FPaths::FileExists(SessionPath))
+	if (TSharedPtr<SHttpGPTChatView> View; SessionViews.RemoveAndCopyValue(*InItem, View) && View.IsValid())
 	{
-		const FString NewPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HttpGPT"), NewName.ToString());
-		IFileManager::Get().Move(*SessionPath, *NewPath, true, true, false, false);
-	}
+		// The view moves its own journal after its queued writes
+		View->SetSessionID(NewName);
 
-	if (!CurrentView.IsValid())
-	{
-		return;
+		SessionViews.Add(NewName, View);
+		SessionViewsUsage.Remove(NewName);
+		SessionViewsUsage.Remove(*InItem);
+		SessionViewsUsage.Add(NewName);
 	}
-
-	if (CurrentView.IsValid() && CurrentView->GetSessionID().IsEqual(*InItem))
+	else
 	{
-		CurrentView->SetSessionID(NewName);
+		FHttpGPTChatJournal::Get().Move(FHttpGPTChatJournal::GetJournalPath(*InItem), FHttpGPTChatJournal::GetJournalPath(NewName));
+		FHttpGPTChatJournal::Get().Move(FHttpGPTChatJournal::GetLegacyPath(*InItem), FHttpGPTChatJournal::GetLegacyPath(NewName));
+		FHttpGPTChatSearchIndex::Get().RenameSession(*InItem, NewName);
 	}
 
 	*InItem = NewName;
@@ -256,16 +377,15 @@ FReply SHttpGPTChatShell::OnChatSessionKeyDown(const FGeometry& MyGeometry, cons
 		return FReply::Unhandled();
 	}
 
-	if (CurrentView.IsValid())
+	if (TSharedPtr<SHttpGPTChatView> View; SessionViews.RemoveAndCopyValue(*SelectedItem, View) && View.IsValid())
 	{
-		CurrentView->ClearChat();
+		View->ClearChat();
+		SessionViewsUsage.Remove(*SelectedItem);
 	}
 
-	if (const FString SessionPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HttpGPT"), SelectedItem->ToString() + TEXT(".json"));
-		FPaths::FileExists(SessionPath))
-	{
-		IFileManager::Get().Delete(*SessionPath, true, true);
-	}
+	FHttpGPTChatJournal::Get().Delete(FHttpGPTChatJournal::GetJournalPath(*SelectedItem));
+	FHttpGPTChatJournal::Get().Delete(FHttpGPTChatJournal::GetLegacyPath(*SelectedItem));
+	FHttpGPTChatSearchIndex::Get().RemoveSession(*SelectedItem);
 
 	if (SelectedItem->IsEqual(NewSessionName) || !ChatSessions.ContainsByPredicate([](const FNamePtr& Item)
 	{
@@ -285,3 +405,67 @@ FReply SHttpGPTChatShell::OnChatSessionKeyDown(const FGeometry& MyGeometry, cons
 
 	return FReply::Handled();
 }
+
+bool SHttpGPTChatShell::IsSearching() const
+{
+	return !SearchQuery.IsEmpty();
+}
+
+FText SHttpGPTChatShell::GetSearchHintText() const
+{
+	return FText::FromString(FHttpGPTChatSearchIndex::Get().IsBuilding() ? TEXT("Indexing sessions...") : TEXT("Search messages"));
+}
+
+void SHttpGPTChatShell::OnSearchTextChanged(const FText& Text)
+{
+	SearchQuery = Text.ToString().TrimStartAndEnd();
+
+	// Queries only read the index: they are fast enough to run on every key stroke
+	SearchResults = IsSearching() ? FHttpGPTChatSearchIndex::Get().Search(SearchQuery, MaxSearchResults) : TArray<FHttpGPTChatSearchHitPtr>();
+
+	if (SearchResultsListView.IsValid())
+	{
+		SearchResultsListView->RequestListRefresh();
+	}
+}
+
+TSharedRef<ITableRow> SHttpGPTChatShell::OnGenerateSearchResultRow(FHttpGPTChatSearchHitPtr InItem, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(STableRow<FHttpGPTChatSearchHitPtr>, OwnerTable).Padding(8.f)
+		[
+			SNew(SVerticalBox)
+			+ SVerticalBox::Slot().AutoHeight()
+			[
+				SNew(STextBlock).Font(FCoreStyle::GetDefaultFontStyle("Bold", 8)).Text(FText::FromName(InItem->SessionID))
+			]
+			+ SVerticalBox::Slot().AutoHeight()
+			[
+				SNew(STextBlock).Text(FText::FromString(InItem->Preview)).ToolTipText(FText::FromString(InItem->Preview))
+			]
+		];
+}
+
+void SHttpGPTChatShell::OnSearchResultClicked(const FHttpGPTChatSearchHitPtr InItem)
+{
+	if (!InItem.IsValid())
+	{
+		return;
+	}
+
+	const FNamePtr* const Session = ChatSessions.FindByPredicate([&InItem](const FNamePtr& Item)
+	{
+		return Item->IsEqual(InItem->SessionID);
+	});
+
+	if (!Session)
+	{
+		return;
+	}
+
+	InitializeChatSession(*Session);
+
+	if (CurrentView.IsValid())
+	{
+		CurrentView->ScrollToMessage(InItem->MessageIndex);
+	}
+}
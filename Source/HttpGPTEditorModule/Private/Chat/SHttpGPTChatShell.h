@@ -6,6 +6,7 @@
 
 #include <CoreMinimal.h>
 #include <Widgets/SCompoundWidget.h>
+#include "HttpGPTChatSearchIndex.h"
 
 using FNamePtr = TSharedPtr<FName>;
 
@@ -27,16 +28,38 @@ private:
 	void InitializeChatSessionOptions();
 	void InitializeChatSession(const FNamePtr& InItem);
 
+	TSharedRef<class SHttpGPTChatView> FindOrCreateSessionView(const FName& SessionID);
+	void EvictSessionViews();
+
 	TSharedPtr<class SBox> ShellBox;
 	TSharedPtr<class SHttpGPTChatView> CurrentView;
 
+	/* Sessions kept alive while they are not displayed, so their requests keep running */
+	TMap<FName, TSharedPtr<class SHttpGPTChatView>> SessionViews;
+
+	/* Least recently displayed session first */
+	TArray<FName> SessionViewsUsage;
+
 	TSharedPtr<class SListView<FNamePtr>> ChatSessionListView;
 	TArray<FNamePtr> ChatSessions;
 
 	TSharedRef<ITableRow> OnGenerateChatSessionRow(FNamePtr InItem, const TSharedRef<STableViewBase>& OwnerTable);
+	FText GetChatSessionStatus(const FNamePtr InItem) const;
 
 	void OnChatSessionSelectionChanged(const FNamePtr InItem, ESelectInfo::Type SelectInfo);
 	void OnChatSessionNameChanged(const FNamePtr InItem, const FName& NewName);
 	void OnChatSessionDoubleClicked(const FNamePtr InItem);
 	FReply OnChatSessionKeyDown(const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent);
+
+	/* Hits of the current query, displayed instead of the sessions while it is not empty */
+	TSharedPtr<class SListView<FHttpGPTChatSearchHitPtr>> SearchResultsListView;
+	TArray<FHttpGPTChatSearchHitPtr> SearchResults;
+	FString SearchQuery;
+
+	bool IsSearching() const;
+	FText GetSearchHintText() const;
+
+	void OnSearchTextChanged(const FText& Text);
+	TSharedRef<ITableRow> OnGenerateSearchResultRow(FHttpGPTChatSearchHitPtr InItem, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnSearchResultClicked(const FHttpGPTChatSearchHitPtr InItem);
 };
@@ -4,17 +4,14 @@
 
 #include "SHttpGPTChatView.h"
 #include "HttpGPTMessagingHandler.h"
+#include "HttpGPTChatJournal.h"
+#include "HttpGPTChatScheduler.h"
 #include <Tasks/HttpGPTChatRequest.h>
 #include <Management/HttpGPTSettings.h>
 #include <Utils/HttpGPTHelper.h>
+#include <Utils/HttpGPTPromptTemplate.h>
 #include <HttpGPTInternalFuncs.h>
 #include <Interfaces/IPluginManager.h>
-#include <Dom/JsonObject.h>
-#include <Serialization/JsonWriter.h>
-#include <Serialization/JsonReader.h>
-#include <Serialization/JsonSerializer.h>
-#include <Misc/FileHelper.h>
-#include <Widgets/Layout/SScrollBox.h>
 #include <Widgets/Input/STextComboBox.h>
 
 void SHttpGPTChatView::Construct(const FArguments& InArgs)
@@ -43,23 +40,53 @@ void SHttpGPTChatView::Construct(const FArguments& InArgs)
 
 SHttpGPTChatView::~SHttpGPTChatView()
 {
+	FHttpGPTChatScheduler::Get().Cancel(this);
 	SaveChatHistory();
 }
 
 bool SHttpGPTChatView::IsSendMessageEnabled() const
 {
-	return (!RequestReference.IsValid() || !UHttpGPTTaskStatus::IsTaskActive(RequestReference.Get())) && !HttpGPT::Internal::HasEmptyParam(
-		InputTextBox->GetText());
+	return !HttpGPT::Internal::HasEmptyParam(InputTextBox->GetText());
 }
 
 bool SHttpGPTChatView::IsClearChatEnabled() const
 {
-	return !HttpGPT::Internal::HasEmptyParam(ChatItems);
+	return ChatHistory.Num() > 0;
+}
+
+bool SHttpGPTChatView::IsRequestActive() const
+{
+	return RequestReference.IsValid() && UHttpGPTTaskStatus::IsTaskActive(RequestReference.Get());
+}
+
+bool SHttpGPTChatView::HasPendingRequests() const
+{
+	return IsRequestActive() || QueuedMessages.Num() > 0 || FHttpGPTChatScheduler::Get().IsQueued(this);
+}
+
+FText SHttpGPTChatView::GetStatusText() const
+{
+	FString Status;
+	if (IsRequestActive())
+	{
+		Status = TEXT("Streaming");
+	}
+	else if (FHttpGPTChatScheduler::Get().IsQueued(this))
+	{
+		Status = TEXT("Waiting");
+	}
+
+	if (QueuedMessages.Num() > 0)
+	{
+		Status += FString::Printf(TEXT(" (+%d)"), QueuedMessages.Num());
+	}
+
+	return FText::FromString(Status.TrimStart());
 }
 
 FString SHttpGPTChatView::GetHistoryPath() const
 {
-	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HttpGPT"), SessionID.ToString() + TEXT(".json"));
+	return FHttpGPTChatJournal::GetJournalPath(SessionID);
 }
 
 void SHttpGPTChatView::SetSessionID(const FName& NewSessionID)
@@ -76,13 +103,8 @@ void SHttpGPTChatView::SetSessionID(const FName& NewSessionID)
 		return;
 	}
 
-	if (const FString OldPath = GetHistoryPath(); FPaths::FileExists(OldPath))
-	{
-		IFileManager::Get().Delete(*OldPath, true, true, true);
-	}
-
 	SessionID = NewValidSessionID;
-	SaveChatHistory();
+	ChatHistory.MoveJournal(GetHistoryPath());
 }
 
 FName SHttpGPTChatView::GetSessionID() const
@@ -92,10 +114,13 @@ FName SHttpGPTChatView::GetSessionID() const
 
 void SHttpGPTChatView::ClearChat()
 {
-	ChatItems.Empty();
-	if (ChatBox.IsValid())
+	QueuedMessages.Empty();
+	FHttpGPTChatScheduler::Get().Cancel(this);
+
+	ChatHistory.Empty();
+	if (ChatListView.IsValid())
 	{
-		ChatBox->ClearChildren();
+		ChatListView->RequestListRefresh();
 	}
 
 	if (RequestReference.IsValid())
@@ -112,11 +137,11 @@ TSharedRef<SWidget> SHttpGPTChatView::ConstructContent()
 	return SNew(SVerticalBox)
 		+ SVerticalBox::Slot().Padding(SlotPadding).FillHeight(1.f)
 		[
-			SAssignNew(ChatScrollBox, SScrollBox)
-			+ SScrollBox::Slot()
-			[
-				SAssignNew(ChatBox, SVerticalBox)
-			]
+			SAssignNew(ChatListView, SListView<FHttpGPTChatItemDataPtr>)
+			.ListItemsSource(&ChatHistory.GetItems())
+			.SelectionMode(ESelectionMode::None)
+			.OnGenerateRow(this, &SHttpGPTChatView::OnGenerateChatRow)
+			.OnListViewScrolled(this, &SHttpGPTChatView::OnChatListScrolled)
 		]
 		+ SVerticalBox::Slot().Padding(SlotPadding).AutoHeight()
 		[
@@ -165,191 +190,352 @@ TSharedRef<SWidget> SHttpGPTChatView::ConstructContent()
 
 FReply SHttpGPTChatView::HandleSendMessageButton(const EHttpGPTChatRole Role)
 {
-	const SHttpGPTChatItemPtr NewMessage = SNew(SHttpGPTChatItem).MessageRole(Role).InputText(InputTextBox->GetText().ToString());
-
-	ChatBox->AddSlot().AutoHeight()[NewMessage.ToSharedRef()];
-	ChatItems.Add(NewMessage);
+	const FString Content = InputTextBox->GetText().ToString();
+	InputTextBox->SetText(FText::GetEmpty());
 
 	if (Role == EHttpGPTChatRole::System)
 	{
-		ChatScrollBox->ScrollToEnd();
-		InputTextBox->SetText(FText::GetEmpty());
-
+		AddChatItem(Role, Content);
 		return FReply::Handled();
 	}
 
-	const SHttpGPTChatItemPtr AssistantMessage = SNew(SHttpGPTChatItem).MessageRole(EHttpGPTChatRole::Assistant).ScrollBox(ChatScrollBox);
+	FQueuedMessage NewMessage;
+	NewMessage.Content = Content;
+	NewMessage.Model = GetSelectedModel();
+
+	// Follow-up messages wait for the previous answer, so every answer is displayed right after its message
+	QueuedMessages.Add(MoveTemp(NewMessage));
+	SendNextMessage();
+
+	return FReply::Handled();
+}
+
+void SHttpGPTChatView::SendNextMessage()
+{
+	if (QueuedMessages.Num() <= 0 || IsRequestActive() || FHttpGPTChatScheduler::Get().IsQueued(this))
+	{
+		return;
+	}
+
+	const FQueuedMessage Message = QueuedMessages[0];
+	QueuedMessages.RemoveAt(0);
+
+	const FHttpGPTChatItemDataPtr Prompt = AddChatItem(EHttpGPTChatRole::User, Message.Content);
+
+	FHttpGPTChatScheduler::Get().Enqueue(this, FHttpGPTChatSchedulerStart::CreateSP(this, &SHttpGPTChatView::StartRequest, Message.Model, Prompt));
+}
+
+EHttpGPTChatModel SHttpGPTChatView::GetSelectedModel() const
+{
+	return UHttpGPTHelper::NameToModel(*(*ModelsComboBox->GetSelectedItem().Get()));
+}
+
+UHttpGPTBaseTask* SHttpGPTChatView::StartRequest(const EHttpGPTChatModel Model, const FHttpGPTChatItemDataPtr Prompt)
+{
+	// The answer follows its prompt, in the branch selected when the prompt was sent
+	if (ChatHistory.GetMessage(Prompt->Index) != Prompt)
+	{
+		return nullptr;
+	}
+
+	ChatHistory.SetHead(Prompt->Index);
+	ChatListView->RequestListRefresh();
+
+	// The request needs the whole branch, including the messages not displayed yet
+	if (ChatHistory.HasEarlierMessages())
+	{
+		ChatHistory.LoadAllMessages();
+	}
+
+	// The history is read before adding the message that will receive the response
+	const TArray<FHttpGPTChatMessage> Messages = GetChatHistory();
+	const FHttpGPTChatItemDataPtr AssistantMessage = AddChatItem(EHttpGPTChatRole::Assistant, FString());
+
+	UHttpGPTMessagingHandler* const MessagingHandler = NewObject<UHttpGPTMessagingHandler>();
+	MessagingHandler->SetFlags(RF_Standalone);
+	MessagingHandler->OnMessageContentUpdated.BindSPLambda(this, [this, AssistantMessage](const FString& Content)
+	{
+		UpdateChatItem(AssistantMessage, Content);
+	});
+	MessagingHandler->OnMessageCompleted.BindSPLambda(this, [this, AssistantMessage]
+	{
+		ChatHistory.Commit(AssistantMessage);
+
+		// The task is still active while it notifies its end
+		RequestReference.Reset();
+		SendNextMessage();
+	});
 
 	FHttpGPTChatOptions Options;
-	Options.Model = UHttpGPTHelper::NameToModel(*(*ModelsComboBox->GetSelectedItem().Get()));
+	Options.Model = Model;
 	Options.bStream = true;
 
-	RequestReference = UHttpGPTChatRequest::EditorTask(GetChatHistory(), Options);
-	RequestReference->ProgressStarted.AddDynamic(AssistantMessage->MessagingHandlerObject.Get(), &UHttpGPTMessagingHandler::ProcessUpdated);
-	RequestReference->ProgressUpdated.AddDynamic(AssistantMessage->MessagingHandlerObject.Get(), &UHttpGPTMessagingHandler::ProcessUpdated);
-	RequestReference->ProcessCompleted.AddDynamic(AssistantMessage->MessagingHandlerObject.Get(), &UHttpGPTMessagingHandler::ProcessCompleted);
-	RequestReference->ErrorReceived.AddDynamic(AssistantMessage->MessagingHandlerObject.Get(), &UHttpGPTMessagingHandler::ProcessCompleted);
-	RequestReference->RequestFailed.AddDynamic(AssistantMessage->MessagingHandlerObject.Get(), &UHttpGPTMessagingHandler::RequestFailed);
-	RequestReference->RequestSent.AddDynamic(AssistantMessage->MessagingHandlerObject.Get(), &UHttpGPTMessagingHandler::RequestSent);
+	RequestReference = UHttpGPTChatRequest::EditorTask(Messages, Options);
+	RequestReference->ProgressStarted.AddDynamic(MessagingHandler, &UHttpGPTMessagingHandler::ProcessUpdated);
+	RequestReference->ProgressUpdated.AddDynamic(MessagingHandler, &UHttpGPTMessagingHandler::ProcessUpdated);
+	RequestReference->ProcessCompleted.AddDynamic(MessagingHandler, &UHttpGPTMessagingHandler::ProcessCompleted);
+	RequestReference->ErrorReceived.AddDynamic(MessagingHandler, &UHttpGPTMessagingHandler::ProcessCompleted);
+	RequestReference->RequestFailed.AddDynamic(MessagingHandler, &UHttpGPTMessagingHandler::RequestFailed);
+	RequestReference->RequestSent.AddDynamic(MessagingHandler, &UHttpGPTMessagingHandler::RequestSent);
 	RequestReference->Activate();
 
-	ChatBox->AddSlot().AutoHeight()[AssistantMessage.ToSharedRef()];
-	ChatItems.Add(AssistantMessage);
-
-	ChatScrollBox->ScrollToEnd();
-	InputTextBox->SetText(FText::GetEmpty());
+	return RequestReference.Get();
+}
 
-	return FReply::Handled();
+TSharedRef<ITableRow> SHttpGPTChatView::OnGenerateChatRow(FHttpGPTChatItemDataPtr Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(STableRow<FHttpGPTChatItemDataPtr>, OwnerTable).ShowSelection(false)
+		[
+			SNew(SHttpGPTChatItem).ItemData(Item)
+			.BranchText(this, &SHttpGPTChatView::GetBranchText, Item)
+			.IsBranchingEnabled(this, &SHttpGPTChatView::IsBranchingEnabled)
+			.OnRegenerate(this, &SHttpGPTChatView::RegenerateMessage, Item)
+			.OnEdited(this, &SHttpGPTChatView::EditMessage, Item)
+			.OnBranchSwitched(this, &SHttpGPTChatView::SwitchBranch, Item)
+		];
 }
 
-FReply SHttpGPTChatView::HandleClearChatButton()
+bool SHttpGPTChatView::IsBranchingEnabled() const
 {
-	ClearChat();
-	return FReply::Handled();
+	return !HasPendingRequests();
 }
 
-TArray<FHttpGPTChatMessage> SHttpGPTChatView::GetChatHistory() const
+FText SHttpGPTChatView::GetBranchText(const FHttpGPTChatItemDataPtr Item) const
 {
-	TArray<FHttpGPTChatMessage> Output{FHttpGPTChatMessage(EHttpGPTChatRole::System, GetDefaultSystemContext())};
+	int32 Branch = 0;
+	int32 NumBranches = 1;
+	ChatHistory.GetBranches(Item, Branch, NumBranches);
+
+	return NumBranches > 1 ? FText::FromString(FString::Printf(TEXT("%d/%d"), Branch + 1, NumBranches)) : FText::GetEmpty();
+}
 
-	for (const SHttpGPTChatItemPtr& Item : ChatItems)
+void SHttpGPTChatView::RegenerateMessage(const FHttpGPTChatItemDataPtr Item)
+{
+	if (!IsBranchingEnabled() || Item->Parent == INDEX_NONE)
 	{
-		FString RoleText = Item->GetRoleText();
-		RoleText.RemoveFromEnd(TEXT(":"));
-		Output.Add(FHttpGPTChatMessage(*RoleText, Item->GetMessageText()));
+		return;
 	}
 
-	return Output;
+	// The new answer is added after the same prompt, next to the previous one
+	if (const FHttpGPTChatItemDataPtr Prompt = ChatHistory.LoadMessage(Item->Parent); Prompt.IsValid())
+	{
+		FHttpGPTChatScheduler::Get().Enqueue(this, FHttpGPTChatSchedulerStart::CreateSP(this, &SHttpGPTChatView::StartRequest, GetSelectedModel(), Prompt));
+	}
 }
 
-FString SHttpGPTChatView::GetDefaultSystemContext() const
+void SHttpGPTChatView::EditMessage(const FString& Content, const FHttpGPTChatItemDataPtr Item)
 {
-	if (const UHttpGPTSettings* const Settings = UHttpGPTSettings::Get(); Settings->bUseCustomSystemContext)
+	if (!IsBranchingEnabled())
 	{
-		return Settings->CustomSystemContext;
+		return;
 	}
 
-	FString SupportedModels;
-	for (const TSharedPtr<FString>& Model : AvailableModels)
+	// The edited message follows the same messages as the original one, which stays in its own branch
+	if (Item->Parent != INDEX_NONE && !ChatHistory.LoadMessage(Item->Parent).IsValid())
 	{
-		SupportedModels.Append(*Model.Get() + ", ");
+		return;
 	}
-	SupportedModels.RemoveFromEnd(", ");
 
-	const TSharedPtr<IPlugin> PluginInterface = IPluginManager::Get().FindPlugin("HttpGPT");
+	ChatHistory.SetHead(Item->Parent);
 
-	const FString PluginShortName = "HttpGPT";
-	const FString EngineVersion = FString::Printf(TEXT("%d.%d"), ENGINE_MAJOR_VERSION, ENGINE_MINOR_VERSION);
+	const FHttpGPTChatItemDataPtr Prompt = AddChatItem(EHttpGPTChatRole::User, Content);
+	FHttpGPTChatScheduler::Get().Enqueue(this, FHttpGPTChatSchedulerStart::CreateSP(this, &SHttpGPTChatView::StartRequest, GetSelectedModel(), Prompt));
+}
 
-	const FStringFormatOrderedArguments Arguments_PluginInfo{
-		EngineVersion, PluginShortName, PluginInterface->GetDescriptor().VersionName, PluginInterface->GetDescriptor().CreatedBy,
-		PluginInterface->GetDescriptor().Description
-	};
+void SHttpGPTChatView::SwitchBranch(const int32 Direction, const FHttpGPTChatItemDataPtr Item)
+{
+	if (!IsBranchingEnabled())
+	{
+		return;
+	}
 
-	const FString PluginInformation = FString::Format(
-		TEXT("You are in the Unreal Engine {0} plugin {1} version {2}, which was developed by {3}. The description of HttpGPT is: \"{4}\""),
-		Arguments_PluginInfo);
+	ChatHistory.SwitchBranch(Item, Direction);
+	ChatListView->RequestListRefresh();
+}
 
-	const FStringFormatOrderedArguments Arguments_SupportInfo{PluginInterface->GetDescriptor().DocsURL, PluginInterface->GetDescriptor().SupportURL,};
+FHttpGPTChatItemDataPtr SHttpGPTChatView::AddChatItem(const EHttpGPTChatRole Role, const FString& Content)
+{
+	const FHttpGPTChatItemDataPtr Item = ChatHistory.Add(Role, Content);
 
-	const FString PluginSupport = FString::Format(TEXT("You can find the HttpGPT documentation at {0} and support at {1}."), Arguments_SupportInfo);
+	ChatListView->RequestListRefresh();
+	RequestScrollToEnd();
 
-	const FStringFormatOrderedArguments Arguments_Models{*ModelsComboBox->GetSelectedItem().Get(), SupportedModels};
+	return Item;
+}
 
-	const FString ModelsInformation = FString::Format(
-		TEXT("You're using the model {0} and HttpGPT currently supports all these OpenAI Models: {1}."), Arguments_Models);
+void SHttpGPTChatView::UpdateChatItem(const FHttpGPTChatItemDataPtr& Item, const FString& Content)
+{
+	// Only follow the response if the user didn't scroll up to read the previous messages
+	const bool bScrollToEnd = IsScrolledToEnd();
 
-	const FStringFormatOrderedArguments Arguments_EngineDocumentation{EngineVersion};
+	ChatHistory.Update(Item, Content);
 
-	const FString EngineDocumentation_General = FString::Format(
-		TEXT("You can find the Unreal Engine {0} general documentation at https://docs.unrealengine.com/{0}/en-US/."), Arguments_EngineDocumentation);
-	const FString EngineDocumentation_CPP = FString::Format(
-		TEXT("You can find the Unreal Engine {0} API documentation for C++ at https://docs.unrealengine.com/{0}/en-US/API/."),
-		Arguments_EngineDocumentation);
-	const FString EngineDocumentation_BP = FString::Format(
-		TEXT("You can find the Unreal Engine {0} API documentation for Blueprints at https://docs.unrealengine.com/{0}/en-US/BlueprintAPI/."),
-		Arguments_EngineDocumentation);
+	if (bScrollToEnd)
+	{
+		RequestScrollToEnd();
+	}
+}
+
+void SHttpGPTChatView::RequestScrollToEnd()
+{
+	ScrollTarget.Reset();
+	RequestScroll();
+}
+
+void SHttpGPTChatView::ScrollToMessage(const int32 MessageIndex)
+{
+	const FHttpGPTChatItemDataPtr Item = ChatHistory.LoadMessage(MessageIndex);
+	if (!Item.IsValid())
+	{
+		return;
+	}
 
-	const FStringFormatOrderedArguments Arguments_SystemContext{
-		PluginInformation, PluginSupport, ModelsInformation, EngineDocumentation_General, EngineDocumentation_CPP, EngineDocumentation_BP
-	};
+	ChatListView->RequestListRefresh();
 
-	return FString::Format(
-		TEXT("You are an assistant that will help with the development of projects in Unreal Engine in general.\n{0}\n{1}\n{2}\n{3}\n{4}\n{5}"),
-		Arguments_SystemContext);
+	ScrollTarget = Item;
+	RequestScroll();
 }
 
-void SHttpGPTChatView::LoadChatHistory()
+void SHttpGPTChatView::RequestScroll()
 {
-	if (SessionID.IsNone())
+	if (bScrollPending)
 	{
 		return;
 	}
 
-	if (const FString LoadPath = GetHistoryPath(); FPaths::FileExists(LoadPath))
+	// Several updates may arrive in the same frame: scroll only once, before the next paint
+	bScrollPending = true;
+	RegisterActiveTimer(0.f, FWidgetActiveTimerDelegate::CreateSP(this, &SHttpGPTChatView::HandlePendingScroll));
+}
+
+EActiveTimerReturnType SHttpGPTChatView::HandlePendingScroll([[maybe_unused]] const double CurrentTime, [[maybe_unused]] const float DeltaTime)
+{
+	bScrollPending = false;
+
+	if (ChatListView.IsValid())
 	{
-		FString FileContent;
-		if (!FFileHelper::LoadFileToString(FileContent, *LoadPath))
+		if (ScrollTarget.IsValid())
 		{
-			return;
+			ChatListView->RequestScrollIntoView(ScrollTarget);
+			ScrollTarget.Reset();
 		}
-
-		TSharedPtr<FJsonObject> JsonParsed;
-		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContent);
-		if (FJsonSerializer::Deserialize(Reader, JsonParsed))
+		else
 		{
-			const TArray<TSharedPtr<FJsonValue>> SessionData = JsonParsed->GetArrayField(TEXT("Data"));
-			for (const TSharedPtr<FJsonValue>& Item : SessionData)
-			{
-				if (const TSharedPtr<FJsonObject> MessageItObj = Item->AsObject())
-				{
-					if (FString RoleString; MessageItObj->TryGetStringField(TEXT("role"), RoleString))
-					{
-						const EHttpGPTChatRole Role = UHttpGPTHelper::NameToRole(*RoleString);
+			ChatListView->ScrollToBottom();
+		}
+	}
 
-						if (FString Message; MessageItObj->TryGetStringField(TEXT("content"), Message))
-						{
-							if (Role == EHttpGPTChatRole::System && Message == GetDefaultSystemContext())
-							{
-								continue;
-							}
+	return EActiveTimerReturnType::Stop;
+}
 
-							ChatItems.Emplace(SNew(SHttpGPTChatItem).MessageRole(Role).InputText(Message).ScrollBox(ChatScrollBox));
-						}
-					}
-				}
-			}
-		}
+void SHttpGPTChatView::OnChatListScrolled(const double ScrollOffset)
+{
+	if (ScrollOffset > 0.0 || !ChatHistory.HasEarlierMessages())
+	{
+		return;
 	}
 
-	for (const SHttpGPTChatItemPtr& Item : ChatItems)
+	// Keep the messages being displayed in place while the earlier ones are added above them
+	if (const int32 LoadedMessages = ChatHistory.LoadEarlierMessages(UHttpGPTSettings::Get()->ChatHistoryPageSize); LoadedMessages > 0)
 	{
-		ChatBox->AddSlot().AutoHeight()[Item.ToSharedRef()];
+		ChatListView->RequestListRefresh();
+		ChatListView->SetScrollOffset(static_cast<float>(LoadedMessages));
 	}
 }
 
-void SHttpGPTChatView::SaveChatHistory() const
+bool SHttpGPTChatView::IsScrolledToEnd() const
 {
-	if (SessionID.IsNone() || ChatItems.IsEmpty())
+	// Distance in items: the last message may be partially visible while it is streamed
+	return ChatListView.IsValid() && ChatListView->GetScrollDistanceRemaining().Y <= 1.f;
+}
+
+FReply SHttpGPTChatView::HandleClearChatButton()
+{
+	ClearChat();
+	return FReply::Handled();
+}
+
+TArray<FHttpGPTChatMessage> SHttpGPTChatView::GetChatHistory() const
+{
+	return ChatHistory.GetMessages(GetDefaultSystemContext());
+}
+
+// Only the model changes between sessions: the other variables are computed once
+static const TMap<FName, FString>& GetSystemContextVariables()
+{
+	static const TMap<FName, FString> Variables = []
 	{
-		return;
-	}
+		FString SupportedModels;
+		for (const FName& ModelName : UHttpGPTHelper::GetAvailableGPTModels())
+		{
+			SupportedModels.Append(ModelName.ToString() + ", ");
+		}
+		SupportedModels.RemoveFromEnd(", ");
 
-	const TSharedPtr<FJsonObject> JsonRequest = MakeShared<FJsonObject>();
+		const TSharedPtr<IPlugin> PluginInterface = IPluginManager::Get().FindPlugin("HttpGPT");
+		const FPluginDescriptor& Descriptor = PluginInterface->GetDescriptor();
 
-	TArray<TSharedPtr<FJsonValue>> Data;
-	for (const FHttpGPTChatMessage& Item : GetChatHistory())
+		return TMap<FName, FString>{
+			{"EngineVersion", FString::Printf(TEXT("%d.%d"), ENGINE_MAJOR_VERSION, ENGINE_MINOR_VERSION)}, {"PluginName", TEXT("HttpGPT")},
+			{"PluginVersion", Descriptor.VersionName}, {"PluginAuthor", Descriptor.CreatedBy}, {"PluginDescription", Descriptor.Description},
+			{"DocsURL", Descriptor.DocsURL}, {"SupportURL", Descriptor.SupportURL}, {"SupportedModels", SupportedModels}
+		};
+	}();
+
+	return Variables;
+}
+
+FString SHttpGPTChatView::GetDefaultSystemContext() const
+{
+	static const FHttpGPTPromptTemplateRef DefaultTemplate = FHttpGPTPromptTemplate::Find(
+		TEXT("You are an assistant that will help with the development of projects in Unreal Engine in general.\n")
+		TEXT("You are in the Unreal Engine {EngineVersion} plugin {PluginName} version {PluginVersion}, which was developed by {PluginAuthor}. ")
+		TEXT("The description of HttpGPT is: \"{PluginDescription}\"\n")
+		TEXT("You can find the HttpGPT documentation at {DocsURL} and support at {SupportURL}.\n")
+		TEXT("You're using the model {Model} and HttpGPT currently supports all these OpenAI Models: {SupportedModels}.\n")
+		TEXT("You can find the Unreal Engine {EngineVersion} general documentation at https://docs.unrealengine.com/{EngineVersion}/en-US/.\n")
+		TEXT("You can find the Unreal Engine {EngineVersion} API documentation for C++ at https://docs.unrealengine.com/{EngineVersion}/en-US/API/.\n")
+		TEXT("You can find the Unreal Engine {EngineVersion} API documentation for Blueprints at https://docs.unrealengine.com/{EngineVersion}/en-US/BlueprintAPI/."));
+
+	const UHttpGPTSettings* const Settings = UHttpGPTSettings::Get();
+	const FHttpGPTPromptTemplateRef Template = Settings->bUseCustomSystemContext ? FHttpGPTPromptTemplate::Find(Settings->CustomSystemContext) : DefaultTemplate;
+
+	const FString Model = *ModelsComboBox->GetSelectedItem().Get();
+	const TMap<FName, FString>& Variables = GetSystemContextVariables();
+
+	return Template->Render([&Model, &Variables](const FName& Name)
 	{
-		Data.Add(Item.GetMessage());
-	}
+		return Name == "Model" ? &Model : Variables.Find(Name);
+	});
+}
 
-	JsonRequest->SetArrayField("Data", Data);
+void SHttpGPTChatView::LoadChatHistory()
+{
+	if (SessionID.IsNone())
+	{
+		return;
+	}
 
-	FString RequestContentString;
-	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestContentString);
+	ChatHistory.Open(GetHistoryPath(), UHttpGPTSettings::Get()->ChatHistoryPageSize);
 
-	if (FJsonSerializer::Serialize(JsonRequest.ToSharedRef(), Writer))
+	// Convert the sessions saved before the journal: the loaded messages are journaled as they are added
+	if (const FString LegacyPath = FHttpGPTChatJournal::GetLegacyPath(SessionID); FPaths::FileExists(LegacyPath))
 	{
-		FFileHelper::SaveStringToFile(RequestContentString, *GetHistoryPath());
+		if (ChatHistory.Num() <= 0)
+		{
+			ChatHistory.LoadFromFile(LegacyPath, GetDefaultSystemContext());
+		}
+
+		// Queued after the journal records of the loaded messages, so the session is never lost if the editor exits in between
+		FHttpGPTChatJournal::Get().Delete(LegacyPath);
 	}
+
+	ChatListView->RequestListRefresh();
+	RequestScrollToEnd();
+}
+
+void SHttpGPTChatView::SaveChatHistory()
+{
+	// Messages are journaled as they are added: only the content still being streamed is pending
+	ChatHistory.CommitAll();
 }
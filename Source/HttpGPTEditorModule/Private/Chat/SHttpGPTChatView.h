@@ -7,6 +7,7 @@
 #include <CoreMinimal.h>
 #include <Structures/HttpGPTChatTypes.h>
 #include <Widgets/SCompoundWidget.h>
+#include <Widgets/Views/SListView.h>
 #include "SHttpGPTChatItem.h"
 
 class SHttpGPTChatView final : public SCompoundWidget
@@ -25,6 +26,11 @@ public:
 
 	bool IsSendMessageEnabled() const;
 	bool IsClearChatEnabled() const;
+	bool IsRequestActive() const;
+
+	/* Running, waiting for the scheduler or follow-up messages not sent yet */
+	bool HasPendingRequests() const;
+	FText GetStatusText() const;
 	FString GetHistoryPath() const;
 
 	void SetSessionID(const FName& NewSessionID);
@@ -32,23 +38,56 @@ public:
 
 	void ClearChat();
 
+	/* Load the message if needed and scroll it into view */
+	void ScrollToMessage(const int32 MessageIndex);
+
 private:
 	TSharedRef<SWidget> ConstructContent();
 
 	FReply HandleSendMessageButton(const EHttpGPTChatRole Role);
+
+	void SendNextMessage();
+	class UHttpGPTBaseTask* StartRequest(const EHttpGPTChatModel Model, const FHttpGPTChatItemDataPtr Prompt);
+	EHttpGPTChatModel GetSelectedModel() const;
 	FReply HandleClearChatButton();
 
+	TSharedRef<ITableRow> OnGenerateChatRow(FHttpGPTChatItemDataPtr Item, const TSharedRef<STableViewBase>& OwnerTable);
+
+	/* Branches can't change while an answer is being added to the selected one */
+	bool IsBranchingEnabled() const;
+	FText GetBranchText(const FHttpGPTChatItemDataPtr Item) const;
+
+	void RegenerateMessage(const FHttpGPTChatItemDataPtr Item);
+	void EditMessage(const FString& Content, const FHttpGPTChatItemDataPtr Item);
+	void SwitchBranch(const int32 Direction, const FHttpGPTChatItemDataPtr Item);
+
+	FHttpGPTChatItemDataPtr AddChatItem(const EHttpGPTChatRole Role, const FString& Content);
+	void UpdateChatItem(const FHttpGPTChatItemDataPtr& Item, const FString& Content);
+	void OnChatListScrolled(const double ScrollOffset);
+	bool IsScrolledToEnd() const;
+
+	void RequestScrollToEnd();
+	void RequestScroll();
+	EActiveTimerReturnType HandlePendingScroll(const double CurrentTime, const float DeltaTime);
+
 	TArray<FHttpGPTChatMessage> GetChatHistory() const;
 	FString GetDefaultSystemContext() const;
 
 	void LoadChatHistory();
-	void SaveChatHistory() const;
+	void SaveChatHistory();
 
 	FName SessionID;
 
-	TSharedPtr<class SVerticalBox> ChatBox;
-	TArray<SHttpGPTChatItemPtr> ChatItems;
-	TSharedPtr<class SScrollBox> ChatScrollBox;
+	/* The widgets only display the history: requests and saves read it directly */
+	FHttpGPTChatHistory ChatHistory;
+
+	/* Only the visible messages are realized as widgets */
+	TSharedPtr<SListView<FHttpGPTChatItemDataPtr>> ChatListView;
+
+	bool bScrollPending = false;
+
+	/* Message to scroll into view instead of the end of the list */
+	FHttpGPTChatItemDataPtr ScrollTarget;
 
 	TSharedPtr<class SEditableTextBox> InputTextBox;
 
@@ -56,4 +95,13 @@ private:
 	TArray<TSharedPtr<FString>> AvailableModels;
 
 	TWeakObjectPtr<class UHttpGPTChatRequest> RequestReference;
+
+	struct FQueuedMessage
+	{
+		FString Content;
+		EHttpGPTChatModel Model = EHttpGPTChatModel::gpt35turbo;
+	};
+
+	/* Messages sent while the previous answer was still streaming */
+	TArray<FQueuedMessage> QueuedMessages;
 };
@@ -5,6 +5,7 @@
 #include "HttpGPTEditorModule.h"
 #include "Chat/SHttpGPTChatShell.h"
 #include "ImageGen/SHttpGPTImageGenView.h"
+#include "Chat/HttpGPTChatJournal.h"
 #include <ToolMenus.h>
 #include <Widgets/Docking/SDockTab.h>
 #include <WorkspaceMenuStructure.h>
@@ -27,6 +28,9 @@ void FHttpGPTEditorModule::ShutdownModule()
 	UToolMenus::UnregisterOwner(this);
 
 	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(HttpGPTChatTabName);
+
+	// Write the queued chat messages while the thread pool is still running
+	FHttpGPTChatJournal::Get().Flush();
 }
 
 TSharedRef<SDockTab> FHttpGPTEditorModule::OnSpawnTab(const FSpawnTabArgs& SpawnTabArgs) const
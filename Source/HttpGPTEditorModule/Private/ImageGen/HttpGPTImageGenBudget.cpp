@@ -0,0 +1,78 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "HttpGPTImageGenBudget.h"
+#include <Management/HttpGPTSettings.h>
+#include <LogHttpGPT.h>
+
+FHttpGPTImageGenBudget& FHttpGPTImageGenBudget::Get()
+{
+	static FHttpGPTImageGenBudget Instance;
+	return Instance;
+}
+
+void FHttpGPTImageGenBudget::Add(const void* const Owner, const SIZE_T Size, const FSimpleDelegate& OnEvicted)
+{
+	check(IsInGameThread());
+
+	Remove(Owner);
+
+	const SIZE_T MaxSize = static_cast<SIZE_T>(FMath::Max(UHttpGPTSettings::Get()->ImageGenTextureBudget, 1)) * 1024u * 1024u;
+
+	// Always keep the newest texture, even if it alone exceeds the budget
+	EvictUntil(Size < MaxSize ? MaxSize - Size : 0u);
+
+	UsageList.AddHead(Owner);
+
+	FEntry NewEntry;
+	NewEntry.Size = Size;
+	NewEntry.OnEvicted = OnEvicted;
+	NewEntry.Node = UsageList.GetHead();
+
+	CurrentSize += Size;
+	Entries.Add(Owner, MoveTemp(NewEntry));
+
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Image generator textures are using %llu bytes"), *FString(__FUNCTION__), static_cast<uint64>(CurrentSize));
+}
+
+void FHttpGPTImageGenBudget::Touch(const void* const Owner)
+{
+	check(IsInGameThread());
+
+	if (FEntry* const Entry = Entries.Find(Owner))
+	{
+		UsageList.RemoveNode(Entry->Node);
+		UsageList.AddHead(Owner);
+		Entry->Node = UsageList.GetHead();
+	}
+}
+
+void FHttpGPTImageGenBudget::Remove(const void* const Owner)
+{
+	check(IsInGameThread());
+
+	if (const FEntry* const Entry = Entries.Find(Owner))
+	{
+		CurrentSize -= Entry->Size;
+		UsageList.RemoveNode(Entry->Node);
+		Entries.Remove(Owner);
+	}
+}
+
+SIZE_T FHttpGPTImageGenBudget::GetCurrentSize() const
+{
+	return CurrentSize;
+}
+
+void FHttpGPTImageGenBudget::EvictUntil(const SIZE_T MaxSize)
+{
+	while (CurrentSize > MaxSize && UsageList.GetTail())
+	{
+		const void* const LeastRecentOwner = UsageList.GetTail()->GetValue();
+		const FSimpleDelegate OnEvicted = Entries.FindChecked(LeastRecentOwner).OnEvicted;
+
+		Remove(LeastRecentOwner);
+		OnEvicted.ExecuteIfBound();
+	}
+}
@@ -0,0 +1,46 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Containers/List.h>
+
+/**
+ *
+ */
+class FHttpGPTImageGenBudget
+{
+public:
+	static FHttpGPTImageGenBudget& Get();
+
+	/* Track a full resolution texture. The owner is notified to release it when the budget is exceeded */
+	void Add(const void* const Owner, const SIZE_T Size, const FSimpleDelegate& OnEvicted);
+
+	/* Mark the texture as the most recently used one */
+	void Touch(const void* const Owner);
+
+	void Remove(const void* const Owner);
+
+	SIZE_T GetCurrentSize() const;
+
+private:
+	using FOwnerList = TDoubleLinkedList<const void*>;
+
+	struct FEntry
+	{
+		SIZE_T Size = 0u;
+		FSimpleDelegate OnEvicted;
+		FOwnerList::TDoubleLinkedListNode* Node = nullptr;
+	};
+
+	void EvictUntil(const SIZE_T MaxSize);
+
+	TMap<const void*, FEntry> Entries;
+
+	/* Head is the most recently used texture */
+	FOwnerList UsageList;
+
+	SIZE_T CurrentSize = 0u;
+};
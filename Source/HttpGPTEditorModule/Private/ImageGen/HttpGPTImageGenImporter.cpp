@@ -0,0 +1,273 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "HttpGPTImageGenImporter.h"
+#include <Management/HttpGPTImageCache.h>
+#include <Management/HttpGPTSettings.h>
+#include <LogHttpGPT.h>
+
+#include <Async/Async.h>
+#include <Engine/Texture2D.h>
+#include <AssetRegistry/AssetRegistryModule.h>
+#include <UObject/SavePackage.h>
+#include <Misc/PackageName.h>
+#include <Misc/SecureHash.h>
+#include <Editor.h>
+
+/* Packages created and saved per frame, to keep the editor responsive while importing many images. UObjects can only be created in the game thread */
+static constexpr int32 AssetsPerFrame = 2;
+
+void FHttpGPTImageGenImporter::Import(const TArray<FString>& Hashes, const TArray<TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>>& EncodedImages)
+{
+	check(IsInGameThread());
+
+	if (Hashes.Num() + EncodedImages.Num() <= 0)
+	{
+		return;
+	}
+
+	MakeShared<FHttpGPTImageGenImporter, ESPMode::ThreadSafe>(Hashes, EncodedImages)->Start();
+}
+
+FHttpGPTImageGenImporter::FHttpGPTImageGenImporter(const TArray<FString>& InHashes,
+                                                   const TArray<TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>>& InEncodedImages) : Hashes(InHashes),
+	EncodedImages(InEncodedImages)
+{
+}
+
+void FHttpGPTImageGenImporter::Start()
+{
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Importing %d images"), *FString(__FUNCTION__), Hashes.Num() + EncodedImages.Num());
+
+	SelfReference = AsShared();
+	FHttpGPTImageDecoder::LoadModules();
+
+	for (const FString& Hash : Hashes)
+	{
+		TWeakPtr<FHttpGPTImageGenImporter, ESPMode::ThreadSafe> WeakThis = AsShared();
+		Async(EAsyncExecution::ThreadPool, [WeakThis, Hash]
+		{
+			FDecodedEntry NewEntry;
+			NewEntry.Hash = Hash;
+
+			if (const TSharedPtr<FHttpGPTCachedImageData, ESPMode::ThreadSafe> CachedImage = FHttpGPTImageCache::Get().Load(Hash))
+			{
+				FHttpGPTImageDecoder::Decode(CachedImage->GetData(), CachedImage->GetSize(), NewEntry.Image);
+			}
+
+			if (const TSharedPtr<FHttpGPTImageGenImporter, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			{
+				FScopeLock Lock(&This->Mutex);
+				This->DecodedEntries.Add(MoveTemp(NewEntry));
+			}
+		});
+	}
+
+	for (const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& EncodedImage : EncodedImages)
+	{
+		TWeakPtr<FHttpGPTImageGenImporter, ESPMode::ThreadSafe> WeakThis = AsShared();
+		Async(EAsyncExecution::ThreadPool, [WeakThis, EncodedImage]
+		{
+			FDecodedEntry NewEntry;
+
+			if (EncodedImage.IsValid())
+			{
+				// Same name the image would have if it was in the image disk cache
+				FSHAHash Hash;
+				FSHA1::HashBuffer(EncodedImage->GetData(), EncodedImage->Num(), Hash.Hash);
+				NewEntry.Hash = Hash.ToString();
+
+				FHttpGPTImageDecoder::Decode(EncodedImage->GetData(), EncodedImage->Num(), NewEntry.Image);
+			}
+
+			if (const TSharedPtr<FHttpGPTImageGenImporter, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			{
+				FScopeLock Lock(&This->Mutex);
+				This->DecodedEntries.Add(MoveTemp(NewEntry));
+			}
+		});
+	}
+
+	const FTickerDelegate TickerDelegate = FTickerDelegate::CreateSP(this, &FHttpGPTImageGenImporter::TickImport);
+
+#if ENGINE_MAJOR_VERSION >= 5
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TickerDelegate);
+#else
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(TickerDelegate);
+#endif
+}
+
+bool FHttpGPTImageGenImporter::TickImport([[maybe_unused]] const float DeltaTime)
+{
+	TArray<FDecodedEntry> ReadyEntries;
+	{
+		FScopeLock Lock(&Mutex);
+
+		const int32 ReadyNum = FMath::Min(DecodedEntries.Num(), AssetsPerFrame);
+		for (int32 Iterator = 0; Iterator < ReadyNum; ++Iterator)
+		{
+			ReadyEntries.Add(MoveTemp(DecodedEntries[Iterator]));
+		}
+
+		DecodedEntries.RemoveAt(0, ReadyNum);
+	}
+
+	for (FDecodedEntry& Entry : ReadyEntries)
+	{
+		CreateAsset(Entry);
+		++ProcessedImages;
+	}
+
+	SaveCompiledAssets();
+
+	if (ProcessedImages >= Hashes.Num() + EncodedImages.Num() && PendingSaves.Num() <= 0)
+	{
+		Finish();
+		return false;
+	}
+
+	return true;
+}
+
+void FHttpGPTImageGenImporter::CreateAsset(FDecodedEntry& Entry)
+{
+	if (!Entry.Image.IsValid())
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to load image %s from the image cache"), *FString(__FUNCTION__), *Entry.Hash);
+		return;
+	}
+
+	const FString PackageName = GetPackageName(Entry.Hash);
+	const FString AssetName = FPackageName::GetLongPackageAssetName(PackageName);
+
+	// The asset name is derived from the image content: the same image is only imported once
+	UObject* ExistingAsset = FindObject<UTexture2D>(nullptr, *(PackageName + TEXT(".") + AssetName));
+	if (!ExistingAsset && FPackageName::DoesPackageExist(PackageName))
+	{
+		// Imported in a previous session: the package is on disk but not loaded
+		if (UPackage* const ExistingPackage = LoadPackage(nullptr, *PackageName, LOAD_None))
+		{
+			ExistingAsset = FindObject<UTexture2D>(ExistingPackage, *AssetName);
+		}
+	}
+
+	if (ExistingAsset)
+	{
+		UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Image %s was already imported"), *FString(__FUNCTION__), *PackageName);
+		ExistingAssets.Add(ExistingAsset);
+		return;
+	}
+
+	if (FPackageName::DoesPackageExist(PackageName))
+	{
+		UE_LOG(LogHttpGPT, Warning, TEXT("%s: Package %s exists but does not contain the image. Skipping it."), *FString(__FUNCTION__), *PackageName);
+		return;
+	}
+
+	UPackage* const Package = CreatePackage(*PackageName);
+	UTexture2D* const SavedTexture = NewObject<UTexture2D>(Package, *AssetName, RF_Public | RF_Standalone);
+
+	// The source art keeps the original pixels, so the texture can be rebuilt with any compression settings
+	SavedTexture->Source.Init(Entry.Image.SizeX, Entry.Image.SizeY, 1, 1, TSF_BGRA8, Entry.Image.RawData.GetData());
+	SavedTexture->SRGB = true;
+
+	// Build the texture data. In UE5 the texture compilation runs asynchronously
+	SavedTexture->PostEditChange();
+	SavedTexture->MarkPackageDirty();
+
+	// The decoded pixels were copied into the source data
+	Entry.Image.RawData.Empty();
+
+	PendingSaves.Add(SavedTexture);
+}
+
+void FHttpGPTImageGenImporter::SaveCompiledAssets()
+{
+	int32 SavedNum = 0;
+	for (int32 Iterator = PendingSaves.Num() - 1; Iterator >= 0 && SavedNum < AssetsPerFrame; --Iterator)
+	{
+		UTexture2D* const SavedTexture = PendingSaves[Iterator].Get();
+
+#if ENGINE_MAJOR_VERSION >= 5
+		// Saving a texture that is still compiling would wait for the compilation in the game thread
+		if (IsValid(SavedTexture) && SavedTexture->IsCompiling())
+		{
+			continue;
+		}
+#endif
+
+		PendingSaves.RemoveAt(Iterator);
+
+		if (!IsValid(SavedTexture))
+		{
+			continue;
+		}
+
+		UPackage* const Package = SavedTexture->GetOutermost();
+		const FString PackageFilename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+
+#if ENGINE_MAJOR_VERSION >= 5
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.SaveFlags = SAVE_Async;
+		UPackage::SavePackage(Package, SavedTexture, *PackageFilename, SaveArgs);
+#else
+		UPackage::SavePackage(Package, SavedTexture, RF_Public | RF_Standalone, *PackageFilename, GError, nullptr, false, true, SAVE_Async);
+#endif
+
+		CreatedAssets.Add(SavedTexture);
+		++SavedNum;
+	}
+}
+
+void FHttpGPTImageGenImporter::Finish()
+{
+	// Only report the batch once the packages are on the disk
+	UPackage::WaitForAsyncFileWrites();
+
+	// Notify the asset registry and the content browser once for the whole batch
+	TArray<FAssetData> SyncAssets;
+	SyncAssets.Reserve(CreatedAssets.Num() + ExistingAssets.Num());
+
+	for (const TWeakObjectPtr<UObject>& Asset : CreatedAssets)
+	{
+		if (Asset.IsValid())
+		{
+			FAssetRegistryModule::AssetCreated(Asset.Get());
+			SyncAssets.Add(FAssetData(Asset.Get()));
+		}
+	}
+
+	for (const TWeakObjectPtr<UObject>& Asset : ExistingAssets)
+	{
+		if (Asset.IsValid())
+		{
+			SyncAssets.Add(FAssetData(Asset.Get()));
+		}
+	}
+
+	if (GEditor && SyncAssets.Num() > 0)
+	{
+		GEditor->SyncBrowserToObjects(SyncAssets);
+	}
+
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Imported %d of %d images"), *FString(__FUNCTION__), CreatedAssets.Num(), Hashes.Num() + EncodedImages.Num());
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#else
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#endif
+
+	TickerHandle.Reset();
+	SelfReference.Reset();
+}
+
+FString FHttpGPTImageGenImporter::GetPackageName(const FString& Hash)
+{
+	FString PackageName = FPaths::Combine(TEXT("/Game/"), UHttpGPTSettings::Get()->GeneratedImagesDir, TEXT("T_HttpGPT_") + Hash.Left(16));
+	FPaths::NormalizeFilename(PackageName);
+
+	return PackageName;
+}
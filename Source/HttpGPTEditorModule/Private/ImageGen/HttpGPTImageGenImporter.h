@@ -0,0 +1,70 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Containers/Ticker.h>
+#include <Utils/HttpGPTImageDecoder.h>
+
+class UTexture2D;
+
+/**
+ *
+ */
+class FHttpGPTImageGenImporter final : public TSharedFromThis<FHttpGPTImageGenImporter, ESPMode::ThreadSafe>
+{
+public:
+	/* Import the cached images and the encoded images as texture assets: images are decoded in worker threads and the packages are saved asynchronously */
+	static void Import(const TArray<FString>& Hashes, const TArray<TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>>& EncodedImages = {});
+
+	FHttpGPTImageGenImporter(const TArray<FString>& InHashes, const TArray<TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>>& InEncodedImages);
+
+private:
+	struct FDecodedEntry
+	{
+		FString Hash;
+		FHttpGPTDecodedImage Image;
+	};
+
+	void Start();
+
+	bool TickImport(const float DeltaTime);
+
+	void CreateAsset(FDecodedEntry& Entry);
+
+	/* Save the textures that finished compiling. The pending ones are checked again in the next frame */
+	void SaveCompiledAssets();
+	void Finish();
+
+	static FString GetPackageName(const FString& Hash);
+
+	TArray<FString> Hashes;
+
+	/* Images that are not in the image disk cache */
+	TArray<TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>> EncodedImages;
+
+	int32 ProcessedImages = 0;
+
+	/* Filled by the worker threads and consumed in the game thread */
+	TArray<FDecodedEntry> DecodedEntries;
+	FCriticalSection Mutex;
+
+	/* Created textures waiting for their compilation before being saved */
+	TArray<TWeakObjectPtr<UTexture2D>> PendingSaves;
+
+	TArray<TWeakObjectPtr<UObject>> CreatedAssets;
+
+	/* Images imported by a previous batch or session, only selected in the content browser */
+	TArray<TWeakObjectPtr<UObject>> ExistingAssets;
+
+	/* Keep the importer alive while the images are decoded */
+	TSharedPtr<FHttpGPTImageGenImporter, ESPMode::ThreadSafe> SelfReference;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::FDelegateHandle TickerHandle;
+#else
+	FDelegateHandle TickerHandle;
+#endif
+};
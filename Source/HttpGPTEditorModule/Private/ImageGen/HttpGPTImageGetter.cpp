@@ -4,13 +4,14 @@
 
 #include "HttpGPTImageGetter.h"
 #include <Utils/HttpGPTHelper.h>
+#include <Management/HttpGPTSettings.h>
 #include <Widgets/Layout/SScrollBox.h>
 
 #ifdef UE_INLINE_GENERATED_CPP_BY_NAME
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HttpGPTImageGetter)
 #endif
 
-UHttpGPTImageGetter::UHttpGPTImageGetter(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer), GeneratedImages(0u), DataSize(0u)
+UHttpGPTImageGetter::UHttpGPTImageGetter(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 }
 
@@ -40,40 +41,92 @@ void UHttpGPTImageGetter::ProcessCompleted(const FHttpGPTImageResponse& Response
 		return;
 	}
 
-	DataSize = Response.Data.Num();
-	OnStatusChanged.ExecuteIfBound("Request Completed.");
+	OnStatusChanged.ExecuteIfBound("Request Completed. Loading images...");
+
+	Pipeline = FHttpGPTImagePipeline::Create(Response.Data);
+	Pipeline->bStoreEncodedImages = true;
 
-	OnImageGenerated_Internal.BindUFunction(this, TEXT("ImageGenerated"));
+	// The list only displays thumbnails: the full resolution images are loaded from the disk cache when needed
+	Pipeline->MaxImageSize = UHttpGPTSettings::Get()->ImageGenThumbnailSize;
+	Pipeline->OnStageChanged.BindUObject(this, &UHttpGPTImageGetter::ImageStageChanged);
+	Pipeline->OnImageReady.BindUObject(this, &UHttpGPTImageGetter::ImageReady);
+	Pipeline->OnCompleted.BindUObject(this, &UHttpGPTImageGetter::ImagesCompleted);
+	Pipeline->Start();
+}
 
-	for (const FHttpGPTImageData& Data : Response.Data)
+void UHttpGPTImageGetter::ImageStageChanged(const int32 Index, const EHttpGPTImageStage Stage)
+{
+	if (!Pipeline.IsValid())
 	{
-		ProcessImage(Data);
+		return;
 	}
+
+	int32 CompletedImages = 0;
+	int32 FailedImages = 0;
+	for (int32 Iterator = 0; Iterator < Pipeline->Num(); ++Iterator)
+	{
+		CompletedImages += Pipeline->GetStage(Iterator) == EHttpGPTImageStage::Completed ? 1 : 0;
+		FailedImages += Pipeline->GetStage(Iterator) == EHttpGPTImageStage::Failed ? 1 : 0;
+	}
+
+	FString StageName;
+	switch (Stage)
+	{
+	case EHttpGPTImageStage::Fetching:
+		StageName = TEXT("Downloading");
+		break;
+
+	case EHttpGPTImageStage::Decoding:
+		StageName = TEXT("Decoding");
+		break;
+
+	case EHttpGPTImageStage::Uploading:
+		StageName = TEXT("Creating Texture");
+		break;
+
+	case EHttpGPTImageStage::Completed:
+		StageName = TEXT("Completed");
+		break;
+
+	case EHttpGPTImageStage::Failed:
+		StageName = TEXT("Failed");
+		break;
+
+	default:
+		StageName = TEXT("Queued");
+		break;
+	}
+
+	OnStatusChanged.ExecuteIfBound(FString::Format(TEXT("Image {0}: {1}. ({2}/{3} completed, {4} failed)"),
+	                                               {Index + 1, StageName, CompletedImages, Pipeline->Num(), FailedImages}));
 }
 
-void UHttpGPTImageGetter::ProcessImage(const FHttpGPTImageData& Data)
+void UHttpGPTImageGetter::ImageReady(const int32 Index, UTexture2D* const Texture)
 {
-	UHttpGPTImageHelper::GenerateImage(Data, OnImageGenerated_Internal);
+	OnImageGenerated.ExecuteIfBound(Texture, Pipeline.IsValid() ? Pipeline->GetImageHash(Index) : FString(),
+	                                Pipeline.IsValid() ? Pipeline->GetEncodedImage(Index) : nullptr);
 }
 
-void UHttpGPTImageGetter::ImageGenerated(UTexture2D* const Texture)
+void UHttpGPTImageGetter::ImagesCompleted([[maybe_unused]] const TArray<UTexture2D*>& Textures)
 {
-	OnImageGenerated.ExecuteIfBound(Texture);
+	OnStatusChanged.ExecuteIfBound("Request Completed.");
 
-	++GeneratedImages;
-	if (GeneratedImages >= DataSize)
+	if (OutScrollBox.IsValid())
 	{
-		if (OutScrollBox.IsValid())
-		{
-			OutScrollBox->ScrollToEnd();
-		}
-
-		Destroy();
+		OutScrollBox->ScrollToEnd();
 	}
+
+	Destroy();
 }
 
 void UHttpGPTImageGetter::Destroy()
 {
+	if (Pipeline.IsValid())
+	{
+		Pipeline->Cancel();
+		Pipeline.Reset();
+	}
+
 	ClearFlags(RF_Standalone);
 
 #if ENGINE_MAJOR_VERSION >= 5
@@ -7,9 +7,10 @@
 #include <CoreMinimal.h>
 #include <Engine/Texture2D.h>
 #include <Tasks/HttpGPTImageRequest.h>
+#include <Management/HttpGPTImagePipeline.h>
 #include "HttpGPTImageGetter.generated.h"
 
-DECLARE_DELEGATE_OneParam(FImageGenerated, UTexture2D*);
+DECLARE_DELEGATE_ThreeParams(FImageGenerated, UTexture2D*, const FString& /* Hash */, const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& /* EncodedImage */);
 DECLARE_DELEGATE_OneParam(FImageStatusChanged, FString);
 
 UCLASS(MinimalAPI, NotBlueprintable, NotPlaceable, Category = "Implementation")
@@ -37,13 +38,9 @@ public:
 	TSharedPtr<class SScrollBox> OutScrollBox;
 
 private:
-	void ProcessImage(const FHttpGPTImageData& Data);
+	void ImageStageChanged(const int32 Index, const EHttpGPTImageStage Stage);
+	void ImageReady(const int32 Index, UTexture2D* const Texture);
+	void ImagesCompleted(const TArray<UTexture2D*>& Textures);
 
-	FHttpGPTImageGenerate OnImageGenerated_Internal;
-
-	UFUNCTION()
-	void ImageGenerated(UTexture2D* const Texture);
-
-	uint8 GeneratedImages;
-	uint8 DataSize;
+	TSharedPtr<FHttpGPTImagePipeline, ESPMode::ThreadSafe> Pipeline;
 };
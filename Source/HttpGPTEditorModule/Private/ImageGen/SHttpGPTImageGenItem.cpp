@@ -19,13 +19,23 @@ void SHttpGPTImageGenItem::Construct(const FArguments& InArgs)
 	HttpGPTImageGetterObject->SetFlags(RF_Standalone);
 	HttpGPTImageGetterObject->OutScrollBox = InArgs._OutScrollBox;
 
-	HttpGPTImageGetterObject->OnImageGenerated.BindLambda([this](UTexture2D* const Texture)
-	{
-		if (Texture && ItemViewBox.IsValid())
+	HttpGPTImageGetterObject->OnImageGenerated.BindLambda(
+		[this](UTexture2D* const Texture, const FString& Hash, const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& EncodedImage)
 		{
-			ItemViewBox->AddSlot().AutoWidth()[SNew(SHttpGPTImageGenItemData).Texture(Texture)];
-		}
-	});
+			if (Texture && ItemViewBox.IsValid())
+			{
+				ItemViewBox->AddSlot().AutoWidth()[SNew(SHttpGPTImageGenItemData).Texture(Texture).ImageHash(Hash).EncodedImage(EncodedImage)];
+
+				if (!HttpGPT::Internal::HasEmptyParam(Hash))
+				{
+					ImageHashes.Add(Hash);
+				}
+				else if (EncodedImage.IsValid())
+				{
+					EncodedImages.Add(EncodedImage);
+				}
+			}
+		});
 
 	HttpGPTImageGetterObject->OnStatusChanged.BindLambda([this](const FString& NewStatus)
 	{
@@ -63,6 +73,24 @@ SHttpGPTImageGenItem::~SHttpGPTImageGenItem()
 	{
 		RequestReference->StopHttpGPTTask();
 	}
+
+	// Stop delivering images to this widget
+	if (HttpGPTImageGetterObject.IsValid())
+	{
+		HttpGPTImageGetterObject->OnImageGenerated.Unbind();
+		HttpGPTImageGetterObject->OnStatusChanged.Unbind();
+		HttpGPTImageGetterObject->Destroy();
+	}
+}
+
+const TArray<FString>& SHttpGPTImageGenItem::GetImageHashes() const
+{
+	return ImageHashes;
+}
+
+const TArray<TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>>& SHttpGPTImageGenItem::GetEncodedImages() const
+{
+	return EncodedImages;
 }
 
 TSharedRef<SWidget> SHttpGPTImageGenItem::ConstructContent()
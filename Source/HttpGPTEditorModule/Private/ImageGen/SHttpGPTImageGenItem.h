@@ -25,6 +25,12 @@ public:
 
 	TWeakObjectPtr<class UHttpGPTImageGetter> HttpGPTImageGetterObject;
 
+	/* Hashes in the image disk cache of the images generated by this item */
+	const TArray<FString>& GetImageHashes() const;
+
+	/* Images generated by this item that could not be stored in the image disk cache */
+	const TArray<TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>>& GetEncodedImages() const;
+
 private:
 	TSharedRef<SWidget> ConstructContent();
 
@@ -34,6 +40,9 @@ private:
 	TSharedPtr<class SHorizontalBox> ItemViewBox;
 
 	TWeakObjectPtr<class UHttpGPTImageRequest> RequestReference;
+
+	TArray<FString> ImageHashes;
+	TArray<TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>> EncodedImages;
 };
 
 using SHttpGPTImageGenItemPtr = TSharedPtr<SHttpGPTImageGenItem>;
@@ -3,14 +3,25 @@
 // Repo: https://github.com/lucoiso/UEHttpGPT
 
 #include "SHttpGPTImageGenItemData.h"
+#include "HttpGPTImageGenBudget.h"
+#include "HttpGPTImageGenImporter.h"
+#include <Management/HttpGPTImagePipeline.h>
 #include <Management/HttpGPTSettings.h>
-#include <Brushes/SlateImageBrush.h>
-#include <AssetRegistry/AssetRegistryModule.h>
-#include <UObject/SavePackage.h>
+#include <HttpGPTInternalFuncs.h>
+#include <Engine/Texture2D.h>
+#include <Framework/Application/SlateApplication.h>
+#include <Widgets/SWindow.h>
+#include <Widgets/Layout/SScaleBox.h>
 
 void SHttpGPTImageGenItemData::Construct(const FArguments& InArgs)
 {
-	Texture = InArgs._Texture;
+	ImageHash = InArgs._ImageHash;
+	EncodedImage = InArgs._EncodedImage;
+	Thumbnail.Reset(InArgs._Texture);
+
+	const float ThumbnailSize = static_cast<float>(UHttpGPTSettings::Get()->ImageGenThumbnailSize);
+	ImageBrush.SetResourceObject(InArgs._Texture);
+	ImageBrush.ImageSize = FVector2D(ThumbnailSize, ThumbnailSize);
 
 	ChildSlot
 	[
@@ -18,6 +29,21 @@ void SHttpGPTImageGenItemData::Construct(const FArguments& InArgs)
 	];
 }
 
+SHttpGPTImageGenItemData::~SHttpGPTImageGenItemData()
+{
+	FHttpGPTImageGenBudget::Get().Remove(this);
+
+	if (LoadingPipeline.IsValid())
+	{
+		LoadingPipeline->Cancel();
+	}
+
+	if (const TSharedPtr<SWindow> Window = InspectWindow.Pin())
+	{
+		Window->RequestDestroyWindow();
+	}
+}
+
 TSharedRef<SWidget> SHttpGPTImageGenItemData::ConstructContent()
 {
 	constexpr float SlotPadding = 4.0f;
@@ -25,64 +51,159 @@ TSharedRef<SWidget> SHttpGPTImageGenItemData::ConstructContent()
 	return SNew(SVerticalBox)
 		+ SVerticalBox::Slot().Padding(SlotPadding).FillHeight(1.f)
 		[
-			SNew(SImage).Image(Texture.IsValid() ? new FSlateImageBrush(Texture.Get(), FVector2D(256.f, 256.f)) : nullptr)
+			SNew(SImage)
+			.Image(&ImageBrush)
+			.OnMouseButtonDown(this, &SHttpGPTImageGenItemData::HandleImageClicked)
 		]
 		+ SVerticalBox::Slot().Padding(SlotPadding).AutoHeight()
 		[
-			SNew(SButton)
-			.Text(FText::FromString(TEXT("Save")))
-			.HAlign(HAlign_Center)
-			.OnClicked(this, &SHttpGPTImageGenItemData::HandleSaveButton)
-			.IsEnabled(this, &SHttpGPTImageGenItemData::IsSaveEnabled)
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().Padding(SlotPadding).FillWidth(1.f)
+			[
+				SNew(SButton)
+				.Text(FText::FromString(TEXT("Inspect")))
+				.HAlign(HAlign_Center)
+				.OnClicked(this, &SHttpGPTImageGenItemData::HandleInspectButton)
+				.IsEnabled(this, &SHttpGPTImageGenItemData::IsSaveEnabled)
+			]
+			+ SHorizontalBox::Slot().Padding(SlotPadding).FillWidth(1.f)
+			[
+				SNew(SButton)
+				.Text(FText::FromString(TEXT("Save")))
+				.HAlign(HAlign_Center)
+				.OnClicked(this, &SHttpGPTImageGenItemData::HandleSaveButton)
+				.IsEnabled(this, &SHttpGPTImageGenItemData::IsSaveEnabled)
+			]
 		];
 }
 
-FReply SHttpGPTImageGenItemData::HandleSaveButton()
+FReply SHttpGPTImageGenItemData::HandleImageClicked([[maybe_unused]] const FGeometry& Geometry, [[maybe_unused]] const FPointerEvent& MouseEvent)
+{
+	return HandleInspectButton();
+}
+
+FReply SHttpGPTImageGenItemData::HandleInspectButton()
+{
+	if (FullTexture.IsValid())
+	{
+		FHttpGPTImageGenBudget::Get().Touch(this);
+		OpenInspectWindow();
+	}
+	else
+	{
+		LoadFullTexture([this]
+		{
+			OpenInspectWindow();
+		});
+	}
+
+	return FReply::Handled();
+}
+
+void SHttpGPTImageGenItemData::SetFullTexture(UTexture2D* const NewTexture)
 {
-	const FString AssetName = FString::FromInt(Texture->GetUniqueID());
-	FString TargetFilename = FPaths::Combine(TEXT("/Game/"), UHttpGPTSettings::Get()->GeneratedImagesDir, AssetName);
-	FPaths::NormalizeFilename(TargetFilename);
+	FullTexture.Reset(NewTexture);
+	FullImageBrush.SetResourceObject(NewTexture);
 
-	UPackage* const Package = CreatePackage(*TargetFilename);
-	UTexture2D* const SavedTexture = NewObject<UTexture2D>(Package, *AssetName, RF_Public | RF_Standalone);
+	if (!NewTexture)
+	{
+		return;
+	}
 
-#if ENGINE_MAJOR_VERSION >= 5
-	SavedTexture->SetPlatformData(Texture->GetPlatformData());
-#else
-    SavedTexture->PlatformData = Texture->PlatformData;
-#endif
+	FullImageBrush.ImageSize = FVector2D(NewTexture->GetSizeX(), NewTexture->GetSizeY());
 
-	SavedTexture->UpdateResource();
+	// The mip chain adds a third of the top mip size
+	SIZE_T TextureSize = static_cast<SIZE_T>(NewTexture->GetSizeX()) * NewTexture->GetSizeY() * 4u;
+	if (NewTexture->GetNumMips() > 1)
+	{
+		TextureSize += TextureSize / 3u;
+	}
 
-#if ENGINE_MAJOR_VERSION >= 5
-	SavedTexture->Source.Init(Texture->GetSizeX(), Texture->GetSizeY(), 1, Texture->GetPlatformData()->Mips.Num(), TSF_BGRA8);
-#else
-    SavedTexture->Source.Init(Texture->GetSizeX(), Texture->GetSizeY(), 1, Texture->PlatformData->Mips.Num(), ETextureSourceFormat::TSF_BGRA8);
-#endif
+	FHttpGPTImageGenBudget::Get().Add(this, TextureSize, FSimpleDelegate::CreateSP(this, &SHttpGPTImageGenItemData::EvictFullTexture));
+}
 
-	SavedTexture->PostEditChange();
+void SHttpGPTImageGenItemData::EvictFullTexture()
+{
+	if (const TSharedPtr<SWindow> Window = InspectWindow.Pin())
+	{
+		Window->RequestDestroyWindow();
+	}
 
-	SavedTexture->MarkPackageDirty();
-	FAssetRegistryModule::AssetCreated(SavedTexture);
+	FullImageBrush.SetResourceObject(nullptr);
+	FullTexture.Reset();
+}
 
-	const FString TempPackageFilename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+void SHttpGPTImageGenItemData::LoadFullTexture(TFunction<void()>&& OnLoaded)
+{
+	if (LoadingPipeline.IsValid())
+	{
+		LoadingPipeline->Cancel();
+	}
+
+	LoadingPipeline = HttpGPT::Internal::HasEmptyParam(ImageHash)
+		                  ? FHttpGPTImagePipeline::Create({FHttpGPTImageData(FString(), EncodedImage, EHttpGPTResponseFormat::b64_json)})
+		                  : FHttpGPTImagePipeline::CreateFromCache({ImageHash});
+	LoadingPipeline->bGenerateMips = true;
+	LoadingPipeline->OnImageReady.BindSPLambda(this, [this, OnLoaded = MoveTemp(OnLoaded)]([[maybe_unused]] const int32 Index, UTexture2D* const NewTexture)
+	{
+		LoadingPipeline.Reset();
+
+		if (NewTexture)
+		{
+			SetFullTexture(NewTexture);
+			OnLoaded();
+		}
+	});
+
+	LoadingPipeline->Start();
+}
 
-#if ENGINE_MAJOR_VERSION >= 5
-	FSavePackageArgs SaveArgs;
-	SaveArgs.SaveFlags = RF_Public | RF_Standalone;
-	UPackage::SavePackage(Package, SavedTexture, *TempPackageFilename, SaveArgs);
-#else
-    UPackage::SavePackage(Package, SavedTexture, RF_Public | RF_Standalone, *TempPackageFilename);
-#endif
+void SHttpGPTImageGenItemData::OpenInspectWindow()
+{
+	if (const TSharedPtr<SWindow> Window = InspectWindow.Pin())
+	{
+		Window->BringToFront();
+		return;
+	}
+
+	const TSharedRef<SWindow> NewWindow = SNew(SWindow)
+		.Title(FText::FromString(TEXT("HttpGPT Image Inspector")))
+		.ClientSize(FVector2D(768.f, 768.f))
+		.SupportsMaximize(true)
+		[
+			SNew(SScaleBox)
+			.Stretch(EStretch::ScaleToFit)
+			[
+				SNew(SImage)
+				.Image(&FullImageBrush)
+			]
+		];
 
-	TArray<FAssetData> SyncAssets;
-	SyncAssets.Add(FAssetData(SavedTexture));
-	GEditor->SyncBrowserToObjects(SyncAssets);
+	InspectWindow = NewWindow;
+	FSlateApplication::Get().AddWindow(NewWindow);
+}
+
+FReply SHttpGPTImageGenItemData::HandleSaveButton()
+{
+	if (HttpGPT::Internal::HasEmptyParam(ImageHash))
+	{
+		FHttpGPTImageGenImporter::Import({}, {EncodedImage});
+	}
+	else
+	{
+		FHttpGPTImageGenImporter::Import({ImageHash});
+	}
 
 	return FReply::Handled();
 }
 
 bool SHttpGPTImageGenItemData::IsSaveEnabled() const
 {
-	return Texture.IsValid();
+	// The full image is reloaded from the image disk cache, or from the encoded image when the cache could not store it
+	return !HttpGPT::Internal::HasEmptyParam(ImageHash) || EncodedImage.IsValid();
+}
+
+const FString& SHttpGPTImageGenItemData::GetImageHash() const
+{
+	return ImageHash;
 }
@@ -6,26 +6,59 @@
 
 #include <CoreMinimal.h>
 #include <Widgets/SCompoundWidget.h>
+#include <Styling/SlateBrush.h>
+#include <UObject/StrongObjectPtr.h>
 
 class SHttpGPTImageGenItemData final : public SCompoundWidget
 {
 public:
-	SLATE_BEGIN_ARGS(SHttpGPTImageGenItemData) : _Texture()
+	SLATE_BEGIN_ARGS(SHttpGPTImageGenItemData) : _Texture(), _ImageHash(), _EncodedImage()
 		{
 		}
 
+		/* Thumbnail displayed in the list. The full resolution texture is loaded from the image disk cache on demand */
 		SLATE_ARGUMENT(class UTexture2D*, Texture)
+		SLATE_ARGUMENT(FString, ImageHash)
+
+		/* Full image kept in memory when it could not be stored in the image disk cache */
+		SLATE_ARGUMENT(TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>, EncodedImage)
 	SLATE_END_ARGS()
 
 	void Construct(const FArguments& InArgs);
+	virtual ~SHttpGPTImageGenItemData() override;
 
 	FReply HandleSaveButton();
 	bool IsSaveEnabled() const;
 
+	FReply HandleInspectButton();
+
+	const FString& GetImageHash() const;
+
 private:
 	TSharedRef<SWidget> ConstructContent();
 
-	TWeakObjectPtr<class UTexture2D> Texture;
+	FReply HandleImageClicked(const FGeometry& Geometry, const FPointerEvent& MouseEvent);
+
+	void SetFullTexture(class UTexture2D* const NewTexture);
+
+	/* Release the full resolution texture. The thumbnail stays displayed in the list */
+	void EvictFullTexture();
+
+	/* Load the full resolution texture with its mips from the image disk cache, or from the encoded image kept in memory */
+	void LoadFullTexture(TFunction<void()>&& OnLoaded);
+
+	void OpenInspectWindow();
+
+	FString ImageHash;
+	TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> EncodedImage;
+	FSlateBrush ImageBrush;
+	FSlateBrush FullImageBrush;
+
+	TStrongObjectPtr<class UTexture2D> FullTexture;
+	TStrongObjectPtr<class UTexture2D> Thumbnail;
+
+	TSharedPtr<class FHttpGPTImagePipeline, ESPMode::ThreadSafe> LoadingPipeline;
+	TWeakPtr<class SWindow> InspectWindow;
 };
 
 using SHttpGPTImageGenItemDataPtr = TSharedPtr<SHttpGPTImageGenItemData>;
@@ -4,6 +4,7 @@
 
 #include "SHttpGPTImageGenView.h"
 #include "SHttpGPTImageGenItem.h"
+#include "HttpGPTImageGenImporter.h"
 #include <Utils/HttpGPTHelper.h>
 #include <HttpGPTInternalFuncs.h>
 #include <Widgets/Layout/SScrollBox.h>
@@ -69,6 +70,14 @@ TSharedRef<SWidget> SHttpGPTImageGenView::ConstructContent()
 				ImageSizeComboBox.ToSharedRef()
 			]
 			+ SHorizontalBox::Slot().Padding(SlotPadding).AutoWidth()
+			[
+				SNew(SButton)
+				.Text(FText::FromString(TEXT("Save All")))
+				.ToolTipText(FText::FromString(TEXT("Import all generated images as texture assets")))
+				.OnClicked(this, &SHttpGPTImageGenView::HandleSaveAllButton)
+				.IsEnabled(this, &SHttpGPTImageGenView::IsSaveAllEnabled)
+			]
+			+ SHorizontalBox::Slot().Padding(SlotPadding).AutoWidth()
 			[
 				SNew(SButton)
 				.Text(FText::FromString(TEXT("Clear")))
@@ -81,7 +90,7 @@ TSharedRef<SWidget> SHttpGPTImageGenView::ConstructContent()
 
 FReply SHttpGPTImageGenView::HandleSendRequestButton()
 {
-	ViewBox->AddSlot().AutoHeight()[SNew(SHttpGPTImageGenItem)
+	ViewBox->AddSlot().AutoHeight()[SAssignNew(Items.AddDefaulted_GetRef(), SHttpGPTImageGenItem)
 	.OutScrollBox(ViewScrollBox)
 	.Prompt(InputTextBox->GetText().ToString())
 	.Num(*ImageNumComboBox->GetSelectedItem().Get())
@@ -101,9 +110,39 @@ bool SHttpGPTImageGenView::IsSendRequestEnabled() const
 FReply SHttpGPTImageGenView::HandleClearViewButton()
 {
 	ViewBox->ClearChildren();
+	Items.Empty();
+
 	return FReply::Handled();
 }
 
+FReply SHttpGPTImageGenView::HandleSaveAllButton()
+{
+	TArray<FString> ImageHashes;
+	TArray<TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>> EncodedImages;
+	for (const TSharedPtr<SHttpGPTImageGenItem>& Item : Items)
+	{
+		ImageHashes.Append(Item->GetImageHashes());
+		EncodedImages.Append(Item->GetEncodedImages());
+	}
+
+	FHttpGPTImageGenImporter::Import(ImageHashes, EncodedImages);
+
+	return FReply::Handled();
+}
+
+bool SHttpGPTImageGenView::IsSaveAllEnabled() const
+{
+	for (const TSharedPtr<SHttpGPTImageGenItem>& Item : Items)
+	{
+		if (Item->GetImageHashes().Num() > 0 || Item->GetEncodedImages().Num() > 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool SHttpGPTImageGenView::IsClearViewEnabled() const
 {
 	return ViewBox->NumSlots() > 0;
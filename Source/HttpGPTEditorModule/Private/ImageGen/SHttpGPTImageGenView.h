@@ -20,12 +20,14 @@ public:
 
 	bool IsSendRequestEnabled() const;
 	bool IsClearViewEnabled() const;
+	bool IsSaveAllEnabled() const;
 
 private:
 	TSharedRef<SWidget> ConstructContent();
 
 	FReply HandleSendRequestButton();
 	FReply HandleClearViewButton();
+	FReply HandleSaveAllButton();
 
 	void InitializeImageNumOptions();
 	void InitializeImageSizeOptions();
@@ -33,6 +35,8 @@ private:
 	TSharedPtr<class SVerticalBox> ViewBox;
 	TSharedPtr<class SScrollBox> ViewScrollBox;
 
+	TArray<TSharedPtr<class SHttpGPTImageGenItem>> Items;
+
 	TSharedPtr<class SEditableTextBox> InputTextBox;
 
 	TSharedPtr<class STextComboBox> ImageNumComboBox;
@@ -22,7 +22,11 @@ public class HttpGPTImageModule : ModuleRules
 		PrivateDependencyModuleNames.AddRange(new[]
 		{
 			"Engine",
-			"CoreUObject"
+			"CoreUObject",
+			"ImageWrapper",
+			"ImageCore",
+			"RenderCore",
+			"RHI"
 		});
 
 		if (Target.bBuildEditor) PrivateDependencyModuleNames.Add("UnrealEd");
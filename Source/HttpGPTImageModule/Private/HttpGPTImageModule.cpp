@@ -3,15 +3,19 @@
 // Repo: https://github.com/lucoiso/UEHttpGPT
 
 #include "HttpGPTImageModule.h"
+#include "Management/HttpGPTImageCache.h"
+#include <Utils/HttpGPTMultipartWriter.h>
 
 #define LOCTEXT_NAMESPACE "FHttpGPTImageModule"
 
 void FHttpGPTImageModule::StartupModule()
 {
+	FHttpGPTMultipartWriter::DeleteStaleTempFiles();
 }
 
 void FHttpGPTImageModule::ShutdownModule()
 {
+	FHttpGPTImageCache::Get().FlushIndex();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,414 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Management/HttpGPTImageCache.h"
+#include <HttpGPTInternalFuncs.h>
+#include <LogHttpGPT.h>
+
+#include <HttpModule.h>
+#include <Interfaces/IHttpRequest.h>
+#include <Interfaces/IHttpResponse.h>
+#include <Dom/JsonObject.h>
+#include <Serialization/JsonWriter.h>
+#include <Serialization/JsonReader.h>
+#include <Serialization/JsonSerializer.h>
+#include <HAL/PlatformFileManager.h>
+#include <Async/MappedFileHandle.h>
+#include <Async/Async.h>
+#include <Containers/Ticker.h>
+#include <Misc/FileHelper.h>
+#include <Misc/SecureHash.h>
+#include <Misc/Paths.h>
+
+FHttpGPTCachedImageData::FHttpGPTCachedImageData(TUniquePtr<IMappedFileHandle>&& InHandle, TUniquePtr<IMappedFileRegion>&& InRegion)
+	: Handle(MoveTemp(InHandle)), Region(MoveTemp(InRegion))
+{
+}
+
+FHttpGPTCachedImageData::FHttpGPTCachedImageData(TArray<uint8>&& InData) : Data(MoveTemp(InData))
+{
+}
+
+FHttpGPTCachedImageData::~FHttpGPTCachedImageData()
+{
+	// The region must be released before its file handle
+	Region.Reset();
+	Handle.Reset();
+}
+
+const uint8* FHttpGPTCachedImageData::GetData() const
+{
+	return Region.IsValid() ? Region->GetMappedPtr() : Data.GetData();
+}
+
+int64 FHttpGPTCachedImageData::GetSize() const
+{
+	return Region.IsValid() ? Region->GetMappedSize() : Data.Num();
+}
+
+FHttpGPTImageCache& FHttpGPTImageCache::Get()
+{
+	static FHttpGPTImageCache Instance;
+	return Instance;
+}
+
+FHttpGPTImageCache::FHttpGPTImageCache()
+{
+	LoadIndex();
+}
+
+FString FHttpGPTImageCache::GetCacheDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HttpGPT"), TEXT("Images"));
+}
+
+FString FHttpGPTImageCache::GetIndexPath()
+{
+	return FPaths::Combine(GetCacheDirectory(), TEXT("Index.json"));
+}
+
+FString FHttpGPTImageCache::GetIndexKey(const FString& URL)
+{
+	FString Path;
+	FString Query;
+	if (!URL.Split(TEXT("?"), &Path, &Query))
+	{
+		return URL;
+	}
+
+	FString Host;
+	if (!Path.Split(TEXT("://"), nullptr, &Host))
+	{
+		Host = Path;
+	}
+	Host.Split(TEXT("/"), &Host, nullptr);
+
+	// Generated images are served from Azure blob storage with shared access signatures that expire: the remaining URL identifies the image
+	if (!Host.EndsWith(TEXT(".blob.core.windows.net"), ESearchCase::IgnoreCase))
+	{
+		return URL;
+	}
+
+	static const TSet<FString> SignatureParameters{
+		TEXT("sv"), TEXT("ss"), TEXT("srt"), TEXT("sr"), TEXT("sp"), TEXT("st"), TEXT("se"), TEXT("sip"), TEXT("spr"), TEXT("si"), TEXT("sig"), TEXT("sdd"),
+		TEXT("skoid"), TEXT("sktid"), TEXT("skt"), TEXT("ske"), TEXT("sks"), TEXT("skv"), TEXT("rscc"), TEXT("rscd"), TEXT("rsce"), TEXT("rscl"),
+		TEXT("rsct")
+	};
+
+	TArray<FString> Parameters;
+	Query.ParseIntoArray(Parameters, TEXT("&"));
+	Parameters.RemoveAll([](const FString& Parameter)
+	{
+		FString Name = Parameter;
+		Parameter.Split(TEXT("="), &Name, nullptr);
+
+		return SignatureParameters.Contains(Name);
+	});
+
+	return Parameters.Num() > 0 ? Path + TEXT("?") + FString::Join(Parameters, TEXT("&")) : Path;
+}
+
+bool FHttpGPTImageCache::FindURL(const FString& URL, FString& OutHash) const
+{
+	FScopeLock Lock(&Mutex);
+
+	if (const FString* const Hash = URLIndex.Find(GetIndexKey(URL)); Hash && Contains(*Hash))
+	{
+		OutHash = *Hash;
+		return true;
+	}
+
+	return false;
+}
+
+bool FHttpGPTImageCache::Contains(const FString& Hash) const
+{
+	return !HttpGPT::Internal::HasEmptyParam(Hash) && FPaths::FileExists(GetImagePath(Hash));
+}
+
+FString FHttpGPTImageCache::GetImagePath(const FString& Hash) const
+{
+	return FPaths::Combine(GetCacheDirectory(), Hash + TEXT(".png"));
+}
+
+FString FHttpGPTImageCache::Store(const uint8* const Data, const int64 Size, const FString& SourceURL)
+{
+	if (!Data || Size <= 0)
+	{
+		return FString();
+	}
+
+	FSHAHash Hash;
+	FSHA1::HashBuffer(Data, Size, Hash.Hash);
+	const FString HashString = Hash.ToString();
+
+	if (!Contains(HashString) && !FFileHelper::SaveArrayToFile(TArrayView<const uint8>(Data, static_cast<int32>(Size)), *GetImagePath(HashString)))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to write image %s to the cache"), *FString(__FUNCTION__), *HashString);
+		return FString();
+	}
+
+	AddToIndex(SourceURL, HashString);
+
+	return HashString;
+}
+
+FString FHttpGPTImageCache::StoreFile(const FString& FilePath, const FString& SourceURL)
+{
+	const TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader.IsValid() || Reader->TotalSize() <= 0)
+	{
+		IFileManager::Get().Delete(*FilePath, false, true, true);
+		return FString();
+	}
+
+	FSHA1 HashState;
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(64 * 1024);
+
+	while (!Reader->AtEnd())
+	{
+		const int64 ReadSize = FMath::Min<int64>(Buffer.Num(), Reader->TotalSize() - Reader->Tell());
+		Reader->Serialize(Buffer.GetData(), ReadSize);
+		HashState.Update(Buffer.GetData(), ReadSize);
+	}
+
+	Reader->Close();
+	HashState.Final();
+
+	FSHAHash Hash;
+	HashState.GetHash(Hash.Hash);
+	const FString HashString = Hash.ToString();
+
+	if (Contains(HashString))
+	{
+		IFileManager::Get().Delete(*FilePath, false, true, true);
+	}
+	else if (!IFileManager::Get().Move(*GetImagePath(HashString), *FilePath, true, true))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to move image %s to the cache"), *FString(__FUNCTION__), *HashString);
+		return FString();
+	}
+
+	AddToIndex(SourceURL, HashString);
+
+	return HashString;
+}
+
+TSharedPtr<FHttpGPTCachedImageData, ESPMode::ThreadSafe> FHttpGPTImageCache::Load(const FString& Hash) const
+{
+	if (!Contains(Hash))
+	{
+		return nullptr;
+	}
+
+	const FString ImagePath = GetImagePath(Hash);
+
+	if (TUniquePtr<IMappedFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*ImagePath)); Handle.IsValid())
+	{
+		if (TUniquePtr<IMappedFileRegion> Region(Handle->MapRegion()); Region.IsValid())
+		{
+			return MakeShared<FHttpGPTCachedImageData, ESPMode::ThreadSafe>(MoveTemp(Handle), MoveTemp(Region));
+		}
+	}
+
+	// Platforms without memory mapped files support
+	if (TArray<uint8> Data; FFileHelper::LoadFileToArray(Data, *ImagePath))
+	{
+		return MakeShared<FHttpGPTCachedImageData, ESPMode::ThreadSafe>(MoveTemp(Data));
+	}
+
+	return nullptr;
+}
+
+void FHttpGPTImageCache::Download(const FString& URL, const FHttpGPTImageCached& Callback)
+{
+	if (FString Hash; FindURL(URL, Hash))
+	{
+		UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Loading image %s from the cache"), *FString(__FUNCTION__), *Hash);
+
+		// Also deferred when called from the game thread, so callers never receive the result before this function returns
+		AsyncTask(ENamedThreads::GameThread, [Callback, Hash]
+		{
+			Callback.ExecuteIfBound(Hash);
+		});
+
+		return;
+	}
+
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
+	HttpRequest->SetURL(URL);
+	HttpRequest->SetVerb("GET");
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4)
+	// Stream the response body straight to the disk instead of keeping it in memory
+	IFileManager::Get().MakeDirectory(*GetCacheDirectory(), true);
+	const FString DownloadPath = FPaths::CreateTempFilename(*GetCacheDirectory(), TEXT("Download"), TEXT(".tmp"));
+
+	const TSharedPtr<FArchive> DownloadStream(IFileManager::Get().CreateFileWriter(*DownloadPath));
+	if (DownloadStream.IsValid())
+	{
+		HttpRequest->SetResponseBodyReceiveStream(DownloadStream.ToSharedRef());
+	}
+#endif
+
+	HttpRequest->OnProcessRequestComplete().BindLambda([=](FHttpRequestPtr Request, const FHttpResponsePtr& Response, bool bSuccess)
+	{
+		if (!bSuccess || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+		{
+			UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to download image"), *FString(__FUNCTION__));
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4)
+			if (DownloadStream.IsValid())
+			{
+				DownloadStream->Close();
+				IFileManager::Get().Delete(*DownloadPath, false, true, true);
+			}
+#endif
+
+			Callback.ExecuteIfBound(FString());
+			return;
+		}
+
+		Async(EAsyncExecution::ThreadPool, [=]
+		{
+			FString Hash;
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4)
+			if (DownloadStream.IsValid())
+			{
+				DownloadStream->Close();
+				Hash = Get().StoreFile(DownloadPath, URL);
+			}
+			else
+#endif
+			{
+				Hash = Get().Store(Response->GetContent().GetData(), Response->GetContent().Num(), URL);
+			}
+
+			AsyncTask(ENamedThreads::GameThread, [Callback, Hash]
+			{
+				Callback.ExecuteIfBound(Hash);
+			});
+		});
+	});
+
+	HttpRequest->ProcessRequest();
+}
+
+void FHttpGPTImageCache::AddToIndex(const FString& URL, const FString& Hash)
+{
+	if (HttpGPT::Internal::HasEmptyParam(URL, Hash))
+	{
+		return;
+	}
+
+	FScopeLock Lock(&Mutex);
+
+	URLIndex.Add(GetIndexKey(URL), Hash);
+
+	if (bIndexSaveScheduled)
+	{
+		return;
+	}
+
+	bIndexSaveScheduled = true;
+
+	// Images are stored from worker threads: the ticker is only used from the game thread
+	AsyncTask(ENamedThreads::GameThread, []
+	{
+		constexpr float SaveIndexDelay = 1.f;
+		const FTickerDelegate TickerDelegate = FTickerDelegate::CreateLambda([]([[maybe_unused]] const float DeltaTime)
+		{
+			Get().FlushIndex();
+			return false;
+		});
+
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().AddTicker(TickerDelegate, SaveIndexDelay);
+#else
+		FTicker::GetCoreTicker().AddTicker(TickerDelegate, SaveIndexDelay);
+#endif
+	});
+}
+
+void FHttpGPTImageCache::LoadIndex()
+{
+	FScopeLock Lock(&Mutex);
+
+	FString FileContent;
+	if (!FFileHelper::LoadFileToString(FileContent, *GetIndexPath()))
+	{
+		return;
+	}
+
+	TSharedPtr<FJsonObject> JsonParsed;
+	if (const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContent); !FJsonSerializer::Deserialize(Reader, JsonParsed))
+	{
+		UE_LOG(LogHttpGPT, Warning, TEXT("%s: Failed to read the image cache index"), *FString(__FUNCTION__));
+		return;
+	}
+
+	// JSON object fields ignore case, so the URLs are stored in an array
+	if (const TArray<TSharedPtr<FJsonValue>>* Entries; JsonParsed->TryGetArrayField(TEXT("entries"), Entries))
+	{
+		for (const TSharedPtr<FJsonValue>& Entry : *Entries)
+		{
+			const TSharedPtr<FJsonObject>* EntryObj;
+			if (FString URL, Hash; Entry->TryGetObject(EntryObj) && (*EntryObj)->TryGetStringField(TEXT("url"), URL) && (*EntryObj)->TryGetStringField(
+				TEXT("hash"), Hash))
+			{
+				URLIndex.Add(URL, Hash);
+			}
+		}
+
+		return;
+	}
+
+	// Index written by previous versions, keyed by the URLs without their query
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Item : JsonParsed->Values)
+	{
+		if (FString Hash; Item.Value->TryGetString(Hash))
+		{
+			URLIndex.Add(Item.Key, Hash);
+		}
+	}
+}
+
+void FHttpGPTImageCache::FlushIndex()
+{
+	const TSharedPtr<FJsonObject> JsonIndex = MakeShared<FJsonObject>();
+	{
+		FScopeLock Lock(&Mutex);
+
+		if (!bIndexSaveScheduled)
+		{
+			return;
+		}
+
+		bIndexSaveScheduled = false;
+
+		TArray<TSharedPtr<FJsonValue>> Entries;
+		Entries.Reserve(URLIndex.Num());
+
+		for (const TPair<FString, FString>& Item : URLIndex)
+		{
+			const TSharedPtr<FJsonObject> EntryObj = MakeShared<FJsonObject>();
+			EntryObj->SetStringField(TEXT("url"), Item.Key);
+			EntryObj->SetStringField(TEXT("hash"), Item.Value);
+
+			Entries.Add(MakeShared<FJsonValueObject>(EntryObj));
+		}
+
+		JsonIndex->SetArrayField(TEXT("entries"), Entries);
+	}
+
+	FString IndexContent;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&IndexContent);
+
+	if (FJsonSerializer::Serialize(JsonIndex.ToSharedRef(), Writer))
+	{
+		FFileHelper::SaveStringToFile(IndexContent, *GetIndexPath());
+	}
+}
@@ -0,0 +1,392 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Management/HttpGPTImagePipeline.h"
+#include "Management/HttpGPTImageCache.h"
+#include "Utils/HttpGPTImageDecoder.h"
+#include <Utils/HttpGPTBase64.h>
+#include <Management/HttpGPTSettings.h>
+#include <LogHttpGPT.h>
+
+#include <Async/Async.h>
+#include <Engine/Texture2D.h>
+
+TSharedRef<FHttpGPTImagePipeline, ESPMode::ThreadSafe> FHttpGPTImagePipeline::Create(const TArray<FHttpGPTImageData>& Images)
+{
+	return MakeShared<FHttpGPTImagePipeline, ESPMode::ThreadSafe>(Images);
+}
+
+TSharedRef<FHttpGPTImagePipeline, ESPMode::ThreadSafe> FHttpGPTImagePipeline::CreateFromCache(const TArray<FString>& Hashes)
+{
+	TArray<FHttpGPTImageData> Images;
+	Images.SetNum(Hashes.Num());
+
+	const TSharedRef<FHttpGPTImagePipeline, ESPMode::ThreadSafe> Output = MakeShared<FHttpGPTImagePipeline, ESPMode::ThreadSafe>(Images);
+	for (int32 Index = 0; Index < Hashes.Num(); ++Index)
+	{
+		Output->Entries[Index].CachedHash = Hashes[Index];
+	}
+
+	return Output;
+}
+
+FHttpGPTImagePipeline::FHttpGPTImagePipeline(const TArray<FHttpGPTImageData>& Images)
+{
+	Entries.Reserve(Images.Num());
+	for (const FHttpGPTImageData& Image : Images)
+	{
+		FImageEntry NewEntry;
+		NewEntry.Data = Image;
+		Entries.Add(MoveTemp(NewEntry));
+	}
+
+	Textures.SetNumZeroed(Images.Num());
+}
+
+FHttpGPTImagePipeline::~FHttpGPTImagePipeline()
+{
+	for (const FImageEntry& Entry : Entries)
+	{
+		delete Entry.PlatformData;
+	}
+}
+
+void FHttpGPTImagePipeline::Start()
+{
+	check(IsInGameThread());
+
+	if (bIsRunning)
+	{
+		return;
+	}
+
+	bIsRunning = true;
+	SelfReference = AsShared();
+
+	FHttpGPTImageDecoder::LoadModules();
+
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		// Cached and encoded images are already available and skip the fetch stage
+		if (Entries[Index].CachedHash.IsEmpty() && Entries[Index].Data.Format == EHttpGPTResponseFormat::url)
+		{
+			FetchQueue.Add(Index);
+		}
+		else
+		{
+			DecodeQueue.Add(Index);
+		}
+	}
+
+	const FTickerDelegate TickerDelegate = FTickerDelegate::CreateSP(this, &FHttpGPTImagePipeline::TickUpload);
+
+#if ENGINE_MAJOR_VERSION >= 5
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TickerDelegate);
+#else
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(TickerDelegate);
+#endif
+
+	PumpFetch();
+	PumpDecode();
+}
+
+void FHttpGPTImagePipeline::Cancel()
+{
+	check(IsInGameThread());
+
+	if (!bIsRunning)
+	{
+		return;
+	}
+
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s: Cancelling image pipeline"), *FString(__FUNCTION__));
+
+	FetchQueue.Empty();
+	DecodeQueue.Empty();
+
+	Finish();
+}
+
+bool FHttpGPTImagePipeline::IsRunning() const
+{
+	return bIsRunning;
+}
+
+int32 FHttpGPTImagePipeline::Num() const
+{
+	return Entries.Num();
+}
+
+EHttpGPTImageStage FHttpGPTImagePipeline::GetStage(const int32 Index) const
+{
+	return Entries.IsValidIndex(Index) ? Entries[Index].Stage : EHttpGPTImageStage::Failed;
+}
+
+FString FHttpGPTImagePipeline::GetImageHash(const int32 Index) const
+{
+	return Entries.IsValidIndex(Index) ? Entries[Index].CachedHash : FString();
+}
+
+TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> FHttpGPTImagePipeline::GetEncodedImage(const int32 Index) const
+{
+	return Entries.IsValidIndex(Index) ? Entries[Index].EncodedImage : nullptr;
+}
+
+void FHttpGPTImagePipeline::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	// Delivered textures must survive until the completion callback takes ownership of them
+	for (UTexture2D*& Texture : Textures)
+	{
+		Collector.AddReferencedObject(Texture);
+	}
+}
+
+FString FHttpGPTImagePipeline::GetReferencerName() const
+{
+	return TEXT("FHttpGPTImagePipeline");
+}
+
+void FHttpGPTImagePipeline::SetStage(const int32 Index, const EHttpGPTImageStage Stage)
+{
+	Entries[Index].Stage = Stage;
+	OnStageChanged.ExecuteIfBound(Index, Stage);
+}
+
+void FHttpGPTImagePipeline::PumpFetch()
+{
+	const int32 MaxFetches = FMath::Max(UHttpGPTSettings::Get()->ImageFetchConcurrency, 1);
+
+	while (bIsRunning && ActiveFetches < MaxFetches && FetchQueue.Num() > 0)
+	{
+		const int32 Index = FetchQueue[0];
+		FetchQueue.RemoveAt(0);
+
+		// Images already downloaded go straight to the decode stage without taking a fetch slot
+		if (FString Hash; FHttpGPTImageCache::Get().FindURL(Entries[Index].Data.Content, Hash))
+		{
+			Entries[Index].CachedHash = Hash;
+			DecodeQueue.Add(Index);
+			continue;
+		}
+
+		++ActiveFetches;
+		SetStage(Index, EHttpGPTImageStage::Fetching);
+
+		TWeakPtr<FHttpGPTImagePipeline, ESPMode::ThreadSafe> WeakThis = AsShared();
+		FHttpGPTImageCache::Get().Download(Entries[Index].Data.Content, FHttpGPTImageCached::CreateLambda([WeakThis, Index](const FString& Hash)
+		{
+			if (const TSharedPtr<FHttpGPTImagePipeline, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			{
+				This->OnFetchCompleted(Index, Hash);
+			}
+		}));
+	}
+}
+
+void FHttpGPTImagePipeline::OnFetchCompleted(const int32 Index, const FString& Hash)
+{
+	--ActiveFetches;
+
+	if (!bIsRunning)
+	{
+		return;
+	}
+
+	if (Hash.IsEmpty())
+	{
+		SetStage(Index, EHttpGPTImageStage::Failed);
+	}
+	else
+	{
+		Entries[Index].CachedHash = Hash;
+		DecodeQueue.Add(Index);
+	}
+
+	PumpFetch();
+	PumpDecode();
+}
+
+void FHttpGPTImagePipeline::PumpDecode()
+{
+	const int32 MaxDecodes = FMath::Max(UHttpGPTSettings::Get()->ImageDecodeConcurrency, 1);
+
+	// Decode in the input order so the images are ready in the order they are delivered
+	DecodeQueue.Sort();
+
+	while (bIsRunning && ActiveDecodes < MaxDecodes && DecodeQueue.Num() > 0)
+	{
+		const int32 Index = DecodeQueue[0];
+		DecodeQueue.RemoveAt(0);
+
+		++ActiveDecodes;
+		SetStage(Index, EHttpGPTImageStage::Decoding);
+
+		TWeakPtr<FHttpGPTImagePipeline, ESPMode::ThreadSafe> WeakThis = AsShared();
+		Async(EAsyncExecution::ThreadPool, [WeakThis, Index, Data = Entries[Index].Data, CachedHash = Entries[Index].CachedHash,
+			       bStoreEncoded = bStoreEncodedImages, MaxSize = MaxImageSize, bMips = bGenerateMips]() mutable
+		{
+			TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> EncodedImage;
+			FTexturePlatformData* const PlatformData = DecodeImage(Data, CachedHash, EncodedImage, bStoreEncoded, MaxSize, bMips);
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, Index, PlatformData, CachedHash, EncodedImage]
+			{
+				if (const TSharedPtr<FHttpGPTImagePipeline, ESPMode::ThreadSafe> This = WeakThis.Pin())
+				{
+					This->OnDecodeCompleted(Index, PlatformData, CachedHash, EncodedImage);
+				}
+				else
+				{
+					delete PlatformData;
+				}
+			});
+		});
+	}
+}
+
+void FHttpGPTImagePipeline::OnDecodeCompleted(const int32 Index, FTexturePlatformData* const PlatformData, const FString& Hash,
+                                              const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& EncodedImage)
+{
+	--ActiveDecodes;
+
+	if (!bIsRunning)
+	{
+		delete PlatformData;
+		return;
+	}
+
+	Entries[Index].CachedHash = Hash;
+	Entries[Index].EncodedImage = EncodedImage;
+
+	if (PlatformData)
+	{
+		Entries[Index].PlatformData = PlatformData;
+		SetStage(Index, EHttpGPTImageStage::Uploading);
+	}
+	else
+	{
+		SetStage(Index, EHttpGPTImageStage::Failed);
+	}
+
+	PumpDecode();
+}
+
+FTexturePlatformData* FHttpGPTImagePipeline::DecodeImage(const FHttpGPTImageData& Data, FString& InOutHash,
+                                                        TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& OutEncodedImage, const bool bStoreEncoded,
+                                                        const int32 MaxSize, const bool bMips)
+{
+	FHttpGPTDecodedImage DecodedImage;
+
+	if (!InOutHash.IsEmpty())
+	{
+		const TSharedPtr<FHttpGPTCachedImageData, ESPMode::ThreadSafe> CachedImage = FHttpGPTImageCache::Get().Load(InOutHash);
+		if (!CachedImage.IsValid() || !FHttpGPTImageDecoder::Decode(CachedImage->GetData(), CachedImage->GetSize(), DecodedImage))
+		{
+			return nullptr;
+		}
+	}
+	else
+	{
+		TArray<uint8> DecodedBytes;
+		if (!Data.DecodedContent.IsValid())
+		{
+			const bool bDecoded = Data.EncodedContent.IsValid()
+				                      ? FHttpGPTBase64::Decode(Data.EncodedContent->GetData(), Data.EncodedContent->Num(), DecodedBytes)
+				                      : FHttpGPTBase64::Decode(*Data.Content, Data.Content.Len(), DecodedBytes);
+
+			if (!bDecoded)
+			{
+				return nullptr;
+			}
+		}
+
+		const TArray<uint8>& ImageBytes = Data.DecodedContent.IsValid() ? *Data.DecodedContent : DecodedBytes;
+		if (!FHttpGPTImageDecoder::Decode(ImageBytes.GetData(), ImageBytes.Num(), DecodedImage))
+		{
+			return nullptr;
+		}
+
+		if (bStoreEncoded)
+		{
+			InOutHash = FHttpGPTImageCache::Get().Store(ImageBytes.GetData(), ImageBytes.Num());
+		}
+
+		// Without the disk cache, the encoded image is the only way to reload the full image later
+		if (bStoreEncoded && InOutHash.IsEmpty())
+		{
+			OutEncodedImage = Data.DecodedContent.IsValid() ? Data.DecodedContent : MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(DecodedBytes));
+		}
+	}
+
+	if (MaxSize > 0)
+	{
+		FHttpGPTImageDecoder::Resize(DecodedImage, MaxSize);
+	}
+
+	return FHttpGPTImageDecoder::CreatePlatformData(DecodedImage, bMips);
+}
+
+bool FHttpGPTImagePipeline::TickUpload([[maybe_unused]] const float DeltaTime)
+{
+	if (!bIsRunning)
+	{
+		return false;
+	}
+
+	const int32 MaxUploads = FMath::Max(UHttpGPTSettings::Get()->ImageUploadsPerFrame, 1);
+	int32 Uploads = 0;
+
+	// Keep the reference until the end of the tick: the last delivery may release the pipeline owner
+	const TSharedRef<FHttpGPTImagePipeline, ESPMode::ThreadSafe> ThisRef = AsShared();
+
+	while (NextDelivery < Entries.Num() && Uploads < MaxUploads)
+	{
+		FImageEntry& Entry = Entries[NextDelivery];
+
+		if (Entry.Stage == EHttpGPTImageStage::Uploading)
+		{
+			Textures[NextDelivery] = FHttpGPTImageDecoder::CreateTexture(Entry.PlatformData);
+			Entry.PlatformData = nullptr;
+			++Uploads;
+
+			SetStage(NextDelivery, Textures[NextDelivery] ? EHttpGPTImageStage::Completed : EHttpGPTImageStage::Failed);
+		}
+		else if (Entry.Stage != EHttpGPTImageStage::Failed)
+		{
+			// Wait for this image to preserve the delivery order
+			break;
+		}
+
+		const int32 DeliveredIndex = NextDelivery++;
+		OnImageReady.ExecuteIfBound(DeliveredIndex, Textures[DeliveredIndex]);
+
+		if (!bIsRunning)
+		{
+			return false;
+		}
+	}
+
+	if (NextDelivery >= Entries.Num())
+	{
+		OnCompleted.ExecuteIfBound(Textures);
+		Finish();
+
+		return false;
+	}
+
+	return true;
+}
+
+void FHttpGPTImagePipeline::Finish()
+{
+	bIsRunning = false;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#else
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#endif
+
+	TickerHandle.Reset();
+	SelfReference.Reset();
+}
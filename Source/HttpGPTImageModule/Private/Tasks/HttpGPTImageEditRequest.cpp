@@ -0,0 +1,87 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Tasks/HttpGPTImageEditRequest.h"
+#include <Utils/HttpGPTMultipartWriter.h>
+#include <HttpGPTInternalFuncs.h>
+
+#if WITH_EDITOR
+#include <Editor.h>
+#endif
+
+#ifdef UE_INLINE_GENERATED_CPP_BY_NAME
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HttpGPTImageEditRequest)
+#endif
+
+#if WITH_EDITOR
+UHttpGPTImageEditRequest* UHttpGPTImageEditRequest::EditorTask(const FHttpGPTImageInput& Image, const FHttpGPTImageInput& Mask, const FString& Prompt,
+                                                               const FHttpGPTImageOptions Options)
+{
+	UHttpGPTImageEditRequest* const NewAsyncTask = EditImage_CustomOptions(GEditor->GetEditorWorldContext().World(), Image, Mask, Prompt,
+	                                                                       FHttpGPTCommonOptions(), Options);
+	NewAsyncTask->bIsEditorTask = true;
+
+	return NewAsyncTask;
+}
+#endif
+
+UHttpGPTImageEditRequest* UHttpGPTImageEditRequest::EditImage_DefaultOptions(UObject* const WorldContextObject, const FHttpGPTImageInput& Image,
+                                                                             const FHttpGPTImageInput& Mask, const FString& Prompt)
+{
+	return EditImage_CustomOptions(WorldContextObject, Image, Mask, Prompt, FHttpGPTCommonOptions(), FHttpGPTImageOptions());
+}
+
+UHttpGPTImageEditRequest* UHttpGPTImageEditRequest::EditImage_CustomOptions(UObject* const WorldContextObject, const FHttpGPTImageInput& Image,
+                                                                            const FHttpGPTImageInput& Mask, const FString& Prompt,
+                                                                            const FHttpGPTCommonOptions CommonOptions,
+                                                                            const FHttpGPTImageOptions ImageOptions)
+{
+	UHttpGPTImageEditRequest* const NewAsyncTask = NewObject<UHttpGPTImageEditRequest>();
+	NewAsyncTask->Prompt = Prompt;
+	NewAsyncTask->CommonOptions = CommonOptions;
+	NewAsyncTask->ImageOptions = ImageOptions;
+
+	NewAsyncTask->bHasInvalidInput = !ReadImageInput(Image, NewAsyncTask->ImagePixels, NewAsyncTask->ImagePath);
+
+	if (Mask.IsSet())
+	{
+		NewAsyncTask->bHasInvalidInput |= !ReadImageInput(Mask, NewAsyncTask->MaskPixels, NewAsyncTask->MaskPath);
+	}
+
+	NewAsyncTask->RegisterWithGameInstance(WorldContextObject);
+
+	return NewAsyncTask;
+}
+
+FString UHttpGPTImageEditRequest::GetEndpointURL() const
+{
+	return FString::Format(TEXT("{0}/v1/images/edits"), {GetCommonOptions().Endpoint});
+}
+
+FString UHttpGPTImageEditRequest::SetRequestContent()
+{
+	FScopeLock Lock(&Mutex);
+
+	const FString Output = Super::SetRequestContent();
+	MaskPixels = FHttpGPTDecodedImage();
+
+	return Output;
+}
+
+bool UHttpGPTImageEditRequest::AppendFormFields(FHttpGPTMultipartWriter& Writer) const
+{
+	if (!Super::AppendFormFields(Writer))
+	{
+		return false;
+	}
+
+	if ((MaskPixels.IsValid() || !HttpGPT::Internal::HasEmptyParam(MaskPath)) && !AppendImage(Writer, TEXT("mask"), MaskPixels, MaskPath))
+	{
+		return false;
+	}
+
+	Writer.AddField(TEXT("prompt"), Prompt);
+
+	return Writer.IsValid();
+}
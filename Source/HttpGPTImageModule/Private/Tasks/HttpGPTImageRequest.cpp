@@ -3,6 +3,7 @@
 // Repo: https://github.com/lucoiso/UEHttpGPT
 
 #include "Tasks/HttpGPTImageRequest.h"
+#include "Management/HttpGPTImagePipeline.h"
 #include <Utils/HttpGPTHelper.h>
 #include <Management/HttpGPTSettings.h>
 #include <HttpGPTInternalFuncs.h>
@@ -18,8 +19,6 @@
 #include <Misc/ScopeTryLock.h>
 #include <Async/Async.h>
 #include <Engine/Texture2D.h>
-#include <Misc/Base64.h>
-#include <ImageUtils.h>
 
 #if WITH_EDITOR
 #include <Editor.h>
@@ -90,6 +89,12 @@ bool UHttpGPTImageRequest::CanBindProgress() const
 	return false;
 }
 
+bool UHttpGPTImageRequest::CanCacheResponse() const
+{
+	// Generated image URLs expire after a while, only the encoded data can be reused
+	return Super::CanCacheResponse() && GetImageOptions().Format == EHttpGPTResponseFormat::b64_json;
+}
+
 FString UHttpGPTImageRequest::GetEndpointURL() const
 {
 	if (CommonOptions.bIsAzureOpenAI)
@@ -131,6 +136,76 @@ FString UHttpGPTImageRequest::SetRequestContent()
 	return RequestContentString;
 }
 
+template <typename CharType>
+static int32 FindText(const CharType* const Content, const int32 Length, const ANSICHAR* const Text, const int32 Start)
+{
+	const int32 TextLength = FCStringAnsi::Strlen(Text);
+
+	for (int32 Index = Start; Index <= Length - TextLength; ++Index)
+	{
+		int32 Matched = 0;
+		while (Matched < TextLength && Content[Index + Matched] == static_cast<CharType>(Text[Matched]))
+		{
+			++Matched;
+		}
+
+		if (Matched == TextLength)
+		{
+			return Index;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+template <typename CharType>
+FString UHttpGPTImageRequest::ExtractEncodedImages(const CharType* const Content, const int32 Length, TArray<FHttpGPTImageData>& OutImages) const
+{
+	static constexpr ANSICHAR FieldKey[] = "\"b64_json\"";
+
+	TArray<CharType> Output;
+	Output.Reserve(1024);
+
+	int32 CopyStart = 0;
+	for (int32 KeyIndex = FindText(Content, Length, FieldKey, 0); KeyIndex != INDEX_NONE; KeyIndex = FindText(Content, Length, FieldKey, CopyStart))
+	{
+		const int32 ValueStart = FindText(Content, Length, "\"", KeyIndex + UE_ARRAY_COUNT(FieldKey) - 1);
+		const int32 ValueEnd = ValueStart == INDEX_NONE ? INDEX_NONE : FindText(Content, Length, "\"", ValueStart + 1);
+
+		if (ValueEnd == INDEX_NONE)
+		{
+			break;
+		}
+
+		// Keep the field as an empty string so the remaining response is still valid JSON
+		Output.Append(Content + CopyStart, ValueStart + 1 - CopyStart);
+		CopyStart = ValueEnd;
+
+		// Base64 is plain ASCII: the payload is copied as single-byte text and decoded later by the image pipeline workers
+		const TSharedPtr<TArray<ANSICHAR>, ESPMode::ThreadSafe> EncodedImage = MakeShared<TArray<ANSICHAR>, ESPMode::ThreadSafe>();
+		EncodedImage->SetNumUninitialized(ValueEnd - ValueStart - 1);
+
+		for (int32 Index = 0; Index < EncodedImage->Num(); ++Index)
+		{
+			(*EncodedImage)[Index] = static_cast<ANSICHAR>(Content[ValueStart + 1 + Index]);
+		}
+
+		OutImages.Add(FHttpGPTImageData(EncodedImage, EHttpGPTResponseFormat::b64_json));
+	}
+
+	Output.Append(Content + CopyStart, Length - CopyStart);
+
+	if constexpr (std::is_same_v<CharType, ANSICHAR>)
+	{
+		const FUTF8ToTCHAR OutputText(Output.GetData(), Output.Num());
+		return FString(OutputText.Length(), OutputText.Get());
+	}
+	else
+	{
+		return FString(Output.Num(), Output.GetData());
+	}
+}
+
 void UHttpGPTImageRequest::OnProgressCompleted(const FString& Content, const bool bWasSuccessful)
 {
 	FScopeLock Lock(&Mutex);
@@ -146,10 +221,37 @@ void UHttpGPTImageRequest::OnProgressCompleted(const FString& Content, const boo
 		return;
 	}
 
-	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s (%d): Process Completed"), *FString(__FUNCTION__), GetUniqueID());
-	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s (%d): Content: %s"), *FString(__FUNCTION__), GetUniqueID(), *Content);
+	// Cached and deduplicated responses are only available as text
+	TArray<FHttpGPTImageData> EncodedImages;
+	const FString JsonContent = GetImageOptions().Format == EHttpGPTResponseFormat::b64_json
+		                            ? ExtractEncodedImages(*Content, Content.Len(), EncodedImages)
+		                            : Content;
 
-	DeserializeResponse(Content);
+	DeserializeResponse(JsonContent, EncodedImages);
+	BroadcastResponse();
+}
+
+void UHttpGPTImageRequest::OnResponseCompleted(const TArray<uint8>& Content, const bool bWasSuccessful)
+{
+	if (!bWasSuccessful || GetImageOptions().Format != EHttpGPTResponseFormat::b64_json || HttpGPT::Internal::HasEmptyParam(Content))
+	{
+		Super::OnResponseCompleted(Content, bWasSuccessful);
+		return;
+	}
+
+	FScopeLock Lock(&Mutex);
+
+	// The images are decoded straight from the UTF-8 response: only the small remaining JSON is converted to text
+	TArray<FHttpGPTImageData> EncodedImages;
+	const FString JsonContent = ExtractEncodedImages(reinterpret_cast<const ANSICHAR*>(Content.GetData()), Content.Num(), EncodedImages);
+
+	DeserializeResponse(JsonContent, EncodedImages);
+	BroadcastResponse();
+}
+
+void UHttpGPTImageRequest::BroadcastResponse()
+{
+	FScopeLock Lock(&Mutex);
 
 	if (Response.bSuccess)
 	{
@@ -170,10 +272,13 @@ void UHttpGPTImageRequest::OnProgressCompleted(const FString& Content, const boo
 	}
 }
 
-void UHttpGPTImageRequest::DeserializeResponse(const FString& Content)
+void UHttpGPTImageRequest::DeserializeResponse(const FString& Content, const TArray<FHttpGPTImageData>& EncodedImages)
 {
 	FScopeLock Lock(&Mutex);
 
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s (%d): Process Completed"), *FString(__FUNCTION__), GetUniqueID());
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s (%d): Content: %s"), *FString(__FUNCTION__), GetUniqueID(), *Content);
+
 	if (HttpGPT::Internal::HasEmptyParam(Content))
 	{
 		return;
@@ -195,6 +300,14 @@ void UHttpGPTImageRequest::DeserializeResponse(const FString& Content)
 	const TArray<TSharedPtr<FJsonValue>> DataArray = JsonResponse->GetArrayField(TEXT("data"));
 	for (auto Iterator = DataArray.CreateConstIterator(); Iterator; ++Iterator)
 	{
+		if (GetImageOptions().Format == EHttpGPTResponseFormat::b64_json)
+		{
+			Response.Data.Add(EncodedImages.IsValidIndex(Iterator.GetIndex())
+				                  ? EncodedImages[Iterator.GetIndex()]
+				                  : FHttpGPTImageData(FString(), GetImageOptions().Format));
+			continue;
+		}
+
 		Response.Data.Add(FHttpGPTImageData(
 			(*Iterator)->AsObject()->GetStringField(UHttpGPTHelper::FormatToName(GetImageOptions().Format).ToString()), GetImageOptions().Format));
 	}
@@ -205,45 +318,48 @@ UHttpGPTImageRequest* UHttpGPTImageHelper::CastToHttpGPTImageRequest(UObject* co
 	return Cast<UHttpGPTImageRequest>(Object);
 }
 
+FString UHttpGPTImageHelper::GetImageContent(const FHttpGPTImageData& ImageData)
+{
+	return ImageData.GetContent();
+}
+
 void UHttpGPTImageHelper::GenerateImage(const FHttpGPTImageData& ImageData, const FHttpGPTImageGenerate& Callback)
 {
-	switch (ImageData.Format)
+	GenerateImages({ImageData}, [Callback](const TArray<UTexture2D*>& Images)
 	{
-	case EHttpGPTResponseFormat::url:
-		GenerateImageFromURL(ImageData, Callback);
-		break;
-
-	case EHttpGPTResponseFormat::b64_json:
-		GenerateImageFromB64(ImageData, Callback);
-		break;
+		Callback.ExecuteIfBound(Images.IsValidIndex(0) ? Images[0] : nullptr);
+	});
+}
 
-	default:
-		break;
-	}
+void UHttpGPTImageHelper::GenerateImages(const TArray<FHttpGPTImageData>& ImagesData, const FHttpGPTImagesGenerate& Callback)
+{
+	GenerateImages(ImagesData, [Callback](const TArray<UTexture2D*>& Images)
+	{
+		Callback.ExecuteIfBound(Images);
+	});
 }
 
-void UHttpGPTImageHelper::GenerateImageFromURL(const FHttpGPTImageData& ImageData, const FHttpGPTImageGenerate& Callback)
+void UHttpGPTImageHelper::GenerateImages(const TArray<FHttpGPTImageData>& ImagesData, TFunction<void(const TArray<UTexture2D*>&)>&& Callback)
 {
-	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
-	HttpRequest->SetURL(ImageData.Content);
-	HttpRequest->SetVerb("GET");
-	HttpRequest->OnProcessRequestComplete().BindLambda([=](FHttpRequestPtr Request, const FHttpResponsePtr& Response, bool bSuccess)
+	if (HttpGPT::Internal::HasEmptyParam(ImagesData))
 	{
-		if (bSuccess && Response.IsValid())
-		{
-			Callback.ExecuteIfBound(FImageUtils::ImportBufferAsTexture2D(Response->GetContent()));
-		}
-		else
-		{
-			Callback.ExecuteIfBound(nullptr);
-		}
+		Callback(TArray<UTexture2D*>());
+		return;
+	}
+
+	const TSharedRef<FHttpGPTImagePipeline, ESPMode::ThreadSafe> Pipeline = FHttpGPTImagePipeline::Create(ImagesData);
+	Pipeline->OnCompleted.BindLambda([Callback = MoveTemp(Callback)](const TArray<UTexture2D*>& Images)
+	{
+		Callback(Images);
 	});
-	HttpRequest->ProcessRequest();
+
+	Pipeline->Start();
 }
 
-void UHttpGPTImageHelper::GenerateImageFromB64(const FHttpGPTImageData& ImageData, const FHttpGPTImageGenerate& Callback)
+void UHttpGPTImageHelper::EncodeChatImage(const FHttpGPTVisionSource& Source, const FHttpGPTChatImageEncoded& Callback)
 {
-	TArray<uint8> DecodedBytes;
-	FBase64::Decode(ImageData.Content, DecodedBytes);
-	Callback.ExecuteIfBound(FImageUtils::ImportBufferAsTexture2D(DecodedBytes));
+	FHttpGPTVisionEncoder::Get().Encode(Source, FHttpGPTVisionEncoded::CreateLambda([Callback](const FHttpGPTChatImage& Image)
+	{
+		Callback.ExecuteIfBound(Image);
+	}));
 }
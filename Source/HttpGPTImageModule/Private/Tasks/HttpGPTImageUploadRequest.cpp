@@ -0,0 +1,194 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Tasks/HttpGPTImageUploadRequest.h"
+#include <Utils/HttpGPTHelper.h>
+#include <Utils/HttpGPTMultipartWriter.h>
+#include <HttpGPTInternalFuncs.h>
+#include <LogHttpGPT.h>
+
+#include <Interfaces/IHttpRequest.h>
+#include <Engine/Texture2D.h>
+#include <HAL/FileManager.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+
+#ifdef UE_INLINE_GENERATED_CPP_BY_NAME
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HttpGPTImageUploadRequest)
+#endif
+
+bool FHttpGPTImageInput::IsSet() const
+{
+	return IsValid(Texture) || !FilePath.IsEmpty();
+}
+
+void UHttpGPTImageUploadRequest::SetReadyToDestroy()
+{
+	{
+		FScopeLock Lock(&Mutex);
+
+		// A cancelled request may still have the file open: these are deleted in the next startup instead
+		const bool bIsStreamingFile = HttpRequest.IsValid() && HttpRequest->GetStatus() == EHttpRequestStatus::Processing;
+
+		if (!UploadFilePath.IsEmpty() && !bIsStreamingFile)
+		{
+			IFileManager::Get().Delete(*UploadFilePath, false, false, true);
+			UploadFilePath.Empty();
+		}
+	}
+
+	Super::SetReadyToDestroy();
+}
+
+bool UHttpGPTImageUploadRequest::ReadImageInput(const FHttpGPTImageInput& Input, FHttpGPTDecodedImage& OutPixels, FString& OutFilePath)
+{
+	FHttpGPTImageDecoder::LoadModules();
+
+	if (IsValid(Input.Texture))
+	{
+		if (!FHttpGPTImageDecoder::ReadTexture(Input.Texture, OutPixels))
+		{
+			UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to read the pixels of texture %s"), *FString(__FUNCTION__), *Input.Texture->GetName());
+			return false;
+		}
+
+		return true;
+	}
+
+	// Missing inputs are reported when the task is activated
+	OutFilePath = Input.FilePath;
+	return true;
+}
+
+bool UHttpGPTImageUploadRequest::CanActivateTask() const
+{
+	return Super::CanActivateTask() && CanUploadImage();
+}
+
+bool UHttpGPTImageUploadRequest::CanUploadImage() const
+{
+	if (GetCommonOptions().bIsAzureOpenAI)
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s (%d): Can't activate task: Image edits and variations are not available in Azure OpenAI."),
+		       *FString(__FUNCTION__), GetUniqueID());
+		return false;
+	}
+
+	if (bHasInvalidInput)
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s (%d): Can't activate task: Failed to read the image inputs."), *FString(__FUNCTION__), GetUniqueID());
+		return false;
+	}
+
+	if (!ImagePixels.IsValid() && HttpGPT::Internal::HasEmptyParam(ImagePath))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s (%d): Can't activate task: Invalid Image."), *FString(__FUNCTION__), GetUniqueID());
+		return false;
+	}
+
+	return true;
+}
+
+bool UHttpGPTImageUploadRequest::CanDeduplicateRequest() const
+{
+	// The request key would have to hash the whole image
+	return false;
+}
+
+bool UHttpGPTImageUploadRequest::CanCacheResponse() const
+{
+	return false;
+}
+
+FString UHttpGPTImageUploadRequest::SetRequestContent()
+{
+	FScopeLock Lock(&Mutex);
+
+	if (!HttpRequest.IsValid())
+	{
+		return FString();
+	}
+
+	UE_LOG(LogHttpGPT_Internal, Display, TEXT("%s (%d): Mounting content"), *FString(__FUNCTION__), GetUniqueID());
+
+	UploadFilePath = FHttpGPTMultipartWriter::CreateTempFilePath();
+
+	FHttpGPTMultipartWriter Writer(UploadFilePath);
+	const bool bFieldsWritten = Writer.IsValid() && AppendFormFields(Writer);
+
+	if (!Writer.Finish() || !bFieldsWritten || !HttpRequest->SetContentAsStreamedFile(UploadFilePath))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s (%d): Failed to write the request content"), *FString(__FUNCTION__), GetUniqueID());
+
+		// The base task reports the failure when the request object is invalid
+		HttpRequest.Reset();
+		return FString();
+	}
+
+	HttpRequest->SetHeader("Content-Type", Writer.GetContentType());
+
+	// The pixels are already encoded in the request body
+	ImagePixels = FHttpGPTDecodedImage();
+
+	return Writer.GetDescription();
+}
+
+bool UHttpGPTImageUploadRequest::AppendFormFields(FHttpGPTMultipartWriter& Writer) const
+{
+	if (!AppendImage(Writer, TEXT("image"), ImagePixels, ImagePath))
+	{
+		return false;
+	}
+
+	Writer.AddField(TEXT("n"), FString::FromInt(GetImageOptions().ImagesNum));
+	Writer.AddField(TEXT("size"), UHttpGPTHelper::SizeToName(GetImageOptions().Size).ToString());
+	Writer.AddField(TEXT("response_format"), UHttpGPTHelper::FormatToName(GetImageOptions().Format).ToString().ToLower());
+
+	if (!HttpGPT::Internal::HasEmptyParam(GetCommonOptions().User))
+	{
+		Writer.AddField(TEXT("user"), GetCommonOptions().User.ToString());
+	}
+
+	return Writer.IsValid();
+}
+
+bool UHttpGPTImageUploadRequest::AppendImage(FHttpGPTMultipartWriter& Writer, const FString& Name, const FHttpGPTDecodedImage& Pixels,
+                                             const FString& FilePath) const
+{
+	if (FilePath.IsEmpty())
+	{
+		TArray<uint8> EncodedImage;
+		if (!FHttpGPTImageDecoder::EncodePNG(Pixels, EncodedImage))
+		{
+			return false;
+		}
+
+		Writer.AddFile(Name, Name + TEXT(".png"), TEXT("image/png"), EncodedImage.GetData(), EncodedImage.Num());
+		return Writer.IsValid();
+	}
+
+	// The API only accepts PNG files: these are sent as they are, without being loaded into memory
+	if (FPaths::GetExtension(FilePath).Equals(TEXT("png"), ESearchCase::IgnoreCase))
+	{
+		Writer.AddFileFromDisk(Name, TEXT("image/png"), FilePath);
+		return Writer.IsValid();
+	}
+
+	TArray<uint8> FileData;
+	FHttpGPTDecodedImage DecodedImage;
+	if (!FFileHelper::LoadFileToArray(FileData, *FilePath) || !FHttpGPTImageDecoder::Decode(FileData.GetData(), FileData.Num(), DecodedImage))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s (%d): Failed to load image %s"), *FString(__FUNCTION__), GetUniqueID(), *FilePath);
+		return false;
+	}
+
+	TArray<uint8> EncodedImage;
+	if (!FHttpGPTImageDecoder::EncodePNG(DecodedImage, EncodedImage))
+	{
+		return false;
+	}
+
+	Writer.AddFile(Name, FPaths::GetBaseFilename(FilePath) + TEXT(".png"), TEXT("image/png"), EncodedImage.GetData(), EncodedImage.Num());
+	return Writer.IsValid();
+}
@@ -0,0 +1,57 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Tasks/HttpGPTImageVariationRequest.h"
+
+#if WITH_EDITOR
+#include <Editor.h>
+#endif
+
+#ifdef UE_INLINE_GENERATED_CPP_BY_NAME
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HttpGPTImageVariationRequest)
+#endif
+
+#if WITH_EDITOR
+UHttpGPTImageVariationRequest* UHttpGPTImageVariationRequest::EditorTask(const FHttpGPTImageInput& Image, const FHttpGPTImageOptions Options)
+{
+	UHttpGPTImageVariationRequest* const NewAsyncTask = RequestVariations_CustomOptions(GEditor->GetEditorWorldContext().World(), Image,
+	                                                                                    FHttpGPTCommonOptions(), Options);
+	NewAsyncTask->bIsEditorTask = true;
+
+	return NewAsyncTask;
+}
+#endif
+
+UHttpGPTImageVariationRequest* UHttpGPTImageVariationRequest::RequestVariations_DefaultOptions(UObject* const WorldContextObject,
+                                                                                               const FHttpGPTImageInput& Image)
+{
+	return RequestVariations_CustomOptions(WorldContextObject, Image, FHttpGPTCommonOptions(), FHttpGPTImageOptions());
+}
+
+UHttpGPTImageVariationRequest* UHttpGPTImageVariationRequest::RequestVariations_CustomOptions(UObject* const WorldContextObject,
+                                                                                              const FHttpGPTImageInput& Image,
+                                                                                              const FHttpGPTCommonOptions CommonOptions,
+                                                                                              const FHttpGPTImageOptions ImageOptions)
+{
+	UHttpGPTImageVariationRequest* const NewAsyncTask = NewObject<UHttpGPTImageVariationRequest>();
+	NewAsyncTask->CommonOptions = CommonOptions;
+	NewAsyncTask->ImageOptions = ImageOptions;
+
+	NewAsyncTask->bHasInvalidInput = !ReadImageInput(Image, NewAsyncTask->ImagePixels, NewAsyncTask->ImagePath);
+
+	NewAsyncTask->RegisterWithGameInstance(WorldContextObject);
+
+	return NewAsyncTask;
+}
+
+bool UHttpGPTImageVariationRequest::CanActivateTask() const
+{
+	// Variations don't use a prompt
+	return UHttpGPTBaseTask::CanActivateTask() && CanUploadImage();
+}
+
+FString UHttpGPTImageVariationRequest::GetEndpointURL() const
+{
+	return FString::Format(TEXT("{0}/v1/images/variations"), {GetCommonOptions().Endpoint});
+}
@@ -0,0 +1,297 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Utils/HttpGPTImageDecoder.h"
+#include <LogHttpGPT.h>
+
+#include <IImageWrapper.h>
+#include <IImageWrapperModule.h>
+#include <Modules/ModuleManager.h>
+#include <Engine/Texture2D.h>
+#include <ImageCore.h>
+#include <UObject/Package.h>
+
+void FHttpGPTImageDecoder::LoadModules()
+{
+	check(IsInGameThread());
+	FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+}
+
+bool FHttpGPTImageDecoder::Decode(const uint8* const Data, const int64 Size, FHttpGPTDecodedImage& OutImage)
+{
+	if (!Data || Size <= 0)
+	{
+		return false;
+	}
+
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::GetModuleChecked<IImageWrapperModule>("ImageWrapper");
+
+	const EImageFormat ImageFormat = ImageWrapperModule.DetectImageFormat(Data, Size);
+	if (ImageFormat == EImageFormat::Invalid)
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Unrecognized image format"), *FString(__FUNCTION__));
+		return false;
+	}
+
+	const TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(ImageFormat);
+	if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(Data, Size) || !ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, OutImage.RawData))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to decode image"), *FString(__FUNCTION__));
+		return false;
+	}
+
+	OutImage.SizeX = ImageWrapper->GetWidth();
+	OutImage.SizeY = ImageWrapper->GetHeight();
+
+	return OutImage.IsValid();
+}
+
+bool FHttpGPTImageDecoder::EncodePNG(const FHttpGPTDecodedImage& Image, TArray<uint8>& OutData)
+{
+	return Compress(Image, false, 100, OutData);
+}
+
+bool FHttpGPTImageDecoder::EncodeJPEG(const FHttpGPTDecodedImage& Image, const int32 Quality, TArray<uint8>& OutData)
+{
+	return Compress(Image, true, Quality, OutData);
+}
+
+bool FHttpGPTImageDecoder::Compress(const FHttpGPTDecodedImage& Image, const bool bJPEG, const int32 Quality, TArray<uint8>& OutData)
+{
+	if (!Image.IsValid())
+	{
+		return false;
+	}
+
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::GetModuleChecked<IImageWrapperModule>("ImageWrapper");
+
+	const TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(bJPEG ? EImageFormat::JPEG : EImageFormat::PNG);
+	if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(Image.RawData.GetData(), Image.RawData.Num(), Image.SizeX, Image.SizeY, ERGBFormat::BGRA, 8))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to encode image"), *FString(__FUNCTION__));
+		return false;
+	}
+
+	// The compressed array type depends on the engine version
+	const auto& CompressedData = ImageWrapper->GetCompressed(Quality);
+	OutData.Reset();
+	OutData.Append(CompressedData.GetData(), static_cast<int32>(CompressedData.Num()));
+
+	return OutData.Num() > 0;
+}
+
+bool FHttpGPTImageDecoder::ReadTexture(const UTexture2D* const Texture, FHttpGPTDecodedImage& OutImage)
+{
+	check(IsInGameThread());
+
+	if (!IsValid(Texture))
+	{
+		return false;
+	}
+
+#if WITH_EDITORONLY_DATA
+	// Imported textures keep the original pixels in the source data
+	if (Texture->Source.IsValid() && Texture->Source.GetFormat() != TSF_BGRA8)
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTextureSource& Source = const_cast<FTextureSource&>(Texture->Source);
+
+		// Other source formats, like grayscale or HDR images, are converted to BGRA8
+		FImage SourceImage;
+		if (Source.GetMipImage(SourceImage, 0, 0, 0))
+		{
+			FImage ConvertedImage;
+			SourceImage.CopyTo(ConvertedImage, ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+
+			OutImage.SizeX = ConvertedImage.SizeX;
+			OutImage.SizeY = ConvertedImage.SizeY;
+			OutImage.RawData.Append(ConvertedImage.RawData.GetData(), static_cast<int32>(ConvertedImage.RawData.Num()));
+
+			return OutImage.IsValid();
+		}
+#endif
+
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to convert the source pixels of texture %s to BGRA8"), *FString(__FUNCTION__), *Texture->GetName());
+		return false;
+	}
+
+	if (Texture->Source.IsValid())
+	{
+		FTextureSource& Source = const_cast<FTextureSource&>(Texture->Source);
+
+		OutImage.SizeX = Source.GetSizeX();
+		OutImage.SizeY = Source.GetSizeY();
+
+#if ENGINE_MAJOR_VERSION >= 5
+		const uint8* const SourceData = Source.LockMipReadOnly(0);
+#else
+		const uint8* const SourceData = Source.LockMip(0);
+#endif
+
+		if (SourceData)
+		{
+			OutImage.RawData.Append(SourceData, Source.CalcMipSize(0));
+		}
+
+		Source.UnlockMip(0);
+
+		return OutImage.IsValid();
+	}
+#endif
+
+#if ENGINE_MAJOR_VERSION >= 5
+	const FTexturePlatformData* const PlatformData = Texture->GetPlatformData();
+#else
+	const FTexturePlatformData* const PlatformData = Texture->PlatformData;
+#endif
+
+	// Transient textures, like the ones created by the image pipeline, keep their uncompressed pixels in the platform data
+	if (!PlatformData || PlatformData->PixelFormat != PF_B8G8R8A8 || PlatformData->Mips.Num() <= 0)
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Texture %s has no source data and its platform data is not uncompressed BGRA8"), *FString(__FUNCTION__), *Texture->GetName());
+		return false;
+	}
+
+	FByteBulkData& BulkData = const_cast<FByteBulkData&>(PlatformData->Mips[0].BulkData);
+	if (BulkData.GetBulkDataSize() <= 0)
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Texture %s pixels are not available in the CPU"), *FString(__FUNCTION__), *Texture->GetName());
+		return false;
+	}
+
+	OutImage.SizeX = PlatformData->Mips[0].SizeX;
+	OutImage.SizeY = PlatformData->Mips[0].SizeY;
+
+	const uint8* const MipData = static_cast<const uint8*>(BulkData.LockReadOnly());
+	OutImage.RawData.Append(MipData, BulkData.GetBulkDataSize());
+	BulkData.Unlock();
+
+	return OutImage.IsValid();
+}
+
+void FHttpGPTImageDecoder::Resize(FHttpGPTDecodedImage& Image, const int32 MaxSize)
+{
+	if (!Image.IsValid() || MaxSize <= 0 || (Image.SizeX <= MaxSize && Image.SizeY <= MaxSize))
+	{
+		return;
+	}
+
+	const float Scale = static_cast<float>(MaxSize) / FMath::Max(Image.SizeX, Image.SizeY);
+	Image = ResizeTo(Image, FMath::Max(FMath::RoundToInt(Image.SizeX * Scale), 1), FMath::Max(FMath::RoundToInt(Image.SizeY * Scale), 1));
+}
+
+FHttpGPTDecodedImage FHttpGPTImageDecoder::ResizeTo(const FHttpGPTDecodedImage& Image, const int32 TargetX, const int32 TargetY)
+{
+	FHttpGPTDecodedImage Output;
+	Output.SizeX = TargetX;
+	Output.SizeY = TargetY;
+	Output.RawData.SetNumUninitialized(TargetX * TargetY * 4);
+
+	// Average every source pixel covered by the target pixel
+	for (int32 TargetRow = 0; TargetRow < TargetY; ++TargetRow)
+	{
+		const int32 SourceRowStart = static_cast<int32>(static_cast<int64>(TargetRow) * Image.SizeY / TargetY);
+		const int32 SourceRowEnd = FMath::Max(static_cast<int32>(static_cast<int64>(TargetRow + 1) * Image.SizeY / TargetY), SourceRowStart + 1);
+
+		for (int32 TargetColumn = 0; TargetColumn < TargetX; ++TargetColumn)
+		{
+			const int32 SourceColumnStart = static_cast<int32>(static_cast<int64>(TargetColumn) * Image.SizeX / TargetX);
+			const int32 SourceColumnEnd = FMath::Max(static_cast<int32>(static_cast<int64>(TargetColumn + 1) * Image.SizeX / TargetX),
+			                                         SourceColumnStart + 1);
+
+			uint32 Sum[4] = {0u, 0u, 0u, 0u};
+			for (int32 SourceRow = SourceRowStart; SourceRow < SourceRowEnd; ++SourceRow)
+			{
+				const uint8* SourcePixel = Image.RawData.GetData() + (static_cast<int64>(SourceRow) * Image.SizeX + SourceColumnStart) * 4;
+				for (int32 SourceColumn = SourceColumnStart; SourceColumn < SourceColumnEnd; ++SourceColumn, SourcePixel += 4)
+				{
+					Sum[0] += SourcePixel[0];
+					Sum[1] += SourcePixel[1];
+					Sum[2] += SourcePixel[2];
+					Sum[3] += SourcePixel[3];
+				}
+			}
+
+			const uint32 Count = (SourceRowEnd - SourceRowStart) * (SourceColumnEnd - SourceColumnStart);
+			uint8* const TargetPixel = Output.RawData.GetData() + (static_cast<int64>(TargetRow) * TargetX + TargetColumn) * 4;
+			for (int32 Channel = 0; Channel < 4; ++Channel)
+			{
+				TargetPixel[Channel] = static_cast<uint8>((Sum[Channel] + Count / 2) / Count);
+			}
+		}
+	}
+
+	return Output;
+}
+
+FTexturePlatformData* FHttpGPTImageDecoder::CreatePlatformData(const FHttpGPTDecodedImage& Image, const bool bGenerateMips)
+{
+	if (!Image.IsValid())
+	{
+		return nullptr;
+	}
+
+	FTexturePlatformData* const PlatformData = new FTexturePlatformData();
+	PlatformData->SizeX = Image.SizeX;
+	PlatformData->SizeY = Image.SizeY;
+	PlatformData->SetNumSlices(1);
+	PlatformData->PixelFormat = PF_B8G8R8A8;
+
+	AddMip(PlatformData, Image);
+
+	if (bGenerateMips)
+	{
+		// Each mip is filtered from the previous one, down to 1x1
+		FHttpGPTDecodedImage PreviousMip;
+		const FHttpGPTDecodedImage* MipSource = &Image;
+
+		while (MipSource->SizeX > 1 || MipSource->SizeY > 1)
+		{
+			PreviousMip = ResizeTo(*MipSource, FMath::Max(MipSource->SizeX / 2, 1), FMath::Max(MipSource->SizeY / 2, 1));
+			MipSource = &PreviousMip;
+
+			AddMip(PlatformData, PreviousMip);
+		}
+	}
+
+	return PlatformData;
+}
+
+void FHttpGPTImageDecoder::AddMip(FTexturePlatformData* const PlatformData, const FHttpGPTDecodedImage& Image)
+{
+	FTexture2DMipMap* const Mip = new FTexture2DMipMap();
+	PlatformData->Mips.Add(Mip);
+	Mip->SizeX = Image.SizeX;
+	Mip->SizeY = Image.SizeY;
+
+	Mip->BulkData.Lock(LOCK_READ_WRITE);
+	void* const MipData = Mip->BulkData.Realloc(Image.RawData.Num());
+	FMemory::Memcpy(MipData, Image.RawData.GetData(), Image.RawData.Num());
+	Mip->BulkData.Unlock();
+}
+
+UTexture2D* FHttpGPTImageDecoder::CreateTexture(FTexturePlatformData* const PlatformData)
+{
+	check(IsInGameThread());
+
+	if (!PlatformData)
+	{
+		return nullptr;
+	}
+
+	UTexture2D* const Texture = NewObject<UTexture2D>(GetTransientPackage(), NAME_None, RF_Transient);
+	Texture->NeverStream = true;
+	Texture->SRGB = true;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	Texture->SetPlatformData(PlatformData);
+#else
+	Texture->PlatformData = PlatformData;
+#endif
+
+	// Only enqueues the resource creation: the RHI texture is initialized in the render thread
+	Texture->UpdateResource();
+
+	return Texture;
+}
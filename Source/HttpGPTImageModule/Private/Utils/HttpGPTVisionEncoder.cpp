@@ -0,0 +1,220 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#include "Utils/HttpGPTVisionEncoder.h"
+#include <HttpGPTInternalFuncs.h>
+#include <LogHttpGPT.h>
+
+#include <Async/Async.h>
+#include <Engine/Texture2D.h>
+#include <Engine/TextureRenderTarget2D.h>
+#include <Hash/CityHash.h>
+#include <Misc/Base64.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+#include <RenderingThread.h>
+
+#ifdef UE_INLINE_GENERATED_CPP_BY_NAME
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HttpGPTVisionEncoder)
+#endif
+
+/* Sources with an encoded image kept in memory */
+static constexpr int32 MaxCachedSources = 16;
+
+static constexpr int32 JPEGQuality = 85;
+
+FHttpGPTVisionEncoder& FHttpGPTVisionEncoder::Get()
+{
+	static FHttpGPTVisionEncoder Instance;
+	return Instance;
+}
+
+void FHttpGPTVisionEncoder::Encode(const FHttpGPTVisionSource& Source, const FHttpGPTVisionEncoded& Callback)
+{
+	check(IsInGameThread());
+
+	FHttpGPTImageDecoder::LoadModules();
+
+	if (UTextureRenderTarget2D* const RenderTarget = Cast<UTextureRenderTarget2D>(Source.Texture))
+	{
+		ReadRenderTarget(RenderTarget, RenderTarget->GetPathName(), Source, Callback);
+		return;
+	}
+
+	if (const UTexture2D* const Texture = Cast<UTexture2D>(Source.Texture))
+	{
+		FHttpGPTDecodedImage Image;
+		if (!FHttpGPTImageDecoder::ReadTexture(Texture, Image))
+		{
+			ExecuteCallback(Callback, FHttpGPTChatImage());
+			return;
+		}
+
+		Async(EAsyncExecution::ThreadPool, [this, SourceKey = Texture->GetPathName(), Image = MoveTemp(Image), Source, Callback]() mutable
+		{
+			EncodePixels(SourceKey, MoveTemp(Image), Source.Detail, Source.Encoding, Callback);
+		});
+
+		return;
+	}
+
+	if (HttpGPT::Internal::HasEmptyParam(Source.FilePath))
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Invalid vision source"), *FString(__FUNCTION__));
+		ExecuteCallback(Callback, FHttpGPTChatImage());
+		return;
+	}
+
+	Async(EAsyncExecution::ThreadPool, [this, Source, Callback]
+	{
+		TArray<uint8> FileData;
+		FHttpGPTDecodedImage Image;
+
+		if (!FFileHelper::LoadFileToArray(FileData, *Source.FilePath) || !FHttpGPTImageDecoder::Decode(FileData.GetData(), FileData.Num(), Image))
+		{
+			UE_LOG(LogHttpGPT, Error, TEXT("%s: Failed to load image %s"), *FString(__FUNCTION__), *Source.FilePath);
+			ExecuteCallback(Callback, FHttpGPTChatImage());
+			return;
+		}
+
+		EncodePixels(FPaths::ConvertRelativePathToFull(Source.FilePath), MoveTemp(Image), Source.Detail, Source.Encoding, Callback);
+	});
+}
+
+int32 FHttpGPTVisionEncoder::GetTargetSize(const int32 SizeX, const int32 SizeY, const EHttpGPTChatImageDetail Detail)
+{
+	const int32 LongSide = FMath::Max(SizeX, SizeY);
+	const int32 ShortSide = FMath::Max(FMath::Min(SizeX, SizeY), 1);
+
+	if (Detail == EHttpGPTChatImageDetail::Low)
+	{
+		return FMath::Min(LongSide, 512);
+	}
+
+	// High detail images are scaled to fit a 2048 square and then to a 768 shortest side
+	const float FitScale = FMath::Min(1.f, 2048.f / LongSide);
+	const float ShortSideScale = FMath::Min(1.f, 768.f / (ShortSide * FitScale));
+
+	return FMath::Max(FMath::RoundToInt(LongSide * FitScale * ShortSideScale), 1);
+}
+
+void FHttpGPTVisionEncoder::ClearCache()
+{
+	FScopeLock Lock(&Mutex);
+
+	Cache.Empty();
+	CacheOrder.Empty();
+}
+
+void FHttpGPTVisionEncoder::ReadRenderTarget(UTextureRenderTarget2D* const RenderTarget, const FString& SourceKey, const FHttpGPTVisionSource& Source,
+                                             const FHttpGPTVisionEncoded& Callback)
+{
+	FTextureRenderTargetResource* const Resource = RenderTarget->GameThread_GetRenderTargetResource();
+	if (!Resource)
+	{
+		UE_LOG(LogHttpGPT, Error, TEXT("%s: Render target %s has no resource"), *FString(__FUNCTION__), *SourceKey);
+		ExecuteCallback(Callback, FHttpGPTChatImage());
+		return;
+	}
+
+	const FIntRect Rect(0, 0, RenderTarget->SizeX, RenderTarget->SizeY);
+
+	// The pixels are read in the render thread, so the game thread doesn't wait for the GPU
+	ENQUEUE_RENDER_COMMAND(HttpGPTReadVisionSource)([this, Resource, Rect, SourceKey, Source, Callback](FRHICommandListImmediate& RHICmdList)
+	{
+		TArray<FColor> Pixels;
+		RHICmdList.ReadSurfaceData(Resource->GetRenderTargetTexture(), Rect, Pixels, FReadSurfaceDataFlags());
+
+		Async(EAsyncExecution::ThreadPool, [this, Pixels = MoveTemp(Pixels), Rect, SourceKey, Source, Callback]
+		{
+			// FColor is stored as BGRA8
+			FHttpGPTDecodedImage Image;
+			Image.SizeX = Rect.Width();
+			Image.SizeY = Rect.Height();
+			Image.RawData.Append(reinterpret_cast<const uint8*>(Pixels.GetData()), Pixels.Num() * sizeof(FColor));
+
+			EncodePixels(SourceKey, MoveTemp(Image), Source.Detail, Source.Encoding, Callback);
+		});
+	});
+}
+
+void FHttpGPTVisionEncoder::EncodePixels(const FString& SourceKey, FHttpGPTDecodedImage&& Image, const EHttpGPTChatImageDetail Detail,
+                                         const EHttpGPTVisionEncoding Encoding, const FHttpGPTVisionEncoded& Callback)
+{
+	if (!Image.IsValid())
+	{
+		ExecuteCallback(Callback, FHttpGPTChatImage());
+		return;
+	}
+
+	const uint64 PixelHash = CityHash64(reinterpret_cast<const char*>(Image.RawData.GetData()), static_cast<uint32>(Image.RawData.Num()));
+
+	// Repeated captures of an unchanged source reuse the previous encoding
+	{
+		FScopeLock Lock(&Mutex);
+
+		if (const FCacheEntry* const Entry = Cache.Find(SourceKey); Entry && Entry->PixelHash == PixelHash && Entry->Detail == Detail && Entry->Encoding == Encoding)
+		{
+			const FString CachedURL = Entry->URL;
+
+			CacheOrder.Remove(SourceKey);
+			CacheOrder.Insert(SourceKey, 0);
+
+			ExecuteCallback(Callback, FHttpGPTChatImage(CachedURL, Detail));
+			return;
+		}
+	}
+
+	FHttpGPTImageDecoder::Resize(Image, GetTargetSize(Image.SizeX, Image.SizeY, Detail));
+
+	TArray<uint8> EncodedImage;
+	const bool bEncoded = Encoding == EHttpGPTVisionEncoding::JPEG
+		                      ? FHttpGPTImageDecoder::EncodeJPEG(Image, JPEGQuality, EncodedImage)
+		                      : FHttpGPTImageDecoder::EncodePNG(Image, EncodedImage);
+
+	if (!bEncoded)
+	{
+		ExecuteCallback(Callback, FHttpGPTChatImage());
+		return;
+	}
+
+	const FString URL = FString::Format(TEXT("data:image/{0};base64,{1}"), {
+		                                    Encoding == EHttpGPTVisionEncoding::JPEG ? TEXT("jpeg") : TEXT("png"),
+		                                    FBase64::Encode(EncodedImage.GetData(), EncodedImage.Num())
+	                                    });
+
+	{
+		FScopeLock Lock(&Mutex);
+
+		FCacheEntry& Entry = Cache.FindOrAdd(SourceKey);
+		Entry.PixelHash = PixelHash;
+		Entry.Detail = Detail;
+		Entry.Encoding = Encoding;
+		Entry.URL = URL;
+
+		CacheOrder.Remove(SourceKey);
+		CacheOrder.Insert(SourceKey, 0);
+
+		while (CacheOrder.Num() > MaxCachedSources)
+		{
+			Cache.Remove(CacheOrder.Pop());
+		}
+	}
+
+	ExecuteCallback(Callback, FHttpGPTChatImage(URL, Detail));
+}
+
+void FHttpGPTVisionEncoder::ExecuteCallback(const FHttpGPTVisionEncoded& Callback, const FHttpGPTChatImage& Image)
+{
+	if (IsInGameThread())
+	{
+		Callback.ExecuteIfBound(Image);
+		return;
+	}
+
+	AsyncTask(ENamedThreads::GameThread, [Callback, Image]
+	{
+		Callback.ExecuteIfBound(Image);
+	});
+}
@@ -0,0 +1,80 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <HttpGPTInternalFuncs.h>
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ *
+ */
+class HTTPGPTIMAGEMODULE_API FHttpGPTCachedImageData
+{
+public:
+	FHttpGPTCachedImageData(TUniquePtr<IMappedFileHandle>&& InHandle, TUniquePtr<IMappedFileRegion>&& InRegion);
+	explicit FHttpGPTCachedImageData(TArray<uint8>&& InData);
+	~FHttpGPTCachedImageData();
+
+	const uint8* GetData() const;
+	int64 GetSize() const;
+
+private:
+	TUniquePtr<IMappedFileHandle> Handle;
+	TUniquePtr<IMappedFileRegion> Region;
+	TArray<uint8> Data;
+};
+
+DECLARE_DELEGATE_OneParam(FHttpGPTImageCached, const FString& /* Hash */);
+
+/**
+ *
+ */
+class HTTPGPTIMAGEMODULE_API FHttpGPTImageCache
+{
+public:
+	static FHttpGPTImageCache& Get();
+
+	static FString GetCacheDirectory();
+
+	/* Return the cached image hash if the URL was already downloaded */
+	bool FindURL(const FString& URL, FString& OutHash) const;
+	bool Contains(const FString& Hash) const;
+	FString GetImagePath(const FString& Hash) const;
+
+	/* Store the image content and return its hash */
+	FString Store(const uint8* const Data, const int64 Size, const FString& SourceURL = FString());
+
+	/* Move a downloaded file into the cache and return its hash */
+	FString StoreFile(const FString& FilePath, const FString& SourceURL = FString());
+
+	/* Map the cached image into memory. Return nullptr if the image is not cached */
+	TSharedPtr<FHttpGPTCachedImageData, ESPMode::ThreadSafe> Load(const FString& Hash) const;
+
+	/* Download the image into the cache if needed. The callback is executed in the game thread with an empty hash on failure */
+	void Download(const FString& URL, const FHttpGPTImageCached& Callback);
+
+	/* Write the index now if it has changes waiting to be written. Must be called in the game thread */
+	void FlushIndex();
+
+private:
+	FHttpGPTImageCache();
+
+	static FString GetIndexPath();
+	static FString GetIndexKey(const FString& URL);
+
+	void AddToIndex(const FString& URL, const FString& Hash);
+	void LoadIndex();
+
+	/* Downloaded URL without expiring signature parameters to content hash */
+	TMap<FString, FString, FDefaultSetAllocator, HttpGPT::Internal::TCaseSensitiveKeyFuncs<FString>> URLIndex;
+
+	/* Images are usually stored in batches: the index is written once, a moment after the last change */
+	bool bIndexSaveScheduled = false;
+
+	mutable FCriticalSection Mutex;
+};
@@ -0,0 +1,124 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <UObject/GCObject.h>
+#include <Containers/Ticker.h>
+#include <Structures/HttpGPTImageTypes.h>
+
+class UTexture2D;
+struct FTexturePlatformData;
+
+enum class EHttpGPTImageStage : uint8
+{
+	Queued,
+	Fetching,
+	Decoding,
+	Uploading,
+	Completed,
+	Failed
+};
+
+DECLARE_DELEGATE_TwoParams(FHttpGPTImageStageChanged, const int32 /* Index */, const EHttpGPTImageStage /* Stage */);
+DECLARE_DELEGATE_TwoParams(FHttpGPTImageReady, const int32 /* Index */, UTexture2D* /* Texture */);
+DECLARE_DELEGATE_OneParam(FHttpGPTImagePipelineCompleted, const TArray<UTexture2D*>& /* Textures */);
+
+/**
+ *
+ */
+class HTTPGPTIMAGEMODULE_API FHttpGPTImagePipeline final : public TSharedFromThis<FHttpGPTImagePipeline, ESPMode::ThreadSafe>, public FGCObject
+{
+public:
+	/* Fetch, decode and upload the images with the parallelism configured in the plugin settings */
+	static TSharedRef<FHttpGPTImagePipeline, ESPMode::ThreadSafe> Create(const TArray<FHttpGPTImageData>& Images);
+
+	/* Decode and upload images already stored in the image disk cache */
+	static TSharedRef<FHttpGPTImagePipeline, ESPMode::ThreadSafe> CreateFromCache(const TArray<FString>& Hashes);
+
+	explicit FHttpGPTImagePipeline(const TArray<FHttpGPTImageData>& Images);
+	virtual ~FHttpGPTImagePipeline() override;
+
+	/* Also store encoded images in the disk cache, so every image can be reloaded later by its hash */
+	bool bStoreEncodedImages = false;
+
+	/* Downscale the decoded images to fit this size. Zero keeps the original size */
+	int32 MaxImageSize = 0;
+
+	/* Build the full mip chain in the worker threads. Used for textures that are displayed at several sizes */
+	bool bGenerateMips = false;
+
+	/* Executed in the game thread every time an image moves to another stage */
+	FHttpGPTImageStageChanged OnStageChanged;
+
+	/* Executed in the game thread following the input order: an image is only delivered after all the previous ones. Failed images are delivered as nullptr */
+	FHttpGPTImageReady OnImageReady;
+
+	/* Executed in the game thread after the last image is delivered */
+	FHttpGPTImagePipelineCompleted OnCompleted;
+
+	void Start();
+	void Cancel();
+
+	bool IsRunning() const;
+	int32 Num() const;
+	EHttpGPTImageStage GetStage(const int32 Index) const;
+
+	/* Hash of the image in the disk cache. Empty if the image is not cached */
+	FString GetImageHash(const int32 Index) const;
+
+	/* Encoded image kept in memory when it should be stored in the disk cache but the store failed */
+	TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> GetEncodedImage(const int32 Index) const;
+
+	/* FGCObject */
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+
+private:
+	struct FImageEntry
+	{
+		FHttpGPTImageData Data;
+		EHttpGPTImageStage Stage = EHttpGPTImageStage::Queued;
+		FString CachedHash;
+		TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> EncodedImage;
+		FTexturePlatformData* PlatformData = nullptr;
+	};
+
+	void SetStage(const int32 Index, const EHttpGPTImageStage Stage);
+
+	void PumpFetch();
+	void PumpDecode();
+	bool TickUpload(const float DeltaTime);
+
+	void OnFetchCompleted(const int32 Index, const FString& Hash);
+	void OnDecodeCompleted(const int32 Index, FTexturePlatformData* const PlatformData, const FString& Hash,
+	                       const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& EncodedImage);
+
+	static FTexturePlatformData* DecodeImage(const FHttpGPTImageData& Data, FString& InOutHash, TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& OutEncodedImage,
+	                                         const bool bStoreEncoded, const int32 MaxSize, const bool bMips);
+
+	void Finish();
+
+	TArray<FImageEntry> Entries;
+	TArray<UTexture2D*> Textures;
+
+	TArray<int32> FetchQueue;
+	TArray<int32> DecodeQueue;
+
+	int32 ActiveFetches = 0;
+	int32 ActiveDecodes = 0;
+	int32 NextDelivery = 0;
+
+	bool bIsRunning = false;
+
+	/* Keep the pipeline alive while its stages are running */
+	TSharedPtr<FHttpGPTImagePipeline, ESPMode::ThreadSafe> SelfReference;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::FDelegateHandle TickerHandle;
+#else
+	FDelegateHandle TickerHandle;
+#endif
+};
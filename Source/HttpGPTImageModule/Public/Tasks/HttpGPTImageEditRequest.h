@@ -0,0 +1,44 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include "Tasks/HttpGPTImageUploadRequest.h"
+#include "HttpGPTImageEditRequest.generated.h"
+
+/**
+ *
+ */
+UCLASS(NotPlaceable, Category = "HttpGPT | Image", meta = (ExposedAsyncProxy = AsyncTask))
+class HTTPGPTIMAGEMODULE_API UHttpGPTImageEditRequest final : public UHttpGPTImageUploadRequest
+{
+	GENERATED_BODY()
+
+public:
+#if WITH_EDITOR
+	static UHttpGPTImageEditRequest* EditorTask(const FHttpGPTImageInput& Image, const FHttpGPTImageInput& Mask, const FString& Prompt,
+	                                            const FHttpGPTImageOptions Options);
+#endif
+
+	UFUNCTION(BlueprintCallable, Category = "HttpGPT | Image | Default",
+		meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Edit Image with Default Options"))
+	static UHttpGPTImageEditRequest* EditImage_DefaultOptions(UObject* const WorldContextObject, const FHttpGPTImageInput& Image,
+	                                                          const FHttpGPTImageInput& Mask, const FString& Prompt);
+
+	UFUNCTION(BlueprintCallable, Category = "HttpGPT | Image | Custom",
+		meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Edit Image with Custom Options"))
+	static UHttpGPTImageEditRequest* EditImage_CustomOptions(UObject* const WorldContextObject, const FHttpGPTImageInput& Image,
+	                                                         const FHttpGPTImageInput& Mask, const FString& Prompt,
+	                                                         const FHttpGPTCommonOptions CommonOptions, const FHttpGPTImageOptions ImageOptions);
+
+protected:
+	/* Transparent areas of the mask indicate where the image should be edited. Optional */
+	FHttpGPTDecodedImage MaskPixels;
+	FString MaskPath;
+
+	virtual FString GetEndpointURL() const override;
+	virtual FString SetRequestContent() override;
+	virtual bool AppendFormFields(FHttpGPTMultipartWriter& Writer) const override;
+};
@@ -14,6 +14,7 @@
 #include <Tasks/HttpGPTBaseTask.h>
 #include <Structures/HttpGPTCommonTypes.h>
 #include <Structures/HttpGPTImageTypes.h>
+#include <Utils/HttpGPTVisionEncoder.h>
 #include <Kismet/BlueprintFunctionLibrary.h>
 #include "HttpGPTImageRequest.generated.h"
 
@@ -65,18 +66,28 @@ protected:
 
 	virtual bool CanActivateTask() const override;
 	virtual bool CanBindProgress() const override;
+	virtual bool CanCacheResponse() const override;
 	virtual FString GetEndpointURL() const override;
 
 	virtual FString SetRequestContent() override;
 	virtual void OnProgressCompleted(const FString& Content, const bool bWasSuccessful) override;
+	virtual void OnResponseCompleted(const TArray<uint8>& Content, const bool bWasSuccessful) override;
 
-	void DeserializeResponse(const FString& Content);
+	/* Deserialize the response text, without the b64_json payloads when they were extracted from it */
+	void DeserializeResponse(const FString& Content, const TArray<FHttpGPTImageData>& EncodedImages);
+	void BroadcastResponse();
+
+	/* Copy the b64_json payloads directly from the response, returning the response text without them */
+	template <typename CharType>
+	FString ExtractEncodedImages(const CharType* const Content, const int32 Length, TArray<FHttpGPTImageData>& OutImages) const;
 
 private:
 	FHttpGPTImageResponse Response;
 };
 
 DECLARE_DYNAMIC_DELEGATE_OneParam(FHttpGPTImageGenerate, class UTexture2D*, Image);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FHttpGPTImagesGenerate, const TArray<class UTexture2D*>&, Images);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FHttpGPTChatImageEncoded, const FHttpGPTChatImage&, Image);
 
 UCLASS(NotPlaceable, Category = "HttpGPT | Image", Meta = (DisplayName = "HttpGPT Image Helper"))
 class HTTPGPTIMAGEMODULE_API UHttpGPTImageHelper final : public UBlueprintFunctionLibrary
@@ -87,10 +98,20 @@ public:
 	UFUNCTION(BlueprintPure, Category = "HttpGPT | Image", Meta = (DisplayName = "Cast to HttpGPT Image Request"))
 	static UHttpGPTImageRequest* CastToHttpGPTImageRequest(UObject* const Object);
 
+	/* URL or base64 content of the image. The b64_json images of image requests are only converted to text when this is called */
+	UFUNCTION(BlueprintPure, Category = "HttpGPT | Image")
+	static FString GetImageContent(const FHttpGPTImageData& ImageData);
+
 	UFUNCTION(BlueprintCallable, Category = "HttpGPT | Image")
 	static void GenerateImage(const FHttpGPTImageData& ImageData, const FHttpGPTImageGenerate& Callback);
 
-private:
-	static void GenerateImageFromURL(const FHttpGPTImageData& ImageData, const FHttpGPTImageGenerate& Callback);
-	static void GenerateImageFromB64(const FHttpGPTImageData& ImageData, const FHttpGPTImageGenerate& Callback);
+	/* Fetch and decode all images in worker threads through the image pipeline. Failed images are returned as nullptr, keeping the input order */
+	UFUNCTION(BlueprintCallable, Category = "HttpGPT | Image")
+	static void GenerateImages(const TArray<FHttpGPTImageData>& ImagesData, const FHttpGPTImagesGenerate& Callback);
+
+	static void GenerateImages(const TArray<FHttpGPTImageData>& ImagesData, TFunction<void(const TArray<class UTexture2D*>&)>&& Callback);
+
+	/* Downscale and encode the image in worker threads, to be added to a chat message. Failed images are returned with an empty URL */
+	UFUNCTION(BlueprintCallable, Category = "HttpGPT | Image")
+	static void EncodeChatImage(const FHttpGPTVisionSource& Source, const FHttpGPTChatImageEncoded& Callback);
 };
@@ -0,0 +1,69 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include "Tasks/HttpGPTImageRequest.h"
+#include "Utils/HttpGPTImageDecoder.h"
+#include "HttpGPTImageUploadRequest.generated.h"
+
+class FHttpGPTMultipartWriter;
+
+USTRUCT(BlueprintType, Category = "HttpGPT | Image", Meta = (DisplayName = "HttpGPT Image Input"))
+struct HTTPGPTIMAGEMODULE_API FHttpGPTImageInput
+{
+	GENERATED_BODY()
+
+	FHttpGPTImageInput() = default;
+
+	/* Texture with its pixels available in the CPU, like imported or generated textures. Used instead of the file path if set */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Image")
+	class UTexture2D* Texture = nullptr;
+
+	/* PNG files are streamed from the disk, other image formats are converted to PNG before the upload */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Image")
+	FString FilePath;
+
+	bool IsSet() const;
+};
+
+/**
+ *
+ */
+UCLASS(Abstract, NotPlaceable, Category = "HttpGPT | Image", meta = (ExposedAsyncProxy = AsyncTask))
+class HTTPGPTIMAGEMODULE_API UHttpGPTImageUploadRequest : public UHttpGPTImageRequest
+{
+	GENERATED_BODY()
+
+public:
+	virtual void SetReadyToDestroy() override;
+
+protected:
+	/* Copy the texture pixels in the game thread: the PNG encoding happens in the request worker thread. Return false if the pixels can't be read */
+	static bool ReadImageInput(const FHttpGPTImageInput& Input, FHttpGPTDecodedImage& OutPixels, FString& OutFilePath);
+
+	virtual bool CanActivateTask() const override;
+	bool CanUploadImage() const;
+
+	virtual bool CanDeduplicateRequest() const override;
+	virtual bool CanCacheResponse() const override;
+
+	/* Write the multipart/form-data body into a temporary file and stream it from the disk */
+	virtual FString SetRequestContent() override;
+
+	/* Return false if any field failed to be written */
+	virtual bool AppendFormFields(FHttpGPTMultipartWriter& Writer) const;
+
+	bool AppendImage(FHttpGPTMultipartWriter& Writer, const FString& Name, const FHttpGPTDecodedImage& Pixels, const FString& FilePath) const;
+
+	FHttpGPTDecodedImage ImagePixels;
+	FString ImagePath;
+
+	/* Set if any of the inputs failed to be read, so the task is not sent without them */
+	bool bHasInvalidInput = false;
+
+private:
+	FString UploadFilePath;
+};
@@ -0,0 +1,37 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include "Tasks/HttpGPTImageUploadRequest.h"
+#include "HttpGPTImageVariationRequest.generated.h"
+
+/**
+ *
+ */
+UCLASS(NotPlaceable, Category = "HttpGPT | Image", meta = (ExposedAsyncProxy = AsyncTask))
+class HTTPGPTIMAGEMODULE_API UHttpGPTImageVariationRequest final : public UHttpGPTImageUploadRequest
+{
+	GENERATED_BODY()
+
+public:
+#if WITH_EDITOR
+	static UHttpGPTImageVariationRequest* EditorTask(const FHttpGPTImageInput& Image, const FHttpGPTImageOptions Options);
+#endif
+
+	UFUNCTION(BlueprintCallable, Category = "HttpGPT | Image | Default",
+		meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Request Image Variations with Default Options"))
+	static UHttpGPTImageVariationRequest* RequestVariations_DefaultOptions(UObject* const WorldContextObject, const FHttpGPTImageInput& Image);
+
+	UFUNCTION(BlueprintCallable, Category = "HttpGPT | Image | Custom",
+		meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Request Image Variations with Custom Options"))
+	static UHttpGPTImageVariationRequest* RequestVariations_CustomOptions(UObject* const WorldContextObject, const FHttpGPTImageInput& Image,
+	                                                                      const FHttpGPTCommonOptions CommonOptions,
+	                                                                      const FHttpGPTImageOptions ImageOptions);
+
+protected:
+	virtual bool CanActivateTask() const override;
+	virtual FString GetEndpointURL() const override;
+};
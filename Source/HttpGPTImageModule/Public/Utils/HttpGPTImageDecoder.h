@@ -0,0 +1,70 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+class UTexture2D;
+struct FTexturePlatformData;
+
+#if ENGINE_MAJOR_VERSION >= 5
+using FHttpGPTRawImageData = TArray64<uint8>;
+#else
+using FHttpGPTRawImageData = TArray<uint8>;
+#endif
+
+/**
+ *
+ */
+struct HTTPGPTIMAGEMODULE_API FHttpGPTDecodedImage
+{
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+
+	/* Uncompressed BGRA8 pixels */
+	FHttpGPTRawImageData RawData;
+
+	bool IsValid() const
+	{
+		return SizeX > 0 && SizeY > 0 && RawData.Num() > 0;
+	}
+};
+
+/**
+ *
+ */
+class HTTPGPTIMAGEMODULE_API FHttpGPTImageDecoder
+{
+public:
+	/* Must be called in the game thread before decoding images in worker threads */
+	static void LoadModules();
+
+	/* Decode a compressed image (PNG, JPEG, ...) into BGRA8 pixels. Thread safe */
+	static bool Decode(const uint8* const Data, const int64 Size, FHttpGPTDecodedImage& OutImage);
+
+	/* Encode BGRA8 pixels as PNG. Thread safe */
+	static bool EncodePNG(const FHttpGPTDecodedImage& Image, TArray<uint8>& OutData);
+
+	/* Encode BGRA8 pixels as JPEG, discarding the alpha channel. Thread safe */
+	static bool EncodeJPEG(const FHttpGPTDecodedImage& Image, const int32 Quality, TArray<uint8>& OutData);
+
+	/* Copy the top mip pixels as BGRA8, from the editor source data or from uncompressed BGRA8 platform data. Game thread only */
+	static bool ReadTexture(const UTexture2D* const Texture, FHttpGPTDecodedImage& OutImage);
+
+	/* Downscale the image with a box filter to fit the maximum size, keeping its aspect ratio. Thread safe */
+	static void Resize(FHttpGPTDecodedImage& Image, const int32 MaxSize);
+
+	/* Build the texture mip data from the decoded pixels, optionally with the full mip chain. Thread safe */
+	static FTexturePlatformData* CreatePlatformData(const FHttpGPTDecodedImage& Image, const bool bGenerateMips = false);
+
+	/* Create a transient texture owning the platform data. The render resource is initialized by the render thread. Game thread only */
+	static UTexture2D* CreateTexture(FTexturePlatformData* const PlatformData);
+
+private:
+	static bool Compress(const FHttpGPTDecodedImage& Image, const bool bJPEG, const int32 Quality, TArray<uint8>& OutData);
+
+	static FHttpGPTDecodedImage ResizeTo(const FHttpGPTDecodedImage& Image, const int32 TargetX, const int32 TargetY);
+	static void AddMip(FTexturePlatformData* const PlatformData, const FHttpGPTDecodedImage& Image);
+};
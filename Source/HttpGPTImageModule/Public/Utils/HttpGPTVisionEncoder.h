@@ -0,0 +1,86 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEHttpGPT
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Structures/HttpGPTChatTypes.h>
+#include "Utils/HttpGPTImageDecoder.h"
+#include "HttpGPTVisionEncoder.generated.h"
+
+UENUM(BlueprintType, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Vision Encoding"))
+enum class EHttpGPTVisionEncoding : uint8
+{
+	PNG,
+	JPEG
+};
+
+USTRUCT(BlueprintType, Category = "HttpGPT | Chat", Meta = (DisplayName = "HttpGPT Vision Source"))
+struct HTTPGPTIMAGEMODULE_API FHttpGPTVisionSource
+{
+	GENERATED_BODY()
+
+	FHttpGPTVisionSource() = default;
+
+	/* Render target or texture with uncompressed BGRA8 pixels. Used instead of the file path if set */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat")
+	class UTexture* Texture = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat")
+	FString FilePath;
+
+	/* Also defines the resolution the image is downscaled to before being encoded */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat")
+	EHttpGPTChatImageDetail Detail = EHttpGPTChatImageDetail::Auto;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "HttpGPT | Chat")
+	EHttpGPTVisionEncoding Encoding = EHttpGPTVisionEncoding::JPEG;
+};
+
+DECLARE_DELEGATE_OneParam(FHttpGPTVisionEncoded, const FHttpGPTChatImage& /* Image */);
+
+/**
+ *
+ */
+class HTTPGPTIMAGEMODULE_API FHttpGPTVisionEncoder
+{
+public:
+	static FHttpGPTVisionEncoder& Get();
+
+	/* Read the source pixels and encode them as a data URL in worker threads. The callback is executed in the game thread with an empty URL on failure */
+	void Encode(const FHttpGPTVisionSource& Source, const FHttpGPTVisionEncoded& Callback);
+
+	/* Largest side of the image sent to the model, following the resolution the model scales the images to */
+	static int32 GetTargetSize(const int32 SizeX, const int32 SizeY, const EHttpGPTChatImageDetail Detail);
+
+	void ClearCache();
+
+private:
+	FHttpGPTVisionEncoder() = default;
+
+	void ReadRenderTarget(class UTextureRenderTarget2D* const RenderTarget, const FString& SourceKey, const FHttpGPTVisionSource& Source,
+	                      const FHttpGPTVisionEncoded& Callback);
+
+	/* Executed in a worker thread */
+	void EncodePixels(const FString& SourceKey, FHttpGPTDecodedImage&& Image, const EHttpGPTChatImageDetail Detail, const EHttpGPTVisionEncoding Encoding,
+	                  const FHttpGPTVisionEncoded& Callback);
+
+	static void ExecuteCallback(const FHttpGPTVisionEncoded& Callback, const FHttpGPTChatImage& Image);
+
+	struct FCacheEntry
+	{
+		uint64 PixelHash = 0u;
+		EHttpGPTChatImageDetail Detail = EHttpGPTChatImageDetail::Auto;
+		EHttpGPTVisionEncoding Encoding = EHttpGPTVisionEncoding::JPEG;
+		FString URL;
+	};
+
+	/* Last encoded image of each source asset or file */
+	TMap<FString, FCacheEntry> Cache;
+
+	/* Head is the most recently used source */
+	TArray<FString> CacheOrder;
+
+	FCriticalSection Mutex;
+};